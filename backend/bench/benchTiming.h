@@ -0,0 +1,30 @@
+#ifndef BENCH_TIMING_H
+#define BENCH_TIMING_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace bench {
+
+// Runs call once and appends its wall time in microseconds to samples
+inline void timed(std::vector<double>& samples, const std::function<void()>& call) {
+    auto start = std::chrono::steady_clock::now();
+    call();
+    samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+}
+
+// Nearest-rank percentile, p in [0, 1]; 0 for no samples
+inline double percentile(std::vector<double> samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[std::min(samples.size() - 1, static_cast<std::size_t>(p * samples.size()))];
+}
+
+} // namespace bench
+
+#endif // BENCH_TIMING_H
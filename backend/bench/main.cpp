@@ -0,0 +1,533 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "benchTiming.h"
+#include "dataAccess/storage.h"
+#include "utils/dbConnection.h"
+#include "utils/envLoader.h"
+#include "utils/ioExecutor.h"
+#include "utils/passwordHasher.h"
+#ifdef BOOKBITE_MARIADB_NATIVE
+#include "dataAccess/native/nativeStores.h"
+#include "dataAccess/tokenData.h"
+#endif
+
+// Benchmarks for the storage, booking and auth paths, kept out of the server binary. Each runs
+// against the storage configured in .env and prints its own summary; see the README sections
+// that mention bookbite_bench.
+
+namespace {
+
+// Reads the whole reservations table three ways and prints rows/s for each: nanodbc one row per
+// fetch with by-name lookups (the old DAO path), one row per fetch by position, and the block
+// cursor of PooledConnection::fetch. Seed a large table first; see "Bulk Fetching" in the README.
+int benchmarkFetch() {
+    const std::string query = "SELECT id, user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, "
+                              "special_requests, phone_number, email, total_amount, payment_status, payment_method "
+                              "FROM reservations";
+    const char* names[] = {"id", "user_id", "table_id", "restaurant_id", "date", "start_time", "end_time", "guest_count",
+                           "status", "special_requests", "phone_number", "email", "total_amount", "payment_status",
+                           "payment_method"};
+    const short columnCount = 15;
+    auto report = [](const char* mode, long rows, std::size_t bytes, std::chrono::steady_clock::time_point start) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << mode << ": " << rows << " rows in " << seconds << " s (" << (seconds > 0 ? rows / seconds : 0)
+                  << " rows/s, " << bytes << " bytes)" << std::endl;
+    };
+
+    try {
+        DbConnection dbConnection{"FetchBenchmark"};
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare(query);
+
+        auto start = std::chrono::steady_clock::now();
+        long rows = 0;
+        std::size_t bytes = 0;
+        nanodbc::result byName = conn.execute(stmt);
+        while (byName.next()) {
+            for (const char* name : names) {
+                bytes += byName.get<nanodbc::string>(name, "").size();
+            }
+            ++rows;
+        }
+        report("row by row, by name", rows, bytes, start);
+
+        start = std::chrono::steady_clock::now();
+        rows = 0;
+        bytes = 0;
+        nanodbc::result byPosition = conn.execute(stmt);
+        while (byPosition.next()) {
+            for (short column = 0; column < columnCount; ++column) {
+                bytes += byPosition.get<nanodbc::string>(column, "").size();
+            }
+            ++rows;
+        }
+        report("row by row, by position", rows, bytes, start);
+
+        start = std::chrono::steady_clock::now();
+        bytes = 0;
+        rows = conn.fetch(stmt, [&](const RowsetRow& row) {
+            for (short column = 0; column < columnCount; ++column) {
+                bytes += row.get<nanodbc::string>(column, "").size();
+            }
+        });
+        std::string mode = "rowsets of " + std::to_string(ConnectionPoolConfig::fromEnvironment().fetchRowsetSize);
+        report(mode.c_str(), rows, bytes, start);
+        return 0;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in benchmarkFetch: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// YYYY-MM-DD of 2099-01-01 plus `day` days; the booking benchmarks put one slot on each such date
+std::string benchmarkDate(int day) {
+    std::tm date{};
+    date.tm_year = 2099 - 1900;
+    date.tm_mday = 1 + day;
+    date.tm_hour = 12;
+    std::mktime(&date); // normalises tm_mday into the right month and year
+    char text[11];
+    std::strftime(text, sizeof(text), "%Y-%m-%d", &date);
+    return text;
+}
+
+// Races `threads` callers for one slot per round through ReservationStore::addReservationIfAvailable
+// on the configured backend, for `rounds` slots on the first table (19:00-21:00 from 2099-01-01 on),
+// and prints attempts/s and bookings/s. Fails unless every slot ends up with exactly one
+// non-cancelled reservation. The reservations it creates are deleted again.
+int benchmarkBooking(int threads, int rounds) {
+    ReservationStore& reservations = Storage::instance().reservations();
+    std::vector<Table> tables = Storage::instance().tables().getAllTables();
+    std::vector<User> users = Storage::instance().users().getAllUsers();
+    if (tables.empty() || users.empty()) {
+        std::cerr << "booking needs at least one table and one user." << std::endl;
+        return 1;
+    }
+    const Table table = tables.front();
+    const int userId = users.front().getId();
+    const std::string tokenPrefix = "booking-bench-" + std::to_string(std::time(nullptr)) + "-";
+
+    std::mutex bookedMutex;
+    std::vector<int> bookedIds;
+    double racingSeconds = 0;
+    for (int round = 0; round < rounds; ++round) {
+        std::atomic<bool> go{false};
+        std::vector<std::thread> racers;
+        for (int racer = 0; racer < threads; ++racer) {
+            racers.emplace_back([&, round, racer] {
+                Reservation reservation;
+                reservation.setUserId(userId);
+                reservation.setTableId(table.getId());
+                reservation.setRestaurantId(table.getRestaurantId());
+                reservation.setDate(benchmarkDate(round));
+                reservation.setStartTime("19:00:00");
+                reservation.setEndTime("21:00:00");
+                reservation.setGuestCount(2);
+                reservation.setStatus("pending");
+                reservation.setPaymentStatus("pending");
+                reservation.setConfirmationToken(tokenPrefix + std::to_string(round) + "-" + std::to_string(racer));
+                while (!go.load()) {
+                    std::this_thread::yield();
+                }
+                if (auto booked = reservations.addReservationIfAvailable(reservation)) {
+                    std::lock_guard<std::mutex> lock(bookedMutex);
+                    bookedIds.push_back(booked->getId());
+                }
+            });
+        }
+        auto start = std::chrono::steady_clock::now();
+        go = true;
+        for (auto& racer : racers) {
+            racer.join();
+        }
+        racingSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Every non-cancelled row on the table's benchmark dates counts, not only the ones reported back
+    std::map<std::string, int> bookingsPerSlot;
+    for (const auto& reservation : reservations.getReservationsByTableId(table.getId())) {
+        if (reservation.getStatus() != "cancelled") {
+            ++bookingsPerSlot[reservation.getDate()];
+        }
+    }
+    int doubleBooked = 0;
+    int unbooked = 0;
+    for (int round = 0; round < rounds; ++round) {
+        int bookings = bookingsPerSlot[benchmarkDate(round)];
+        doubleBooked += bookings > 1 ? 1 : 0;
+        unbooked += bookings == 0 ? 1 : 0;
+    }
+    for (int id : bookedIds) {
+        reservations.deleteReservation(id);
+    }
+
+    long attempts = static_cast<long>(threads) * rounds;
+    std::cout << rounds << " slots, " << threads << " threads per slot, table " << table.getId() << ", "
+              << Storage::backendName(Storage::instance().backend()) << " backend" << std::endl;
+    std::cout << (racingSeconds > 0 ? attempts / racingSeconds : 0.0) << " attempts/s, "
+              << (racingSeconds > 0 ? bookedIds.size() / racingSeconds : 0.0) << " bookings/s; "
+              << bookedIds.size() << " bookings reported, " << doubleBooked << " double-booked slots, " << unbooked
+              << " unbooked slots" << std::endl;
+    return doubleBooked == 0 && unbooked == 0 && bookedIds.size() == static_cast<std::size_t>(rounds) ? 0 : 1;
+}
+
+// Times one booking `iterations` times each way against the configured backend and prints p50/p99:
+// the store calls ReservationService::createReservation used to make (getTableById,
+// isTableAvailable, addReservation, getReservationByConfirmationToken, getUserById,
+// getRestaurantById), and addReservationIfAvailable, which replaced them. The confirmation email is
+// left out of both. Books the first table on successive dates from 2099-01-01 and deletes the rows again.
+int benchmarkReservation(int iterations) {
+    ReservationStore& reservations = Storage::instance().reservations();
+    TableStore& tables = Storage::instance().tables();
+    UserStore& users = Storage::instance().users();
+    RestaurantStore& restaurants = Storage::instance().restaurants();
+    std::vector<Table> allTables = tables.getAllTables();
+    std::vector<User> allUsers = users.getAllUsers();
+    if (allTables.empty() || allUsers.empty()) {
+        std::cerr << "reservation needs at least one table and one user." << std::endl;
+        return 1;
+    }
+    const Table table = allTables.front();
+    const int userId = allUsers.front().getId();
+    const std::string tokenPrefix = "reservation-bench-" + std::to_string(std::time(nullptr)) + "-";
+
+    auto booking = [&](int day, const std::string& token) {
+        Reservation reservation;
+        reservation.setUserId(userId);
+        reservation.setTableId(table.getId());
+        reservation.setRestaurantId(table.getRestaurantId());
+        reservation.setDate(benchmarkDate(day));
+        reservation.setStartTime("19:00:00");
+        reservation.setEndTime("21:00:00");
+        reservation.setGuestCount(2);
+        reservation.setStatus("pending");
+        reservation.setPaymentStatus("pending");
+        reservation.setConfirmationToken(token);
+        return reservation;
+    };
+
+    std::vector<double> before, after;
+    std::vector<int> created;
+    for (int i = 0; i < iterations; ++i) {
+        std::string oldToken = tokenPrefix + "old-" + std::to_string(i);
+        Reservation oldBooking = booking(2 * i, oldToken);
+        bench::timed(before, [&] {
+            if (!tables.getTableById(table.getId()) ||
+                !reservations.isTableAvailable(table.getId(), oldBooking.getDate(), "19:00:00", "21:00:00") ||
+                !reservations.addReservation(oldBooking)) {
+                return;
+            }
+            if (auto stored = reservations.getReservationByConfirmationToken(oldToken)) {
+                created.push_back(stored->getId());
+                users.getUserById(userId);
+                restaurants.getRestaurantById(table.getRestaurantId());
+            }
+        });
+
+        Reservation newBooking = booking(2 * i + 1, tokenPrefix + "new-" + std::to_string(i));
+        bench::timed(after, [&] {
+            if (auto booked = reservations.addReservationIfAvailable(newBooking)) {
+                created.push_back(booked->getId());
+            }
+        });
+    }
+    for (int id : created) {
+        reservations.deleteReservation(id);
+    }
+    if (created.size() != static_cast<std::size_t>(2 * iterations)) {
+        std::cerr << "Only " << created.size() << " of " << 2 * iterations
+                  << " bookings succeeded; are the benchmark dates on table " << table.getId() << " free?" << std::endl;
+        return 1;
+    }
+
+    double beforeP50 = bench::percentile(before, 0.50), afterP50 = bench::percentile(after, 0.50);
+    double beforeP99 = bench::percentile(before, 0.99), afterP99 = bench::percentile(after, 0.99);
+    std::cout << iterations << " bookings each way, table " << table.getId() << ", "
+              << Storage::backendName(Storage::instance().backend()) << " backend" << std::endl;
+    std::cout << "before (6 store calls): p50 " << beforeP50 << " us, p99 " << beforeP99 << " us" << std::endl;
+    std::cout << "after (addReservationIfAvailable): p50 " << afterP50 << " us, p99 " << afterP99 << " us ("
+              << (afterP50 > 0 ? beforeP50 / afterP50 : 0.0) << "x / " << (afterP99 > 0 ? beforeP99 / afterP99 : 0.0)
+              << "x)" << std::endl;
+    return 0;
+}
+
+// Verifies one password `logins` times on IoExecutor::hashing(), keeping its queue full as
+// concurrent logins would, and prints logins/s with p50/p99 latency (queue wait included) for the
+// scrypt settings from PASSWORD_SCRYPT_* and, for comparison, a legacy SHA-256 hash. No database.
+int benchmarkHash(int logins) {
+    PasswordHasher hasher(PasswordHashConfig::fromEnvironment());
+    const std::string password = "Benchmark-Passw0rd!";
+    std::string scryptHash = hasher.hash(password);
+    if (scryptHash.empty()) {
+        std::cerr << "Password hashing failed; check PASSWORD_SCRYPT_*." << std::endl;
+        return 1;
+    }
+    // SHA-256 of the password above, in the format of the old users.password_hash values
+    const std::string legacyHash = "2234c9c42b1e6e76aef5d582a691232299b96bc0387d801b4649360102091dfd";
+
+    IoExecutor& executor = IoExecutor::hashing();
+    IoExecutorStats config = executor.getStats();
+    std::cout << logins << " logins, n=" << hasher.getConfig().n << " r=" << hasher.getConfig().r
+              << " p=" << hasher.getConfig().p << ", " << config.threads << " hashing threads, queue "
+              << config.queueCapacity << std::endl;
+
+    auto run = [&](const char* label, const std::string& stored) {
+        std::vector<double> latencies;
+        latencies.reserve(logins);
+        std::deque<std::future<double>> inFlight;
+        auto collect = [&] {
+            latencies.push_back(inFlight.front().get());
+            inFlight.pop_front();
+        };
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < logins; ++i) {
+            auto submitted = std::chrono::steady_clock::now();
+            while (true) {
+                try {
+                    inFlight.push_back(executor.submit([&hasher, &password, &stored, submitted] {
+                        hasher.verify(password, stored);
+                        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - submitted).count();
+                    }));
+                    break;
+                } catch (const IoExecutorRejected&) {
+                    collect();
+                }
+            }
+        }
+        while (!inFlight.empty()) {
+            collect();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << label << ": " << (seconds > 0 ? logins / seconds : 0.0) << " logins/s, p50 "
+                  << bench::percentile(latencies, 0.50) << " ms, p99 " << bench::percentile(latencies, 0.99)
+                  << " ms" << std::endl;
+    };
+    run("scrypt", scryptHash);
+    run("legacy sha256", legacyHash);
+    return 0;
+}
+
+// Times the store calls behind registration and login against the configured backend, in the
+// order the flows made them before and as they make them now, and prints p50/p99 for each. The
+// password KDF is left out: it is the same in both and would hide the difference. Creates
+// `iterations` users per flow (bench_<time>_...) and deletes them again, tokens included.
+int benchmarkAuth(int iterations) {
+    UserStore& users = Storage::instance().users();
+    TokenStore& tokens = Storage::instance().tokens();
+    const std::string prefix = "bench_" + std::to_string(std::time(nullptr)) + "_";
+    const std::chrono::hours tokenLifetime(1);
+
+    auto newUser = [&](const std::string& name) {
+        User user;
+        user.setUsername(name);
+        user.setEmail(name + "@bench.invalid");
+        user.setPasswordHash("benchmark-hash");
+        user.setEmailVerified(true);
+        return user;
+    };
+    auto report = [&](const char* flow, const std::vector<double>& before, const std::vector<double>& after) {
+        double beforeP50 = bench::percentile(before, 0.50), afterP50 = bench::percentile(after, 0.50);
+        double beforeP99 = bench::percentile(before, 0.99), afterP99 = bench::percentile(after, 0.99);
+        std::cout << flow << ": before p50 " << beforeP50 << " us, p99 " << beforeP99 << " us; after p50 "
+                  << afterP50 << " us, p99 " << afterP99 << " us ("
+                  << (afterP50 > 0 ? beforeP50 / afterP50 : 0.0) << "x / " << (afterP99 > 0 ? beforeP99 / afterP99 : 0.0)
+                  << "x)" << std::endl;
+    };
+
+    std::vector<double> registerBefore, registerAfter, loginBefore, loginAfter;
+    std::vector<std::string> created;
+    for (int i = 0; i < iterations; ++i) {
+        std::string oldName = prefix + "old" + std::to_string(i);
+        std::string newName = prefix + "new" + std::to_string(i);
+        // Before: both uniqueness pre-checks, the insert, then the route re-reading the verification token
+        bench::timed(registerBefore, [&] {
+            if (!users.getUserByUsername(oldName) && !users.getUserByEmail(oldName + "@bench.invalid") &&
+                users.addUser(newUser(oldName))) {
+                users.getUserByEmail(oldName + "@bench.invalid");
+            }
+        });
+        // After: the insert alone
+        bench::timed(registerAfter, [&] { users.addUser(newUser(newName)); });
+        created.push_back(oldName);
+        created.push_back(newName);
+
+        // Before: validateUser's lookup, loginUser's own lookup, the token insert, then the route
+        // resolving the token and loading the user again
+        bench::timed(loginBefore, [&] {
+            users.getUserByUsername(oldName);
+            auto user = users.getUserByUsername(oldName);
+            std::string token = prefix + "old-token-" + std::to_string(i);
+            if (user && tokens.storeToken(token, user->getId(), tokenLifetime)) {
+                auto active = tokens.getActiveToken(token);
+                users.getUserById(active ? active->userId : user->getId());
+            }
+        });
+        // After: one lookup and the token insert
+        bench::timed(loginAfter, [&] {
+            auto user = users.getUserByUsername(newName);
+            if (user) {
+                tokens.storeToken(prefix + "new-token-" + std::to_string(i), user->getId(), tokenLifetime);
+            }
+        });
+    }
+
+    for (const auto& name : created) {
+        if (auto user = users.getUserByUsername(name)) {
+            users.deleteUser(user->getId()); // user_tokens rows go with ON DELETE CASCADE
+        }
+    }
+    if (registerAfter.empty()) {
+        return 1;
+    }
+    std::cout << iterations << " iterations per flow, " << Storage::backendName(Storage::instance().backend())
+              << " backend" << std::endl;
+    report("register", registerBefore, registerAfter);
+    report("login", loginBefore, loginAfter);
+    return 0;
+}
+
+#ifdef BOOKBITE_MARIADB_NATIVE
+// Times the per-request booking and auth queries through the ODBC DAOs and through the
+// Connector/C stores, against the configured database, and prints microseconds per call for each.
+// Uses the first table and user in the database; the token lookup is a miss on purpose.
+int benchmarkNative(int iterations) {
+    int tableId = 0;
+    int restaurantId = 0;
+    int userId = 0;
+    std::string username;
+    try {
+        DbConnection dbConnection{"NativeBenchmark"};
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::result table = nanodbc::execute(conn.get(), "SELECT id, restaurant_id FROM tables ORDER BY id LIMIT 1");
+        if (table.next()) {
+            tableId = table.get<int>(0);
+            restaurantId = table.get<int>(1);
+        }
+        nanodbc::result user = nanodbc::execute(conn.get(), "SELECT id, username FROM users ORDER BY id LIMIT 1");
+        if (user.next()) {
+            userId = user.get<int>(0);
+            username = user.get<nanodbc::string>(1, "");
+        }
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in benchmarkNative: " << e.what() << std::endl;
+        return 1;
+    }
+    if (tableId == 0 || userId == 0) {
+        std::cerr << "native needs at least one table and one user in the database." << std::endl;
+        return 1;
+    }
+
+    ReservationData odbcReservations;
+    UserData odbcUsers;
+    TokenData odbcTokens;
+    NativeReservationStore nativeReservations;
+    NativeUserStore nativeUsers;
+    NativeTokenStore nativeTokens;
+    const std::string date = "2030-01-01";
+    const std::string startTime = "19:00:00";
+    const std::string endTime = "21:00:00";
+    const std::string token = "native-benchmark-missing-token";
+
+    // The first call of each prepares its statement on the borrowed connection and is not timed
+    auto timeCalls = [iterations](const std::function<void()>& call) {
+        call();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            call();
+        }
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+    };
+    auto compare = [&](const char* query, const std::function<void()>& odbc, const std::function<void()>& native) {
+        double odbcUs = timeCalls(odbc);
+        double nativeUs = timeCalls(native);
+        std::cout << query << ": odbc " << odbcUs << " us/call, native " << nativeUs << " us/call ("
+                  << (nativeUs > 0 ? odbcUs / nativeUs : 0.0) << "x)" << std::endl;
+    };
+
+    std::cout << iterations << " calls each, table " << tableId << ", restaurant " << restaurantId << ", user " << userId
+              << std::endl;
+    compare("isTableAvailable",
+            [&] { odbcReservations.isTableAvailable(tableId, date, startTime, endTime); },
+            [&] { nativeReservations.isTableAvailable(tableId, date, startTime, endTime); });
+    compare("getAvailableTableIds",
+            [&] { odbcReservations.getAvailableTableIds(restaurantId, date, startTime, endTime); },
+            [&] { nativeReservations.getAvailableTableIds(restaurantId, date, startTime, endTime); });
+    compare("getReservationsByUserId",
+            [&] { odbcReservations.getReservationsByUserId(userId); },
+            [&] { nativeReservations.getReservationsByUserId(userId); });
+    compare("getUserById",
+            [&] { odbcUsers.getUserById(userId); },
+            [&] { nativeUsers.getUserById(userId); });
+    compare("getUserByUsername",
+            [&] { odbcUsers.getUserByUsername(username); },
+            [&] { nativeUsers.getUserByUsername(username); });
+    compare("getUserIdForToken",
+            [&] { odbcTokens.getUserIdForToken(token); },
+            [&] { nativeTokens.getUserIdForToken(token); });
+    return 0;
+}
+#endif
+
+int usage() {
+    std::cerr << "Usage: bookbite_bench <benchmark> [args]\n"
+              << "  booking [threads] [rounds]   racing bookings for one slot (default 16 50)\n"
+              << "  reservation [iterations]     booking store calls before/after (default 500)\n"
+              << "  auth [iterations]            register/login store calls before/after (default 500)\n"
+              << "  hash [logins]                password verification on the hashing executor (default 200)\n"
+              << "  fetch                        reservations read row by row and in rowsets\n"
+              << "  native [iterations]          ODBC against Connector/C per query (default 2000)" << std::endl;
+    return 2;
+}
+
+// argv[index] as a positive count, or fallback when absent
+int countArgument(int argc, char* argv[], int index, int fallback) {
+    return argc > index ? std::max(1, std::atoi(argv[index])) : fallback;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    EnvLoader::loadFromFile(".env");
+
+    std::string benchmark = argc > 1 ? argv[1] : "";
+    if (benchmark == "booking") {
+        return benchmarkBooking(countArgument(argc, argv, 2, 16), countArgument(argc, argv, 3, 50));
+    }
+    if (benchmark == "reservation") {
+        return benchmarkReservation(countArgument(argc, argv, 2, 500));
+    }
+    if (benchmark == "auth") {
+        return benchmarkAuth(countArgument(argc, argv, 2, 500));
+    }
+    if (benchmark == "hash") {
+        return benchmarkHash(countArgument(argc, argv, 2, 200));
+    }
+    if (benchmark == "fetch" || benchmark == "native") {
+        if (!Storage::usesDatabase(Storage::instance().backend())) {
+            std::cerr << benchmark << " needs a MariaDB STORAGE_BACKEND." << std::endl;
+            return 1;
+        }
+        if (benchmark == "fetch") {
+            return benchmarkFetch();
+        }
+#ifdef BOOKBITE_MARIADB_NATIVE
+        return benchmarkNative(countArgument(argc, argv, 2, 2000));
+#else
+        std::cerr << "native needs a build with -DBOOKBITE_MARIADB_NATIVE=ON." << std::endl;
+        return 1;
+#endif
+    }
+    return usage();
+}
@@ -1,20 +1,57 @@
 #ifndef AUTH_SERVICE_H
 #define AUTH_SERVICE_H
 
-#include "dataAccess/userData.h"
-#include "utils/dbConnection.h"
-#include <nanodbc/nanodbc.h>
+#include "dataAccess/storage.h"
+#include "models/authSession.h"
+#include "utils/passwordHasher.h"
+#include "utils/tokenCache.h"
+#include "utils/tokenSigner.h"
+#include <optional>
 #include <string>
 
+enum class LoginStatus {
+    Success,
+    InvalidCredentials, // unknown user, wrong password or deactivated account
+    EmailNotVerified,
+    Failed              // the token could not be issued
+};
+
+struct LoginResult {
+    LoginStatus status = LoginStatus::InvalidCredentials;
+    std::string token;
+    std::optional<User> user; // the account as read for the login, role included; set on Success
+};
+
+struct SignedTokenStats {
+    bool enabled = false;
+    std::string activeKeyId;
+    std::size_t revocations = 0; // revoked token ids plus per-user cut-offs currently held
+};
+
 class AuthService {
 public:
     AuthService();
-    bool registerUser(const std::string& username, const std::string& email, const std::string& password, 
-                     const std::string& firstName = "", const std::string& lastName = "");
-    std::string loginUser(const std::string& username, const std::string& password);
+    // One INSERT; the username and email unique keys reject duplicates. Returns the new account's
+    // email verification token, or nullopt if the password is weak or the username or email is taken.
+    std::optional<std::string> registerUser(const std::string& username, const std::string& email, const std::string& password, 
+                                            const std::string& firstName = "", const std::string& lastName = "");
+    // One user read, plus one token insert unless AUTH_TOKEN_FORMAT=signed (see tokenSigner.h). The
+    // new session is cached, so the next request needs no lookup either. Legacy SHA-256 password
+    // hashes are replaced with scrypt ones here.
+    // registerUser and loginUser run a deliberately slow KDF: call them from IoExecutor::hashing().
+    LoginResult loginUser(const std::string& username, const std::string& password);
+    // Session for a login token. Signed tokens are verified in process, with no database access;
+    // opaque ones come from the session cache or, on a miss, one token and one user lookup.
+    // nullopt for unknown, revoked or expired tokens and for deactivated users.
+    std::optional<AuthSession> authenticate(const std::string& token);
     bool validateToken(const std::string& token);
     int getUserIdFromToken(const std::string& token);
     void logoutUser(const std::string& token);
+    // Call after a user's role or status changes, or the user is deleted, so cached sessions
+    // pick up the change on the next request
+    void invalidateUser(int userId);
+    TokenCacheStats getSessionCacheStats() const;
+    SignedTokenStats getSignedTokenStats() const;
     
     bool verifyEmailToken(const std::string& token);
     std::string generateEmailVerificationToken();
@@ -23,17 +60,15 @@ public:
     std::string getPasswordRequirements();
 
 private:
-    UserData userData;
-    DbConnection dbConnection;
+    UserStore& userData;
+    TokenStore& tokenData;
+    TokenCache sessionCache;
+    TokenSigner tokenSigner;
+    TokenRevocations revokedTokens;
+    PasswordHasher passwordHasher;
 
     std::string generateToken(int userId);
-    std::string hashPassword(const std::string& password);
-    
-    bool storeTokenInDatabase(const std::string& token, int userId);
-    bool validateTokenInDatabase(const std::string& token);
-    int getUserIdFromTokenInDatabase(const std::string& token);
-    void removeTokenFromDatabase(const std::string& token);
-    void cleanupExpiredTokens();
+    std::string generateSignedToken(const User& user);
 };
 
 #endif // AUTH_SERVICE_H
@@ -0,0 +1,45 @@
+#ifndef EXPORT_SERVICE_H
+#define EXPORT_SERVICE_H
+
+#include "dataAccess/storage.h"
+#include "utils/exportWriter.h"
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <ostream>
+#include <string>
+
+struct ExportFile {
+    std::string path;        // spool file to send as the response body
+    std::string fileName;    // suggested download name
+    std::string contentType;
+    std::size_t rows = 0;
+};
+
+// Full-table admin exports. Rows are read in keyset batches and written straight to a spool file
+// (EXPORT_DIR), which Crow then sends from disk, so memory use does not grow with the table.
+// Spool files older than EXPORT_RETENTION_MINUTES are removed before each new export.
+class ExportService {
+public:
+    ExportService();
+
+    // "reservations", "users", "reviews" or "audit-log"
+    static bool isKnownDataset(const std::string& dataset);
+
+    // nullopt if the dataset is unknown or the database or spool file fails part-way
+    std::optional<ExportFile> exportDataset(const std::string& dataset, ExportFormat format);
+
+private:
+    ReservationStore& reservationData;
+    UserStore& userData;
+    ReviewStore& reviewData;
+    std::filesystem::path spoolDirectory;
+    int batchSize;
+    std::chrono::minutes retention;
+
+    bool writeDataset(const std::string& dataset, ExportFormat format, std::ostream& out, std::size_t& rows);
+    void removeStaleFiles();
+};
+
+#endif // EXPORT_SERVICE_H
@@ -0,0 +1,42 @@
+#ifndef MAINTENANCE_SERVICE_H
+#define MAINTENANCE_SERVICE_H
+
+#include "dataAccess/storage.h"
+#include "utils/maintenanceScheduler.h"
+#include <chrono>
+
+struct MaintenanceJobConfig {
+    std::chrono::seconds tokenInterval{300};
+    std::chrono::seconds reservationInterval{60};
+    std::chrono::seconds verificationInterval{3600};
+    std::chrono::seconds poolInterval{60};
+    // Matches the 24 hours the confirmation email promises
+    std::chrono::minutes pendingReservationHold{24 * 60};
+
+    // MAINTENANCE_TOKEN_INTERVAL_SECONDS, MAINTENANCE_RESERVATION_INTERVAL_SECONDS,
+    // MAINTENANCE_VERIFICATION_INTERVAL_SECONDS, MAINTENANCE_POOL_INTERVAL_SECONDS (0 turns a job
+    // off), PENDING_RESERVATION_HOLD_MINUTES
+    static MaintenanceJobConfig fromEnvironment();
+};
+
+// The periodic cleanup jobs: expired login tokens, unpaid pending reservations whose confirmation
+// link was never used (they hold their table until cancelled), expired email verification tokens
+// and, on the MariaDB backends, idle pooled connections
+class MaintenanceService {
+public:
+    MaintenanceService();
+    void registerJobs(MaintenanceScheduler& scheduler);
+
+    int deleteExpiredTokens(int limit);
+    int expirePendingReservations(int limit);
+    int clearExpiredVerificationTokens(int limit);
+    int evictIdleConnections();
+
+private:
+    MaintenanceJobConfig config;
+    TokenStore& tokenData;
+    ReservationStore& reservationData;
+    UserStore& userData;
+};
+
+#endif // MAINTENANCE_SERVICE_H
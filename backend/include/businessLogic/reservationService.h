@@ -1,35 +1,43 @@
 #ifndef RESERVATION_SERVICE_H
 #define RESERVATION_SERVICE_H
 
-#include "dataAccess/reservationData.h"
-#include "dataAccess/tableData.h"
-#include "dataAccess/userData.h"
-#include "dataAccess/restaurantData.h"
+#include "dataAccess/storage.h"
 #include "utils/emailService.h"
 #include <vector>
 #include <optional>
 #include <string>
+#include <unordered_map>
 
 class ReservationService {
 public:
     ReservationService();
     std::vector<Reservation> getAllReservations();
+    Page<Reservation> getAllReservations(const PageRequest& pageRequest);
     std::vector<Reservation> getReservationsByUserId(int userId);
     std::vector<Reservation> getReservationsByRestaurantId(int restaurantId);
     std::optional<Reservation> getReservationById(int id);
 
-    bool createReservation(const Reservation& reservation);
+    // Users / restaurants referenced by reservations, loaded in batches and keyed by id
+    std::unordered_map<int, User> getUsersForReservations(const std::vector<Reservation>& reservations);
+    std::unordered_map<int, Restaurant> getRestaurantsForReservations(const std::vector<Reservation>& reservations);
+
+    // Returns the new reservation id, or nullopt if the table is unknown or the slot is taken
+    std::optional<int> createReservation(const Reservation& reservation);
     bool updateReservation(const Reservation& reservation);
     bool cancelReservation(int id);
     bool completeReservation(int id);
+    // Bulk status change for admins; -1 if the status is not one of pending, confirmed,
+    // cancelled or completed, or if the update fails
+    int updateReservationStatuses(const std::vector<int>& ids, const std::string& status);
+    static bool isValidStatus(const std::string& status);
     bool confirmReservation(const std::string& token);
     bool resendConfirmationEmail(int reservationId);
 
 private:
-    ReservationData reservationData;
-    TableData tableData;
-    UserData userData;
-    RestaurantData restaurantData;
+    ReservationStore& reservationData;
+    TableStore& tableData;
+    UserStore& userData;
+    RestaurantStore& restaurantData;
     EmailService emailService;
 
     void updateTableAvailability(int tableId, bool isAvailable);
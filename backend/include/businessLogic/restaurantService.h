@@ -1,8 +1,7 @@
 #ifndef RESTAURANT_SERVICE_H
 #define RESTAURANT_SERVICE_H
 
-#include "dataAccess/restaurantData.h"
-#include "dataAccess/tableData.h"
+#include "dataAccess/storage.h"
 #include <vector>
 #include <optional>
 
@@ -11,6 +10,8 @@ public:
     RestaurantService();
     std::vector<Restaurant> getAllRestaurants();
     std::optional<Restaurant> getRestaurantById(int id);
+    // Restaurant page data in one load; reviewPage selects the page of reviews included
+    std::optional<RestaurantDetails> getRestaurantDetails(int id, const PageRequest& reviewPage);
     bool addRestaurant(const Restaurant& restaurant);
     bool updateRestaurant(const Restaurant& restaurant);
     bool deleteRestaurant(int id);
@@ -20,12 +21,13 @@ public:
     std::vector<Table> getTablesWithReservationsByRestaurantId(int restaurantId);
     std::optional<Table> getTableById(int id);
     bool addTable(const Table& table);
+    int addTables(int restaurantId, const std::vector<Table>& tables);
     bool updateTable(const Table& table);
     bool deleteTable(int id);
 
 private:
-    RestaurantData restaurantData;
-    TableData tableData;
+    RestaurantStore& restaurantData;
+    TableStore& tableData;
 };
 
 #endif // RESTAURANT_SERVICE_H
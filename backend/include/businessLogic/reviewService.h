@@ -1,7 +1,7 @@
 #ifndef REVIEW_SERVICE_H
 #define REVIEW_SERVICE_H
 
-#include "dataAccess/reviewData.h"
+#include "dataAccess/storage.h"
 #include <vector>
 #include <optional>
 
@@ -11,6 +11,7 @@ public:
     std::vector<Review> getAllReviews();
     std::vector<Review> getReviewsByUserId(int userId);
     std::vector<Review> getReviewsByRestaurantId(int restaurantId);
+    Page<Review> getReviewsByRestaurantId(int restaurantId, const PageRequest& pageRequest);
     std::optional<Review> getReviewById(int id);
     std::optional<Review> getUserReviewForRestaurant(int userId, int restaurantId);
     bool addReview(const Review& review);
@@ -20,7 +21,7 @@ public:
     int getReviewCountForRestaurant(int restaurantId);
 
 private:
-    ReviewData reviewData;
+    ReviewStore& reviewData;
 };
 
 #endif // REVIEW_SERVICE_H
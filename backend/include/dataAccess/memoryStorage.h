@@ -0,0 +1,195 @@
+#ifndef MEMORY_STORAGE_H
+#define MEMORY_STORAGE_H
+
+#include "dataAccess/storage.h"
+#include <memory>
+
+// Shared state of the in-memory backend; defined in memoryStorage.cpp
+class MemoryDatabase;
+
+// In-memory stores. They mirror the MariaDB DAOs result for result, including the foreign-key
+// checks and ON DELETE CASCADE rules of bookbite.sql, and updates of a missing id reporting success
+// just as an UPDATE that matches no row does.
+
+class MemoryReservationStore : public ReservationStore {
+public:
+    explicit MemoryReservationStore(MemoryDatabase& db);
+    std::vector<Reservation> getAllReservations() override;
+    Page<Reservation> getAllReservations(const PageRequest& pageRequest) override;
+    bool forEachReservation(const std::function<void(const Reservation&)>& visit, int batchSize = 1000) override;
+    std::vector<Reservation> getReservationsByUserId(int userId) override;
+    std::vector<Reservation> getReservationsByRestaurantId(int restaurantId) override;
+    std::vector<Reservation> getReservationsByTableId(int tableId) override;
+    std::optional<Reservation> getReservationById(int id) override;
+    std::optional<Reservation> getReservationByIdWithDetails(int id) override;
+    bool addReservation(const Reservation& reservation) override;
+    std::optional<Reservation> addReservationIfAvailable(const Reservation& reservation) override;
+    bool updateReservation(const Reservation& reservation) override;
+    bool deleteReservation(int id) override;
+    bool updateReservationStatus(int id, const std::string& status) override;
+    int updateReservationStatuses(const std::vector<int>& ids, const std::string& status) override;
+    bool isTableAvailable(int tableId, const std::string& date, const std::string& startTime, const std::string& endTime, int excludeReservationId = 0) override;
+    std::vector<int> getAvailableTableIds(int restaurantId, const std::string& date, const std::string& startTime, const std::string& endTime, int minCapacity = 0) override;
+    std::optional<Reservation> getReservationByConfirmationToken(const std::string& token) override;
+    bool updateReservationConfirmationToken(int id, const std::string& token) override;
+    bool confirmReservation(const std::string& token) override;
+    int expirePendingReservations(std::chrono::minutes holdFor, int limit) override;
+
+private:
+    MemoryDatabase& db;
+};
+
+class MemoryTableStore : public TableStore {
+public:
+    explicit MemoryTableStore(MemoryDatabase& db);
+    std::vector<Table> getAllTables() override;
+    std::vector<Table> getTablesByRestaurantId(int restaurantId) override;
+    std::vector<Table> getAvailableTablesByRestaurantId(int restaurantId) override;
+    std::vector<Table> getTablesWithReservationsByRestaurantId(int restaurantId) override;
+    std::optional<Table> getTableById(int id) override;
+    int addTable(const Table& table) override;
+    int addTables(int restaurantId, const std::vector<Table>& tables) override;
+    bool updateTable(const Table& table) override;
+    bool deleteTable(int id) override;
+    bool updateTableAvailability(int id, bool isAvailable) override;
+
+private:
+    MemoryDatabase& db;
+};
+
+class MemoryUserStore : public UserStore {
+public:
+    explicit MemoryUserStore(MemoryDatabase& db);
+    std::vector<User> getAllUsers() override;
+    Page<User> getAllUsers(const PageRequest& pageRequest) override;
+    bool forEachUser(const std::function<void(const User&)>& visit, int batchSize = 1000) override;
+    bool forEachAuditLogEntry(const std::function<void(const AuditLogEntry&)>& visit, int batchSize = 1000) override;
+    std::optional<User> getUserById(int id) override;
+    std::unordered_map<int, User> getUsersByIds(const std::vector<int>& ids) override;
+    std::optional<User> getUserByUsername(const std::string& username) override;
+    std::optional<User> getUserByEmail(const std::string& email) override;
+    bool addUser(const User& user) override;
+    bool updateUser(const User& user) override;
+    bool deleteUser(int id) override;
+    bool updatePasswordHash(int userId, const std::string& passwordHash) override;
+    bool verifyEmailToken(const std::string& token) override;
+    int clearExpiredVerificationTokens(int limit) override;
+
+    std::vector<UserRole> getAllRoles() override;
+    std::optional<UserRole> getRoleById(int id) override;
+    bool updateUserRole(int userId, int roleId) override;
+    bool updateUserStatus(int userId, bool isActive) override;
+    int updateUserStatuses(const std::vector<int>& userIds, bool isActive) override;
+
+    bool logAdminAction(int adminUserId, const std::string& action, const std::string& targetType = "",
+                        int targetId = 0, const std::string& details = "", const std::string& ipAddress = "") override;
+    bool logAdminActions(int adminUserId, const std::string& action, const std::string& targetType,
+                         const std::vector<int>& targetIds, const std::string& details = "", const std::string& ipAddress = "") override;
+
+private:
+    MemoryDatabase& db;
+};
+
+class MemoryRestaurantStore : public RestaurantStore {
+public:
+    explicit MemoryRestaurantStore(MemoryDatabase& db);
+    std::vector<Restaurant> getAllRestaurants() override;
+    Page<Restaurant> getAllRestaurants(const PageRequest& pageRequest) override;
+    std::optional<Restaurant> getRestaurantById(int id) override;
+    std::unordered_map<int, Restaurant> getRestaurantsByIds(const std::vector<int>& ids) override;
+    std::optional<RestaurantDetails> getRestaurantDetails(int id, const PageRequest& reviewPage) override;
+    int addRestaurant(const Restaurant& restaurant) override;
+    bool updateRestaurant(const Restaurant& restaurant) override;
+    bool deleteRestaurant(int id) override;
+
+private:
+    MemoryDatabase& db;
+};
+
+class MemoryReviewStore : public ReviewStore {
+public:
+    explicit MemoryReviewStore(MemoryDatabase& db);
+    std::vector<Review> getAllReviews() override;
+    bool forEachReview(const std::function<void(const Review&)>& visit, int batchSize = 1000) override;
+    std::vector<Review> getReviewsByUserId(int userId) override;
+    std::vector<Review> getReviewsByRestaurantId(int restaurantId) override;
+    Page<Review> getReviewsByRestaurantId(int restaurantId, const PageRequest& pageRequest) override;
+    std::optional<Review> getReviewById(int id) override;
+    std::optional<Review> getUserReviewForRestaurant(int userId, int restaurantId) override;
+    bool addReview(const Review& review) override;
+    bool updateReview(const Review& review) override;
+    bool deleteReview(int id) override;
+    float getAverageRatingForRestaurant(int restaurantId) override;
+    int getReviewCountForRestaurant(int restaurantId) override;
+
+private:
+    MemoryDatabase& db;
+};
+
+class MemoryPaymentStore : public PaymentStore {
+public:
+    explicit MemoryPaymentStore(MemoryDatabase& db);
+    std::vector<Payment> getAllPayments() override;
+    std::vector<Payment> getPaymentsByUserId(int userId) override;
+    std::vector<Payment> getPaymentsByReservationId(int reservationId) override;
+    std::optional<Payment> getPaymentById(int id) override;
+    bool addPayment(const Payment& payment) override;
+    bool updatePayment(const Payment& payment) override;
+    bool updatePaymentStatus(int id, const std::string& status) override;
+    bool deletePayment(int id) override;
+
+private:
+    MemoryDatabase& db;
+};
+
+class MemoryTokenStore : public TokenStore {
+public:
+    explicit MemoryTokenStore(MemoryDatabase& db);
+    bool storeToken(const std::string& token, int userId, std::chrono::seconds ttl) override;
+    bool isTokenActive(const std::string& token) override;
+    int getUserIdForToken(const std::string& token) override;
+    std::optional<ActiveToken> getActiveToken(const std::string& token) override;
+    void revokeToken(const std::string& token) override;
+    int deleteExpiredTokens(int limit) override;
+
+private:
+    MemoryDatabase& db;
+};
+
+// Everything lives in one MemoryDatabase: id-ordered maps per table, so pages and scans come out in
+// primary-key order like the SQL backend, plus hash and ordered indexes for every lookup the stores
+// make (username, email, tokens, restaurant -> tables, (table, date) -> reservations for slot
+// checks, ...). A single reader/writer lock guards it; reads share it, and each write, including
+// booking and cascading deletes, is atomic. The user and admin roles are always present.
+class MemoryStorage : public Storage {
+public:
+    MemoryStorage();
+    ~MemoryStorage() override;
+    MemoryStorage(const MemoryStorage&) = delete;
+    MemoryStorage& operator=(const MemoryStorage&) = delete;
+
+    // MEMORY_ADMIN_USERNAME, MEMORY_ADMIN_EMAIL, MEMORY_ADMIN_PASSWORD_HASH: when username and hash
+    // are set, a verified admin account is created so the admin API is usable without a database
+    static std::unique_ptr<MemoryStorage> fromEnvironment();
+
+    StorageBackend backend() const override { return StorageBackend::Memory; }
+    ReservationStore& reservations() override { return reservationStore; }
+    TableStore& tables() override { return tableStore; }
+    UserStore& users() override { return userStore; }
+    RestaurantStore& restaurants() override { return restaurantStore; }
+    ReviewStore& reviews() override { return reviewStore; }
+    PaymentStore& payments() override { return paymentStore; }
+    TokenStore& tokens() override { return tokenStore; }
+
+private:
+    std::unique_ptr<MemoryDatabase> db;
+    MemoryReservationStore reservationStore;
+    MemoryTableStore tableStore;
+    MemoryUserStore userStore;
+    MemoryRestaurantStore restaurantStore;
+    MemoryReviewStore reviewStore;
+    MemoryPaymentStore paymentStore;
+    MemoryTokenStore tokenStore;
+};
+
+#endif // MEMORY_STORAGE_H
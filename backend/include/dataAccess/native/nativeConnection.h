@@ -0,0 +1,199 @@
+#ifndef NATIVE_CONNECTION_H
+#define NATIVE_CONNECTION_H
+
+// Only compiled with -DBOOKBITE_MARIADB_NATIVE=ON (see CMakeLists.txt)
+
+#include "utils/connectionPool.h"
+#include <mysql.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct NativeConnectionConfig {
+    std::string host = "localhost";
+    unsigned int port = 3306;
+    std::string database = "bookbite";
+    std::string user = "root";
+    std::string password;
+    // Sizing, timeouts and the statement cache size are the ODBC pool's DB_POOL_* settings
+    ConnectionPoolConfig pool;
+
+    static NativeConnectionConfig fromEnvironment();
+};
+
+// Connector/C failure. A std::runtime_error like nanodbc's errors and ConnectionPoolError, so the
+// native stores handle errors with the same catch blocks as the DAOs they stand in for.
+class NativeDbError : public std::runtime_error {
+public:
+    NativeDbError(const std::string& message, unsigned int code);
+    // Client-side (CR_*) errors, e.g. a lost connection, after which the session is not reused
+    bool connectionLost() const;
+
+private:
+    unsigned int code;
+};
+
+// Statement parameters in placeholder order. Values are copied, so temporaries can be added.
+class NativeParams {
+public:
+    NativeParams& add(int value);
+    NativeParams& add(long long value);
+    NativeParams& add(double value);
+    NativeParams& add(const std::string& value);
+    NativeParams& addNull();
+    std::size_t size() const;
+
+private:
+    friend class NativeConnection;
+
+    struct Value {
+        enum_field_types type;
+        long long integer = 0;
+        double real = 0.0;
+        std::string text;
+        unsigned long length = 0;
+        my_bool isNull = 0;
+    };
+    std::vector<Value> values;
+};
+
+// Bound output buffers of one result column; defined in nativeConnection.cpp
+struct NativeColumn;
+
+// One row of a binary-protocol result, read by 0-based position with the RowsetRow conventions:
+// get<T>(column) throws nanodbc::null_access_error on NULL, get<T>(column, fallback) returns the
+// fallback instead. DATE, TIME and DATETIME values read as strings in MariaDB's text format.
+// Valid only inside the visit call.
+class NativeRow {
+public:
+    explicit NativeRow(const std::vector<NativeColumn>& columns);
+
+    short columns() const;
+    bool isNull(short column) const;
+
+    template <class T>
+    T get(short column) const;
+
+    template <class T>
+    T get(short column, const T& fallback) const {
+        return isNull(column) ? fallback : get<T>(column);
+    }
+
+private:
+    const std::vector<NativeColumn>* columnData;
+
+    const NativeColumn& at(short column) const;
+};
+
+template <> int NativeRow::get<int>(short column) const;
+template <> long long NativeRow::get<long long>(short column) const;
+template <> bool NativeRow::get<bool>(short column) const;
+template <> double NativeRow::get<double>(short column) const;
+template <> float NativeRow::get<float>(short column) const;
+template <> std::string NativeRow::get<std::string>(short column) const;
+
+// One Connector/C session and its server-side prepared statements, LRU by SQL text
+struct NativeSession {
+    struct Statement {
+        std::string sql;
+        std::string fingerprint;
+        MYSQL_STMT* handle;
+    };
+
+    MYSQL* mysql = nullptr;
+    std::list<Statement> statements; // most recently used at the front
+    std::unordered_map<std::string, std::list<Statement>::iterator> index;
+    std::chrono::steady_clock::time_point lastUsed;
+    std::chrono::steady_clock::time_point lastValidated;
+
+    NativeSession() = default;
+    NativeSession(const NativeSession&) = delete;
+    NativeSession& operator=(const NativeSession&) = delete;
+    ~NativeSession();
+};
+
+class NativeConnectionPool;
+
+// RAII handle for a borrowed session; returns it to the pool when destroyed. Statements are
+// prepared once per session (COM_STMT_PREPARE) and then executed with binary parameters and
+// results (COM_STMT_EXECUTE), so values are never formatted to or parsed from SQL text.
+class NativeConnection {
+public:
+    NativeConnection(NativeConnectionPool* pool, std::unique_ptr<NativeSession> session, std::string caller);
+    NativeConnection(NativeConnection&& other) noexcept;
+    NativeConnection& operator=(NativeConnection&& other) noexcept;
+    NativeConnection(const NativeConnection&) = delete;
+    NativeConnection& operator=(const NativeConnection&) = delete;
+    ~NativeConnection();
+
+    // Runs a SELECT and calls visit for every row; returns the number of rows. The whole result is
+    // buffered client-side first (mysql_stmt_store_result), so column buffers are sized exactly.
+    long query(const std::string& sql, const NativeParams& params, const std::function<void(const NativeRow&)>& visit);
+    // Runs a statement without a result set; returns the affected row count
+    long execute(const std::string& sql, const NativeParams& params);
+    // AUTO_INCREMENT id generated by the last execute() on this session
+    long long lastInsertId() const;
+
+private:
+    NativeConnectionPool* pool;
+    std::unique_ptr<NativeSession> session;
+    std::string caller;
+    bool broken;
+    long long insertId;
+
+    NativeSession::Statement& prepare(const std::string& sql);
+    MYSQL_STMT* run(NativeSession::Statement& statement, const NativeParams& params);
+    void fail(MYSQL_STMT* handle, const char* call);
+    void record(const NativeSession::Statement& statement, const NativeParams& params,
+                std::chrono::steady_clock::time_point start, double excludedMs, long rows, bool failed);
+    void release();
+};
+
+// Pool of Connector/C sessions, sized and timed like the ODBC ConnectionPool
+class NativeConnectionPool {
+public:
+    explicit NativeConnectionPool(const NativeConnectionConfig& config);
+    ~NativeConnectionPool();
+    NativeConnectionPool(const NativeConnectionPool&) = delete;
+    NativeConnectionPool& operator=(const NativeConnectionPool&) = delete;
+
+    static NativeConnectionPool& instance();
+
+    // caller labels the QueryStats entries, e.g. "NativeReservationStore::isTableAvailable"
+    NativeConnection acquire(const std::string& caller);
+    const NativeConnectionConfig& getConfig() const;
+
+private:
+    friend class NativeConnection;
+
+    NativeConnectionConfig config;
+    std::mutex mutex;
+    std::condition_variable available;
+    std::vector<std::unique_ptr<NativeSession>> idle; // most recently used at the back
+    std::size_t total;
+
+    std::unique_ptr<NativeSession> openSession();
+    bool validate(NativeSession& session);
+    void release(std::unique_ptr<NativeSession> session, bool broken);
+};
+
+// Per-store handle in the style of DbConnection
+class NativeDbConnection {
+public:
+    explicit NativeDbConnection(std::string owner);
+    // method defaults to the calling function's name, as in DbConnection::getConnection
+    NativeConnection getConnection(const char* method = __builtin_FUNCTION());
+
+private:
+    std::string owner;
+};
+
+#endif // NATIVE_CONNECTION_H
@@ -0,0 +1,55 @@
+#ifndef NATIVE_STORES_H
+#define NATIVE_STORES_H
+
+// Only compiled with -DBOOKBITE_MARIADB_NATIVE=ON (see CMakeLists.txt)
+
+#include "dataAccess/native/nativeConnection.h"
+#include "dataAccess/reservationData.h"
+#include "dataAccess/storage.h"
+#include "dataAccess/userData.h"
+
+// The STORAGE_BACKEND=mariadb-native stores. The per-request booking and auth queries run over
+// Connector/C server-side prepared statements; every other method is inherited from the ODBC DAO,
+// so both paths read and write the same schema and the store interfaces are unchanged.
+
+class NativeReservationStore : public ReservationData {
+public:
+    using ReservationData::ReservationData;
+
+    std::vector<Reservation> getReservationsByUserId(int userId) override;
+    std::optional<Reservation> getReservationById(int id) override;
+    std::optional<Reservation> addReservationIfAvailable(const Reservation& reservation) override;
+    bool isTableAvailable(int tableId, const std::string& date, const std::string& startTime, const std::string& endTime, int excludeReservationId = 0) override;
+    std::vector<int> getAvailableTableIds(int restaurantId, const std::string& date, const std::string& startTime, const std::string& endTime, int minCapacity = 0) override;
+
+private:
+    NativeDbConnection nativeConnection{"NativeReservationStore"};
+};
+
+// Login and the other UserData methods that look users up go through these overrides
+class NativeUserStore : public UserData {
+public:
+    using UserData::UserData;
+
+    std::optional<User> getUserById(int id) override;
+    std::optional<User> getUserByUsername(const std::string& username) override;
+    std::optional<User> getUserByEmail(const std::string& email) override;
+
+private:
+    NativeDbConnection nativeConnection{"NativeUserStore"};
+};
+
+class NativeTokenStore : public TokenStore {
+public:
+    bool storeToken(const std::string& token, int userId, std::chrono::seconds ttl) override;
+    bool isTokenActive(const std::string& token) override;
+    int getUserIdForToken(const std::string& token) override;
+    std::optional<ActiveToken> getActiveToken(const std::string& token) override;
+    void revokeToken(const std::string& token) override;
+    int deleteExpiredTokens(int limit) override;
+
+private:
+    NativeDbConnection nativeConnection{"NativeTokenStore"};
+};
+
+#endif // NATIVE_STORES_H
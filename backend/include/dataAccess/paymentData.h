@@ -2,21 +2,22 @@
 #define PAYMENT_DATA_H
 
 #include "models/payment.h"
+#include "dataAccess/storage.h"
 #include "utils/dbConnection.h"
 #include <vector>
 #include <optional>
 
-class PaymentData {
+class PaymentData : public PaymentStore {
 public:
-    PaymentData();
-    std::vector<Payment> getAllPayments();
-    std::vector<Payment> getPaymentsByUserId(int userId);
-    std::vector<Payment> getPaymentsByReservationId(int reservationId);
-    std::optional<Payment> getPaymentById(int id);
-    bool addPayment(const Payment& payment);
-    bool updatePayment(const Payment& payment);
-    bool updatePaymentStatus(int id, const std::string& status);
-    bool deletePayment(int id);
+    explicit PaymentData(DbContext& context = DbContext::instance());
+    std::vector<Payment> getAllPayments() override;
+    std::vector<Payment> getPaymentsByUserId(int userId) override;
+    std::vector<Payment> getPaymentsByReservationId(int reservationId) override;
+    std::optional<Payment> getPaymentById(int id) override;
+    bool addPayment(const Payment& payment) override;
+    bool updatePayment(const Payment& payment) override;
+    bool updatePaymentStatus(int id, const std::string& status) override;
+    bool deletePayment(int id) override;
 
 private:
     DbConnection dbConnection;
@@ -2,28 +2,44 @@
 #define RESERVATION_DATA_H
 
 #include "models/reservation.h"
+#include "models/page.h"
+#include "dataAccess/storage.h"
 #include "utils/dbConnection.h"
+#include <functional>
 #include <vector>
 #include <optional>
 
-class ReservationData {
+class ReservationData : public ReservationStore {
 public:
-    ReservationData();
-    std::vector<Reservation> getAllReservations();
-    std::vector<Reservation> getReservationsByUserId(int userId);
-    std::vector<Reservation> getReservationsByRestaurantId(int restaurantId);
-    std::vector<Reservation> getReservationsByTableId(int tableId);
-    std::optional<Reservation> getReservationById(int id);
-    std::optional<Reservation> getReservationByIdWithDetails(int id);
-    bool addReservation(const Reservation& reservation);
-    bool updateReservation(const Reservation& reservation);
-    bool deleteReservation(int id);
-    bool updateReservationStatus(int id, const std::string& status);
-    bool isTableAvailable(int tableId, const std::string& date, const std::string& startTime, const std::string& endTime, int excludeReservationId = 0);
-    std::vector<int> getAvailableTableIds(int restaurantId, const std::string& date, const std::string& startTime, const std::string& endTime, int minCapacity = 0);
-    std::optional<Reservation> getReservationByConfirmationToken(const std::string& token);
-    bool updateReservationConfirmationToken(int id, const std::string& token);
-    bool confirmReservation(const std::string& token);
+    explicit ReservationData(DbContext& context = DbContext::instance());
+    std::vector<Reservation> getAllReservations() override;
+    Page<Reservation> getAllReservations(const PageRequest& pageRequest) override;
+    // Calls visit for every reservation in id order, reading batchSize rows per round trip so the full
+    // table is never in memory. Returns false if the database fails part-way.
+    bool forEachReservation(const std::function<void(const Reservation&)>& visit, int batchSize = 1000) override;
+    std::vector<Reservation> getReservationsByUserId(int userId) override;
+    std::vector<Reservation> getReservationsByRestaurantId(int restaurantId) override;
+    std::vector<Reservation> getReservationsByTableId(int tableId) override;
+    std::optional<Reservation> getReservationById(int id) override;
+    std::optional<Reservation> getReservationByIdWithDetails(int id) override;
+    bool addReservation(const Reservation& reservation) override;
+    // Inserts only if the table exists and has no overlapping booking, checked atomically under the
+    // table row lock. Returns the stored reservation with its id, customer and restaurant names
+    // (email falls back to the user's), or nullopt if the slot is taken or the database fails.
+    // nullopt always means nothing was booked.
+    std::optional<Reservation> addReservationIfAvailable(const Reservation& reservation) override;
+    bool updateReservation(const Reservation& reservation) override;
+    bool deleteReservation(int id) override;
+    bool updateReservationStatus(int id, const std::string& status) override;
+    // Sets status on every id with one array-bound statement in a single transaction.
+    // Returns the number of rows changed, or -1 on failure (nothing is written).
+    int updateReservationStatuses(const std::vector<int>& ids, const std::string& status) override;
+    bool isTableAvailable(int tableId, const std::string& date, const std::string& startTime, const std::string& endTime, int excludeReservationId = 0) override;
+    std::vector<int> getAvailableTableIds(int restaurantId, const std::string& date, const std::string& startTime, const std::string& endTime, int minCapacity = 0) override;
+    std::optional<Reservation> getReservationByConfirmationToken(const std::string& token) override;
+    bool updateReservationConfirmationToken(int id, const std::string& token) override;
+    bool confirmReservation(const std::string& token) override;
+    int expirePendingReservations(std::chrono::minutes holdFor, int limit) override;
 
 private:
     DbConnection dbConnection;
@@ -2,18 +2,26 @@
 #define RESTAURANT_DATA_H
 
 #include "models/restaurant.h"
+#include "models/page.h"
+#include "dataAccess/storage.h"
 #include "utils/dbConnection.h"
 #include <vector>
 #include <optional>
+#include <unordered_map>
 
-class RestaurantData {
+class RestaurantData : public RestaurantStore {
 public:
-    RestaurantData();
-    std::vector<Restaurant> getAllRestaurants();
-    std::optional<Restaurant> getRestaurantById(int id);
-    int addRestaurant(const Restaurant& restaurant);
-    bool updateRestaurant(const Restaurant& restaurant);
-    bool deleteRestaurant(int id);
+    explicit RestaurantData(DbContext& context = DbContext::instance());
+    std::vector<Restaurant> getAllRestaurants() override;
+    Page<Restaurant> getAllRestaurants(const PageRequest& pageRequest) override;
+    std::optional<Restaurant> getRestaurantById(int id) override;
+    std::unordered_map<int, Restaurant> getRestaurantsByIds(const std::vector<int>& ids) override;
+    // Restaurant, tables, their reservations, the review page and rating stats as one five-statement
+    // batch: a single round trip on one connection instead of a borrow and round trip per query
+    std::optional<RestaurantDetails> getRestaurantDetails(int id, const PageRequest& reviewPage) override;
+    int addRestaurant(const Restaurant& restaurant) override;
+    bool updateRestaurant(const Restaurant& restaurant) override;
+    bool deleteRestaurant(int id) override;
 
 private:
     DbConnection dbConnection;
@@ -2,27 +2,39 @@
 #define REVIEW_DATA_H
 
 #include "models/review.h"
+#include "models/page.h"
+#include "dataAccess/storage.h"
 #include "utils/dbConnection.h"
+#include <functional>
 #include <vector>
 #include <optional>
 
-class ReviewData {
+class ReviewData : public ReviewStore {
 public:
-    ReviewData();
-    std::vector<Review> getAllReviews();
-    std::vector<Review> getReviewsByUserId(int userId);
-    std::vector<Review> getReviewsByRestaurantId(int restaurantId);
-    std::optional<Review> getReviewById(int id);
-    std::optional<Review> getUserReviewForRestaurant(int userId, int restaurantId);
-    bool addReview(const Review& review);
-    bool updateReview(const Review& review);
-    bool deleteReview(int id);
-    float getAverageRatingForRestaurant(int restaurantId);
-    int getReviewCountForRestaurant(int restaurantId);
+    explicit ReviewData(DbContext& context = DbContext::instance());
+    // Maps "id, user_id, restaurant_id, rating, comment" by position; shared with RestaurantData
+    static Review reviewFromRow(const RowsetRow& row);
+
+    std::vector<Review> getAllReviews() override;
+    // Batched full-table walk in id order; returns false if the database fails part-way
+    bool forEachReview(const std::function<void(const Review&)>& visit, int batchSize = 1000) override;
+    std::vector<Review> getReviewsByUserId(int userId) override;
+    std::vector<Review> getReviewsByRestaurantId(int restaurantId) override;
+    Page<Review> getReviewsByRestaurantId(int restaurantId, const PageRequest& pageRequest) override;
+    std::optional<Review> getReviewById(int id) override;
+    std::optional<Review> getUserReviewForRestaurant(int userId, int restaurantId) override;
+    bool addReview(const Review& review) override;
+    bool updateReview(const Review& review) override;
+    bool deleteReview(int id) override;
+    float getAverageRatingForRestaurant(int restaurantId) override;
+    int getReviewCountForRestaurant(int restaurantId) override;
     void updateRestaurantRating(int restaurantId);
 
 private:
     DbConnection dbConnection;
+
+    // Recalculates on conn, the writer's own connection, instead of borrowing a second one
+    void updateRestaurantRating(PooledConnection& conn, int restaurantId);
 };
 
 #endif // REVIEW_DATA_H
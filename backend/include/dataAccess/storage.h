@@ -0,0 +1,197 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include "models/auditLogEntry.h"
+#include "models/page.h"
+#include "models/payment.h"
+#include "models/reservation.h"
+#include "models/restaurant.h"
+#include "models/restaurantDetails.h"
+#include "models/review.h"
+#include "models/table.h"
+#include "models/user.h"
+#include "models/userRole.h"
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Storage interfaces the services program against. Each has a MariaDB implementation (the *Data
+// DAOs) and an in-memory one (memoryStorage.h); Storage::instance() picks the backend once per
+// process. Implementations are thread-safe and report failures the way the DAOs always have:
+// false, nullopt, empty results, 0 or -1, never by throwing.
+
+class ReservationStore {
+public:
+    virtual ~ReservationStore() = default;
+    virtual std::vector<Reservation> getAllReservations() = 0;
+    virtual Page<Reservation> getAllReservations(const PageRequest& pageRequest) = 0;
+    virtual bool forEachReservation(const std::function<void(const Reservation&)>& visit, int batchSize = 1000) = 0;
+    virtual std::vector<Reservation> getReservationsByUserId(int userId) = 0;
+    virtual std::vector<Reservation> getReservationsByRestaurantId(int restaurantId) = 0;
+    virtual std::vector<Reservation> getReservationsByTableId(int tableId) = 0;
+    virtual std::optional<Reservation> getReservationById(int id) = 0;
+    virtual std::optional<Reservation> getReservationByIdWithDetails(int id) = 0;
+    virtual bool addReservation(const Reservation& reservation) = 0;
+    virtual std::optional<Reservation> addReservationIfAvailable(const Reservation& reservation) = 0;
+    virtual bool updateReservation(const Reservation& reservation) = 0;
+    virtual bool deleteReservation(int id) = 0;
+    virtual bool updateReservationStatus(int id, const std::string& status) = 0;
+    virtual int updateReservationStatuses(const std::vector<int>& ids, const std::string& status) = 0;
+    virtual bool isTableAvailable(int tableId, const std::string& date, const std::string& startTime, const std::string& endTime, int excludeReservationId = 0) = 0;
+    virtual std::vector<int> getAvailableTableIds(int restaurantId, const std::string& date, const std::string& startTime, const std::string& endTime, int minCapacity = 0) = 0;
+    virtual std::optional<Reservation> getReservationByConfirmationToken(const std::string& token) = 0;
+    virtual bool updateReservationConfirmationToken(int id, const std::string& token) = 0;
+    virtual bool confirmReservation(const std::string& token) = 0;
+    // Cancels up to limit unpaid pending reservations created more than holdFor ago and clears their
+    // confirmation tokens, releasing the table. Returns rows changed, or -1 on failure.
+    virtual int expirePendingReservations(std::chrono::minutes holdFor, int limit) = 0;
+};
+
+class TableStore {
+public:
+    virtual ~TableStore() = default;
+    virtual std::vector<Table> getAllTables() = 0;
+    virtual std::vector<Table> getTablesByRestaurantId(int restaurantId) = 0;
+    virtual std::vector<Table> getAvailableTablesByRestaurantId(int restaurantId) = 0;
+    virtual std::vector<Table> getTablesWithReservationsByRestaurantId(int restaurantId) = 0;
+    virtual std::optional<Table> getTableById(int id) = 0;
+    virtual int addTable(const Table& table) = 0;
+    virtual int addTables(int restaurantId, const std::vector<Table>& tables) = 0;
+    virtual bool updateTable(const Table& table) = 0;
+    virtual bool deleteTable(int id) = 0;
+    virtual bool updateTableAvailability(int id, bool isAvailable) = 0;
+};
+
+class UserStore {
+public:
+    virtual ~UserStore() = default;
+    virtual std::vector<User> getAllUsers() = 0;
+    virtual Page<User> getAllUsers(const PageRequest& pageRequest) = 0;
+    virtual bool forEachUser(const std::function<void(const User&)>& visit, int batchSize = 1000) = 0;
+    virtual bool forEachAuditLogEntry(const std::function<void(const AuditLogEntry&)>& visit, int batchSize = 1000) = 0;
+    virtual std::optional<User> getUserById(int id) = 0;
+    virtual std::unordered_map<int, User> getUsersByIds(const std::vector<int>& ids) = 0;
+    virtual std::optional<User> getUserByUsername(const std::string& username) = 0;
+    virtual std::optional<User> getUserByEmail(const std::string& email) = 0;
+    virtual bool addUser(const User& user) = 0;
+    virtual bool updateUser(const User& user) = 0;
+    virtual bool deleteUser(int id) = 0;
+    // Replaces the stored hash, e.g. when a legacy or weaker hash is upgraded at login
+    virtual bool updatePasswordHash(int userId, const std::string& passwordHash) = 0;
+    // Marks the matching unverified, unexpired account as verified and clears the token
+    virtual bool verifyEmailToken(const std::string& token) = 0;
+    // Clears up to limit expired, unused email verification tokens. Returns rows changed, or -1 on failure.
+    virtual int clearExpiredVerificationTokens(int limit) = 0;
+
+    virtual std::vector<UserRole> getAllRoles() = 0;
+    virtual std::optional<UserRole> getRoleById(int id) = 0;
+    virtual bool updateUserRole(int userId, int roleId) = 0;
+    virtual bool updateUserStatus(int userId, bool isActive) = 0;
+    virtual int updateUserStatuses(const std::vector<int>& userIds, bool isActive) = 0;
+
+    virtual bool logAdminAction(int adminUserId, const std::string& action, const std::string& targetType = "",
+                                int targetId = 0, const std::string& details = "", const std::string& ipAddress = "") = 0;
+    virtual bool logAdminActions(int adminUserId, const std::string& action, const std::string& targetType,
+                                 const std::vector<int>& targetIds, const std::string& details = "", const std::string& ipAddress = "") = 0;
+};
+
+class RestaurantStore {
+public:
+    virtual ~RestaurantStore() = default;
+    virtual std::vector<Restaurant> getAllRestaurants() = 0;
+    virtual Page<Restaurant> getAllRestaurants(const PageRequest& pageRequest) = 0;
+    virtual std::optional<Restaurant> getRestaurantById(int id) = 0;
+    virtual std::unordered_map<int, Restaurant> getRestaurantsByIds(const std::vector<int>& ids) = 0;
+    // The restaurant with its tables and reservations, first review page and rating stats, read as
+    // one consistent load; nullopt if the restaurant does not exist or the load fails
+    virtual std::optional<RestaurantDetails> getRestaurantDetails(int id, const PageRequest& reviewPage) = 0;
+    virtual int addRestaurant(const Restaurant& restaurant) = 0;
+    virtual bool updateRestaurant(const Restaurant& restaurant) = 0;
+    virtual bool deleteRestaurant(int id) = 0;
+};
+
+class ReviewStore {
+public:
+    virtual ~ReviewStore() = default;
+    virtual std::vector<Review> getAllReviews() = 0;
+    virtual bool forEachReview(const std::function<void(const Review&)>& visit, int batchSize = 1000) = 0;
+    virtual std::vector<Review> getReviewsByUserId(int userId) = 0;
+    virtual std::vector<Review> getReviewsByRestaurantId(int restaurantId) = 0;
+    virtual Page<Review> getReviewsByRestaurantId(int restaurantId, const PageRequest& pageRequest) = 0;
+    virtual std::optional<Review> getReviewById(int id) = 0;
+    virtual std::optional<Review> getUserReviewForRestaurant(int userId, int restaurantId) = 0;
+    // Adding, updating or deleting a review also refreshes the restaurant's average rating
+    virtual bool addReview(const Review& review) = 0;
+    virtual bool updateReview(const Review& review) = 0;
+    virtual bool deleteReview(int id) = 0;
+    virtual float getAverageRatingForRestaurant(int restaurantId) = 0;
+    virtual int getReviewCountForRestaurant(int restaurantId) = 0;
+};
+
+class PaymentStore {
+public:
+    virtual ~PaymentStore() = default;
+    virtual std::vector<Payment> getAllPayments() = 0;
+    virtual std::vector<Payment> getPaymentsByUserId(int userId) = 0;
+    virtual std::vector<Payment> getPaymentsByReservationId(int reservationId) = 0;
+    virtual std::optional<Payment> getPaymentById(int id) = 0;
+    virtual bool addPayment(const Payment& payment) = 0;
+    virtual bool updatePayment(const Payment& payment) = 0;
+    virtual bool updatePaymentStatus(int id, const std::string& status) = 0;
+    virtual bool deletePayment(int id) = 0;
+};
+
+struct ActiveToken {
+    int userId = -1;
+    std::optional<std::chrono::seconds> expiresIn; // empty for tokens without an expiry
+};
+
+// Login session tokens
+class TokenStore {
+public:
+    virtual ~TokenStore() = default;
+    virtual bool storeToken(const std::string& token, int userId, std::chrono::seconds ttl) = 0;
+    virtual bool isTokenActive(const std::string& token) = 0;
+    // -1 if the token is unknown, revoked or expired
+    virtual int getUserIdForToken(const std::string& token) = 0;
+    // Owner and remaining lifetime in one lookup; nullopt if the token is unknown, revoked or expired
+    virtual std::optional<ActiveToken> getActiveToken(const std::string& token) = 0;
+    virtual void revokeToken(const std::string& token) = 0;
+    // Deletes up to limit expired tokens, oldest first. Returns rows deleted, or -1 on failure.
+    virtual int deleteExpiredTokens(int limit) = 0;
+};
+
+enum class StorageBackend {
+    MariaDb,
+    MariaDbNative, // MariaDB via Connector/C for the hot paths; only in BOOKBITE_MARIADB_NATIVE builds
+    Memory
+};
+
+// One set of stores sharing a backend
+class Storage {
+public:
+    virtual ~Storage() = default;
+
+    // Process-wide storage for STORAGE_BACKEND: "mariadb" (default), "mariadb-native" or "memory". The
+    // memory backend needs no database and loses everything on exit; it is meant for benchmarks and
+    // single-node demos. mariadb-native is only available when built with BOOKBITE_MARIADB_NATIVE.
+    static Storage& instance();
+    static StorageBackend backendFromEnvironment();
+    static const char* backendName(StorageBackend backend);
+    // True for the MariaDB backends, which need the schema and the connection pools
+    static bool usesDatabase(StorageBackend backend);
+
+    virtual StorageBackend backend() const = 0;
+    virtual ReservationStore& reservations() = 0;
+    virtual TableStore& tables() = 0;
+    virtual UserStore& users() = 0;
+    virtual RestaurantStore& restaurants() = 0;
+    virtual ReviewStore& reviews() = 0;
+    virtual PaymentStore& payments() = 0;
+    virtual TokenStore& tokens() = 0;
+};
+
+#endif // STORAGE_H
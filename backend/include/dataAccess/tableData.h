@@ -2,22 +2,33 @@
 #define TABLE_DATA_H
 
 #include "models/table.h"
+#include "dataAccess/storage.h"
 #include "utils/dbConnection.h"
 #include <vector>
 #include <optional>
 
-class TableData {
+class TableData : public TableStore {
 public:
-    TableData();
-    std::vector<Table> getAllTables();
-    std::vector<Table> getTablesByRestaurantId(int restaurantId);
-    std::vector<Table> getAvailableTablesByRestaurantId(int restaurantId);
-    std::vector<Table> getTablesWithReservationsByRestaurantId(int restaurantId);
-    std::optional<Table> getTableById(int id);
-    int addTable(const Table& table);
-    bool updateTable(const Table& table);
-    bool deleteTable(int id);
-    bool updateTableAvailability(int id, bool isAvailable);
+    explicit TableData(DbContext& context = DbContext::instance());
+    // Row mappers, shared with RestaurantData::getRestaurantDetails.
+    // "id, restaurant_id, seat_count, is_available"
+    static Table tableFromRow(const RowsetRow& row);
+    // "id, table_id, date, start_time, end_time, status, guest_count"; the caller reads table_id
+    static ReservationInfo reservationInfoFromRow(const RowsetRow& row);
+
+    std::vector<Table> getAllTables() override;
+    std::vector<Table> getTablesByRestaurantId(int restaurantId) override;
+    std::vector<Table> getAvailableTablesByRestaurantId(int restaurantId) override;
+    // Tables and their current and upcoming reservations, read as one two-statement batch
+    std::vector<Table> getTablesWithReservationsByRestaurantId(int restaurantId) override;
+    std::optional<Table> getTableById(int id) override;
+    int addTable(const Table& table) override;
+    // Inserts all tables with one array-bound statement and refreshes table_count once, in a single
+    // transaction. Returns the number of tables created, or 0 if nothing was written.
+    int addTables(int restaurantId, const std::vector<Table>& tables) override;
+    bool updateTable(const Table& table) override;
+    bool deleteTable(int id) override;
+    bool updateTableAvailability(int id, bool isAvailable) override;
 
 private:
     DbConnection dbConnection;
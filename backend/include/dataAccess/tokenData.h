@@ -0,0 +1,23 @@
+#ifndef TOKEN_DATA_H
+#define TOKEN_DATA_H
+
+#include "dataAccess/storage.h"
+#include "utils/dbConnection.h"
+#include <chrono>
+#include <string>
+
+class TokenData : public TokenStore {
+public:
+    explicit TokenData(DbContext& context = DbContext::instance());
+    bool storeToken(const std::string& token, int userId, std::chrono::seconds ttl) override;
+    bool isTokenActive(const std::string& token) override;
+    int getUserIdForToken(const std::string& token) override;
+    std::optional<ActiveToken> getActiveToken(const std::string& token) override;
+    void revokeToken(const std::string& token) override;
+    int deleteExpiredTokens(int limit) override;
+
+private:
+    DbConnection dbConnection;
+};
+
+#endif // TOKEN_DATA_H
@@ -3,32 +3,69 @@
 
 #include "models/user.h"
 #include "models/userRole.h"
+#include "models/page.h"
+#include "dataAccess/storage.h"
 #include "utils/dbConnection.h"
+#include "models/auditLogEntry.h"
+#include <chrono>
+#include <functional>
+#include <map>
 #include <vector>
 #include <optional>
+#include <shared_mutex>
+#include <unordered_map>
 
-class UserData {
+class UserData : public UserStore {
 public:
-    UserData();
-    std::vector<User> getAllUsers();
-    std::optional<User> getUserById(int id);
-    std::optional<User> getUserByUsername(const std::string& username);
-    std::optional<User> getUserByEmail(const std::string& email);
-    bool addUser(const User& user);
-    bool updateUser(const User& user);
-    bool deleteUser(int id);
-    bool validateUser(const std::string& username, const std::string& password);
+    explicit UserData(DbContext& context = DbContext::instance());
+
+    std::vector<User> getAllUsers() override;
+    Page<User> getAllUsers(const PageRequest& pageRequest) override;
+    // Batched full-table walks in id order; return false if the database fails part-way
+    bool forEachUser(const std::function<void(const User&)>& visit, int batchSize = 1000) override;
+    bool forEachAuditLogEntry(const std::function<void(const AuditLogEntry&)>& visit, int batchSize = 1000) override;
+    std::optional<User> getUserById(int id) override;
+    std::unordered_map<int, User> getUsersByIds(const std::vector<int>& ids) override;
+    std::optional<User> getUserByUsername(const std::string& username) override;
+    std::optional<User> getUserByEmail(const std::string& email) override;
+    bool addUser(const User& user) override;
+    bool updateUser(const User& user) override;
+    bool deleteUser(int id) override;
+    bool updatePasswordHash(int userId, const std::string& passwordHash) override;
+    bool verifyEmailToken(const std::string& token) override;
+    int clearExpiredVerificationTokens(int limit) override;
     
-    std::vector<UserRole> getAllRoles();
-    std::optional<UserRole> getRoleById(int id);
-    bool updateUserRole(int userId, int roleId);
-    bool updateUserStatus(int userId, bool isActive);
+    std::vector<UserRole> getAllRoles() override;
+    std::optional<UserRole> getRoleById(int id) override;
+    bool updateUserRole(int userId, int roleId) override;
+    bool updateUserStatus(int userId, bool isActive) override;
+    // Array-bound, single-transaction form of updateUserStatus. Returns rows changed, or -1 on failure.
+    int updateUserStatuses(const std::vector<int>& userIds, bool isActive) override;
     
     bool logAdminAction(int adminUserId, const std::string& action, const std::string& targetType = "", 
-                       int targetId = 0, const std::string& details = "", const std::string& ipAddress = "");
+                       int targetId = 0, const std::string& details = "", const std::string& ipAddress = "") override;
+    // One audit row per target id, inserted with a single array-bound statement
+    bool logAdminActions(int adminUserId, const std::string& action, const std::string& targetType,
+                         const std::vector<int>& targetIds, const std::string& details = "", const std::string& ipAddress = "") override;
+
+protected:
+    // Reads user_roles into the role cache if it is empty or stale. Call before borrowing the
+    // connection for a user query, so the two never hold connections at once.
+    void ensureRolesLoaded();
+    // Role name and permissions for user.getRoleId() from the cache; "user" with no
+    // permissions for an unknown role, as the old LEFT JOIN gave
+    void applyRole(User& user) const;
 
 private:
     DbConnection dbConnection;
+    // Full row, email verification state and cached role of the user whose column (username or
+    // email, both unique) equals value
+    std::optional<User> getUserByKey(const std::string& column, const std::string& value);
+    // user_roles, parsed once per refresh instead of joined and re-parsed for every user row
+    mutable std::shared_mutex roleMutex;
+    std::map<int, UserRole> roles;
+    std::chrono::steady_clock::time_point rolesLoadedAt;
+    bool rolesLoaded = false;
 };
 
 #endif // USER_DATA_H
@@ -0,0 +1,43 @@
+#ifndef AUDIT_LOG_ENTRY_H
+#define AUDIT_LOG_ENTRY_H
+
+#include <string>
+
+// One row of admin_audit_log, with the acting admin's username
+class AuditLogEntry {
+public:
+    AuditLogEntry();
+    
+    int getId() const;
+    int getAdminUserId() const;
+    std::string getAdminUsername() const;
+    std::string getAction() const;
+    std::string getTargetType() const;
+    int getTargetId() const;
+    std::string getDetails() const;
+    std::string getIpAddress() const;
+    std::string getCreatedAt() const;
+    
+    void setId(int id);
+    void setAdminUserId(int adminUserId);
+    void setAdminUsername(const std::string& adminUsername);
+    void setAction(const std::string& action);
+    void setTargetType(const std::string& targetType);
+    void setTargetId(int targetId);
+    void setDetails(const std::string& details);
+    void setIpAddress(const std::string& ipAddress);
+    void setCreatedAt(const std::string& createdAt);
+
+private:
+    int id;
+    int adminUserId;
+    std::string adminUsername;
+    std::string action;
+    std::string targetType;
+    int targetId;
+    std::string details;
+    std::string ipAddress;
+    std::string createdAt;
+};
+
+#endif // AUDIT_LOG_ENTRY_H
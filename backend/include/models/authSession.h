@@ -0,0 +1,21 @@
+#ifndef AUTH_SESSION_H
+#define AUTH_SESSION_H
+
+#include "models/permission.h"
+#include <cstddef>
+#include <string>
+
+// What a request's bearer token resolves to: the user it belongs to and that user's role
+struct AuthSession {
+    int userId = -1;
+    int roleId = 0;
+    std::string roleName;
+    PermissionSet permissions;
+    bool isAdmin = false;
+
+    bool hasPermission(Permission permission) const {
+        return permissions.test(static_cast<std::size_t>(permission));
+    }
+};
+
+#endif // AUTH_SESSION_H
@@ -0,0 +1,40 @@
+#ifndef PAGE_H
+#define PAGE_H
+
+#include <optional>
+#include <vector>
+
+// Keyset pagination: rows are ordered by id and each page starts after the last id the client saw,
+// so the database seeks on the primary key instead of scanning past an OFFSET.
+struct PageRequest {
+    static constexpr int defaultLimit = 50;
+    static constexpr int maxLimit = 500;
+
+    int after = 0;             // exclusive lower bound on id; 0 starts from the beginning
+    int limit = defaultLimit;  // 0 means no limit (explicit opt-in to the full list)
+
+    static PageRequest unbounded() {
+        PageRequest page;
+        page.limit = 0;
+        return page;
+    }
+
+    bool isBounded() const { return limit > 0; }
+};
+
+template <typename T>
+struct Page {
+    std::vector<T> items;
+    std::optional<int> nextCursor; // pass as `after` for the following page; empty on the last page
+};
+
+// DAOs fetch limit + 1 rows; the extra row only signals that another page exists
+template <typename T>
+void finishPage(Page<T>& page, const PageRequest& request) {
+    if (request.isBounded() && static_cast<int>(page.items.size()) > request.limit) {
+        page.items.resize(request.limit);
+        page.nextCursor = page.items.back().getId();
+    }
+}
+
+#endif // PAGE_H
@@ -0,0 +1,69 @@
+#ifndef PERMISSION_H
+#define PERMISSION_H
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The permissions a role can grant, as stored (by name) in user_roles.permissions
+enum class Permission : std::size_t {
+    MakeReservation,
+    ViewReservations,
+    CancelReservation,
+    WriteReview,
+    ManageRestaurants,
+    ManageUsers,
+    ViewAdminPanel,
+    PromoteUsers,
+    Count
+};
+
+constexpr std::size_t permissionCount = static_cast<std::size_t>(Permission::Count);
+
+using PermissionSet = std::bitset<permissionCount>;
+
+// Indexed by Permission; also the order permissions are listed in JSON
+inline constexpr std::array<std::string_view, permissionCount> permissionNames = {
+    "make_reservation",
+    "view_reservations",
+    "cancel_reservation",
+    "write_review",
+    "manage_restaurants",
+    "manage_users",
+    "view_admin_panel",
+    "promote_users",
+};
+
+constexpr std::string_view permissionName(Permission permission) {
+    return permissionNames[static_cast<std::size_t>(permission)];
+}
+
+constexpr std::optional<Permission> permissionFromName(std::string_view name) {
+    for (std::size_t i = 0; i < permissionCount; ++i) {
+        if (permissionNames[i] == name) {
+            return static_cast<Permission>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+constexpr PermissionSet permissionSetOf(std::initializer_list<Permission> permissions) {
+    unsigned long long bits = 0;
+    for (Permission permission : permissions) {
+        bits |= 1ULL << static_cast<std::size_t>(permission);
+    }
+    return PermissionSet(bits);
+}
+
+// Bits for the names in a user_roles.permissions JSON array; unknown names are ignored.
+// Reads the text in place, without allocating.
+PermissionSet parsePermissionSet(std::string_view permissionsJson);
+// Names of the set permissions in Permission order, for JSON output
+std::vector<std::string> permissionNameList(const PermissionSet& permissions);
+
+#endif // PERMISSION_H
@@ -0,0 +1,19 @@
+#ifndef RESTAURANT_DETAILS_H
+#define RESTAURANT_DETAILS_H
+
+#include "models/page.h"
+#include "models/restaurant.h"
+#include "models/review.h"
+#include "models/table.h"
+#include <vector>
+
+// Everything the restaurant page shows, loaded together by RestaurantStore::getRestaurantDetails
+struct RestaurantDetails {
+    Restaurant restaurant;
+    std::vector<Table> tables; // with current and upcoming reservations, as getTablesWithReservationsByRestaurantId
+    Page<Review> reviews;      // first page in id order, as getReviewsByRestaurantId(restaurantId, pageRequest)
+    float averageRating = 0.0f;
+    int reviewCount = 0;
+};
+
+#endif // RESTAURANT_DETAILS_H
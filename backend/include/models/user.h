@@ -1,15 +1,15 @@
 #ifndef USER_H
 #define USER_H
 
+#include "models/permission.h"
 #include <string>
-#include <vector>
 
 class User {
 public:
     User();
     User(int id, const std::string& username, const std::string& email, const std::string& passwordHash);
     User(int id, const std::string& username, const std::string& email, const std::string& passwordHash, 
-         int roleId, const std::string& roleName, const std::vector<std::string>& permissions);
+         int roleId, const std::string& roleName, const PermissionSet& permissions);
     
     int getId() const;
     std::string getUsername() const;
@@ -17,7 +17,7 @@ public:
     std::string getPasswordHash() const;
     int getRoleId() const;
     std::string getRoleName() const;
-    std::vector<std::string> getPermissions() const;
+    PermissionSet getPermissions() const;
     std::string getFirstName() const;
     std::string getLastName() const;
     std::string getPhoneNumber() const;
@@ -33,7 +33,7 @@ public:
     void setPasswordHash(const std::string& passwordHash);
     void setRoleId(int roleId);
     void setRoleName(const std::string& roleName);
-    void setPermissions(const std::vector<std::string>& permissions);
+    void setPermissions(const PermissionSet& permissions);
     void setFirstName(const std::string& firstName);
     void setLastName(const std::string& lastName);
     void setPhoneNumber(const std::string& phoneNumber);
@@ -43,7 +43,7 @@ public:
     void setEmailVerificationExpires(const std::string& expires);
     void setCreatedAt(const std::string& createdAt);
     
-    bool hasPermission(const std::string& permission) const;
+    bool hasPermission(Permission permission) const;
     bool isAdmin() const;
 
 private:
@@ -53,7 +53,7 @@ private:
     std::string passwordHash;
     int roleId;
     std::string roleName;
-    std::vector<std::string> permissions;
+    PermissionSet permissions;
     std::string firstName;
     std::string lastName;
     std::string phoneNumber;
@@ -1,32 +1,32 @@
 #ifndef USER_ROLE_H
 #define USER_ROLE_H
 
+#include "models/permission.h"
 #include <string>
-#include <vector>
 
 class UserRole {
 public:
     UserRole();
     UserRole(int id, const std::string& name, const std::string& description, 
-             const std::vector<std::string>& permissions);
+             const PermissionSet& permissions);
     
     int getId() const;
     std::string getName() const;
     std::string getDescription() const;
-    std::vector<std::string> getPermissions() const;
+    PermissionSet getPermissions() const;
     
     void setId(int id);
     void setName(const std::string& name);
     void setDescription(const std::string& description);
-    void setPermissions(const std::vector<std::string>& permissions);
+    void setPermissions(const PermissionSet& permissions);
     
-    bool hasPermission(const std::string& permission) const;
+    bool hasPermission(Permission permission) const;
 
 private:
     int id;
     std::string name;
     std::string description;
-    std::vector<std::string> permissions;
+    PermissionSet permissions;
 };
 
 #endif // USER_ROLE_H
@@ -6,37 +6,63 @@
 #include "businessLogic/restaurantService.h"
 #include "businessLogic/reservationService.h"
 #include "businessLogic/reviewService.h"
-#include "dataAccess/userData.h"
-#include "dataAccess/restaurantData.h"
-#include "dataAccess/reservationData.h"
+#include "businessLogic/exportService.h"
+#include "dataAccess/storage.h"
+#include "presentation/authMiddleware.h"
 #include "utils/emailService.h"
+#include "utils/ioExecutor.h"
+#include "utils/rateLimiter.h"
+#include <functional>
+#include <optional>
 
 class ApiController {
 public:
     ApiController();
-    void setupRoutes(crow::App<>& app);
+    void setupRoutes(crow::App<AuthMiddleware>& app);
 
 private:
     AuthService authService;
     RestaurantService restaurantService;
     ReservationService reservationService;
     ReviewService reviewService;
-    UserData userData;
-    RestaurantData restaurantData;
-    ReservationData reservationData;
+    ExportService exportService;
+    UserStore& userData;
+    RestaurantStore& restaurantData;
+    ReservationStore& reservationData;
     EmailService emailService;
+    RateLimitConfig rateLimits;
+    RateLimiter rateLimiter;
+    crow::App<AuthMiddleware>* crowApp = nullptr;
 
-    void setupAuthRoutes(crow::App<>& app);
-    void setupRestaurantRoutes(crow::App<>& app);
-    void setupReservationRoutes(crow::App<>& app);
-    void setupReviewRoutes(crow::App<>& app);
-    void setupAdminRoutes(crow::App<>& app);
+    void setupAuthRoutes(crow::App<AuthMiddleware>& app);
+    void setupRestaurantRoutes(crow::App<AuthMiddleware>& app);
+    void setupReservationRoutes(crow::App<AuthMiddleware>& app);
+    void setupReviewRoutes(crow::App<AuthMiddleware>& app);
+    void setupAdminRoutes(crow::App<AuthMiddleware>& app);
+    // Auth state AuthMiddleware resolved for this request; the helpers below only read it
+    const AuthMiddleware::context& authContext(const crow::request& req);
     bool isAuthenticated(const crow::request& req);
     bool isAdmin(const crow::request& req);
     int getUserIdFromRequest(const crow::request& req);
+    // remote address, or the first X-Forwarded-For hop with RATE_LIMIT_TRUST_FORWARDED_FOR=true
+    std::string clientIp(const crow::request& req);
+    // 429 with Retry-After once the client IP's or the account's bucket for route is empty, checked
+    // before the route does any query, hash or mail; nullopt when the request may go ahead
+    std::optional<crow::response> rateLimited(const crow::request& req, const std::string& route,
+                                              const RouteRateLimits& limits, const std::string& account);
 
     // Helper to add CORS headers to responses
     crow::response createResponse(int code, const std::string& body);
+    // Keyset paging from ?limit=&after=; ?all=true opts into the full, unpaginated list
+    PageRequest getPageRequest(const crow::request& req);
+    // Adds the X-Next-Cursor header when another page exists
+    crow::response withNextCursor(crow::response res, const std::optional<int>& nextCursor);
+    // Runs work on an executor (the database one by default) and completes res with its result.
+    // The executor bounds how much of that work runs at once and answers 503 with Retry-After when
+    // its queue is full. The calling Crow worker waits for the result, so res and the connection
+    // are only ever touched on the thread that owns them; work must not capture req by reference.
+    void respondOn(crow::response& res, std::function<crow::response()> work,
+                   IoExecutor& executor = IoExecutor::database());
 };
 
 #endif // API_CONTROLLER_H
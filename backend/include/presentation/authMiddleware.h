@@ -0,0 +1,34 @@
+#ifndef AUTH_MIDDLEWARE_H
+#define AUTH_MIDDLEWARE_H
+
+#include "crow.h"
+#include "businessLogic/authService.h"
+#include "models/authSession.h"
+#include <optional>
+#include <string>
+
+// Crow middleware that resolves the Authorization bearer token once, before the route handler
+// runs. Handlers read the result from app.get_context<AuthMiddleware>(req) rather than asking
+// AuthService again. An absent or invalid token leaves the context empty; routes decide whether
+// that means 401.
+struct AuthMiddleware {
+    struct context {
+        std::string token;                  // bearer token as sent, empty if there was none
+        std::optional<AuthSession> session; // set when the token is valid
+
+        bool isAuthenticated() const { return session.has_value(); }
+        int userId() const { return session ? session->userId : -1; }
+        bool isAdmin() const { return session && session->isAdmin; }
+    };
+
+    // Must be called before the app starts serving
+    void setAuthService(AuthService& service);
+
+    void before_handle(crow::request& req, crow::response& res, context& ctx);
+    void after_handle(crow::request& req, crow::response& res, context& ctx);
+
+private:
+    AuthService* authService = nullptr;
+};
+
+#endif // AUTH_MIDDLEWARE_H
@@ -0,0 +1,73 @@
+#ifndef BATCH_LOADER_H
+#define BATCH_LOADER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// "?, ?, ?" for an IN (...) clause with count parameters
+inline std::string sqlPlaceholders(std::size_t count) {
+    std::string placeholders;
+    placeholders.reserve(count * 3);
+    for (std::size_t i = 0; i < count; ++i) {
+        placeholders += (i == 0) ? "?" : ", ?";
+    }
+    return placeholders;
+}
+
+// Collects keys, then loads them with one IN (...) query per chunk and fans the rows back out by key.
+// Replaces per-row lookups (N+1 queries) with ceil(N / maxBatchSize) round trips.
+template <typename Key, typename Value>
+class BatchLoader {
+public:
+    // Runs one query for keys and stores every row found in results; missing keys are simply absent
+    using Fetch = std::function<void(const std::vector<Key>& keys, std::unordered_map<Key, Value>& results)>;
+
+    static constexpr std::size_t defaultMaxBatchSize = 256;
+
+    explicit BatchLoader(Fetch fetch, std::size_t maxBatchSize = defaultMaxBatchSize)
+        : fetch(std::move(fetch)), maxBatchSize(std::max<std::size_t>(1, maxBatchSize)) {}
+
+    void add(const Key& key) {
+        if (seen.insert(key).second) {
+            keys.push_back(key);
+        }
+    }
+
+    std::unordered_map<Key, Value> load() {
+        std::unordered_map<Key, Value> results;
+        results.reserve(keys.size());
+
+        for (std::size_t start = 0; start < keys.size(); start += maxBatchSize) {
+            std::size_t end = std::min(keys.size(), start + maxBatchSize);
+            std::vector<Key> chunk(keys.begin() + start, keys.begin() + end);
+
+            // Pad to a power of two by repeating the last key so only a handful of distinct
+            // IN (...) shapes reach the per-connection statement cache
+            std::size_t padded = 1;
+            while (padded < chunk.size()) {
+                padded <<= 1;
+            }
+            padded = std::min(padded, maxBatchSize);
+            chunk.resize(std::max(padded, chunk.size()), chunk.back());
+
+            fetch(chunk, results);
+        }
+
+        keys.clear();
+        seen.clear();
+        return results;
+    }
+
+private:
+    Fetch fetch;
+    std::size_t maxBatchSize;
+    std::vector<Key> keys;
+    std::unordered_set<Key> seen;
+};
+
+#endif // BATCH_LOADER_H
@@ -0,0 +1,157 @@
+#ifndef CONNECTION_POOL_H
+#define CONNECTION_POOL_H
+
+#include "utils/rowsetFetch.h"
+#include "utils/statementCache.h"
+#include <nanodbc/nanodbc.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct ConnectionPoolConfig {
+    std::string name = "primary"; // used in log messages
+    // Built connection strings enable MULTI_STATEMENTS for PooledConnection::fetchResults;
+    // a DB_CONNECTION_STRING must set it itself
+    std::string connectionString;
+    std::size_t minSize = 2;
+    std::size_t maxSize = 16;
+    std::chrono::milliseconds borrowTimeout{5000};
+    std::chrono::milliseconds idleTimeout{300000};
+    std::chrono::milliseconds validationInterval{30000};
+    std::size_t statementCacheSize = 64; // prepared statements kept per connection
+    std::size_t fetchRowsetSize = 128;   // rows per SQLFetch in PooledConnection::fetch
+    std::size_t fetchLongColumnBytes = 4096; // bound buffer cap for TEXT columns in fetch
+
+    // Reads DB_* settings (see .env.example), falling back to the local development database
+    static ConnectionPoolConfig fromEnvironment();
+    // Read replica from DB_REPLICA_* settings; anything not set there is taken from the primary's
+    // DB_* settings. nullopt unless DB_REPLICA_CONNECTION_STRING or DB_REPLICA_HOST is set.
+    static std::optional<ConnectionPoolConfig> replicaFromEnvironment();
+};
+
+struct ConnectionPoolStats {
+    std::size_t totalConnections = 0;
+    std::size_t idleConnections = 0;
+    std::size_t inUse = 0;
+    std::size_t waiters = 0;
+    std::uint64_t borrows = 0;
+    std::uint64_t timeouts = 0;
+    std::uint64_t created = 0;
+    std::uint64_t evicted = 0;
+    std::uint64_t validationFailures = 0;
+    double totalWaitMs = 0.0;
+    double maxWaitMs = 0.0;
+    std::uint64_t statementCacheHits = 0;
+    std::uint64_t statementCacheMisses = 0;
+    std::uint64_t statementCacheEvictions = 0;
+};
+
+// Thrown when no connection can be borrowed within borrowTimeout. Not a nanodbc::database_error:
+// nothing reached the database, so there are no ODBC diagnostics to carry. The DAOs catch
+// std::runtime_error, the common base of both, so pool exhaustion is still reported the way any
+// other database failure is; code that must tell them apart (ReplicaRouter) catches this first.
+class ConnectionPoolError : public std::runtime_error {
+public:
+    explicit ConnectionPoolError(const std::string& message);
+};
+
+class ConnectionPool;
+
+struct PooledConnectionSlot {
+    nanodbc::connection connection;
+    StatementCache statements; // declared after connection so statements are freed first
+    std::chrono::steady_clock::time_point lastUsed;
+    std::chrono::steady_clock::time_point lastValidated;
+
+    PooledConnectionSlot(std::size_t statementCacheSize, StatementCacheCounters* counters)
+        : statements(statementCacheSize, counters) {}
+};
+
+// RAII handle for a borrowed connection; returns it to the pool when destroyed
+class PooledConnection {
+public:
+    PooledConnection(ConnectionPool* pool, std::unique_ptr<PooledConnectionSlot> slot);
+    PooledConnection(PooledConnection&& other) noexcept;
+    PooledConnection& operator=(PooledConnection&& other) noexcept;
+    PooledConnection(const PooledConnection&) = delete;
+    PooledConnection& operator=(const PooledConnection&) = delete;
+    ~PooledConnection();
+
+    nanodbc::connection& get();
+    operator nanodbc::connection&();
+
+    // Prepared statement for sql, reused across borrows of this connection. Valid until this handle
+    // is released, however many others are prepared meanwhile; bind all parameters before each execute.
+    nanodbc::statement& prepare(const std::string& sql);
+
+    // Executes a statement from prepare() and records its latency, row count and failures in
+    // QueryStats under this handle's caller
+    nanodbc::result execute(nanodbc::statement& stmt, long batchOperations = 1);
+
+    // Executes a statement from prepare() and reads the result through a block cursor
+    // (fetchRowsets, with this pool's DB_FETCH_* settings), calling visit for every row. Used for
+    // multi-row reads; recorded in QueryStats like execute(), excluding the time spent in visit.
+    // Returns the number of rows.
+    long fetch(nanodbc::statement& stmt, const std::function<void(const RowsetRow&)>& visit);
+
+    // fetch() for a prepared batch of statements: one round trip, result set i read with
+    // visitors[i] (fetchResultSets). Recorded in QueryStats as a single statement.
+    long fetchResults(nanodbc::statement& stmt, const std::vector<std::function<void(const RowsetRow&)>>& visitors);
+
+    // DAO method the connection was borrowed for, used to label QueryStats entries
+    void setCaller(std::string caller);
+
+    // Drop the connection instead of returning it, e.g. after a connection-level failure
+    void discard();
+
+private:
+    ConnectionPool* pool;
+    std::unique_ptr<PooledConnectionSlot> slot;
+    bool broken;
+    std::string caller;
+
+    void release();
+};
+
+class ConnectionPool {
+public:
+    explicit ConnectionPool(const ConnectionPoolConfig& config);
+    ~ConnectionPool();
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    PooledConnection acquire();
+    ConnectionPoolStats getStats() const;
+    std::size_t evictIdle();
+    const ConnectionPoolConfig& getConfig() const;
+
+private:
+    friend class PooledConnection;
+
+    ConnectionPoolConfig config;
+    mutable std::mutex mutex;
+    std::condition_variable available;
+    std::vector<std::unique_ptr<PooledConnectionSlot>> idle; // most recently used at the back
+    std::size_t total;   // idle + borrowed + currently being opened
+    std::size_t inUse;
+    std::size_t waiters;
+    ConnectionPoolStats counters;
+    StatementCacheCounters statementCounters;
+
+    std::unique_ptr<PooledConnectionSlot> openSlot();
+    bool validate(PooledConnectionSlot& slot);
+    void release(std::unique_ptr<PooledConnectionSlot> slot, bool broken);
+    void collectExpiredLocked(std::vector<std::unique_ptr<PooledConnectionSlot>>& expired);
+    void recordWait(std::chrono::steady_clock::time_point start);
+    void warmUp();
+};
+
+#endif // CONNECTION_POOL_H
@@ -1,21 +1,34 @@
 #ifndef DB_CONNECTION_H
 #define DB_CONNECTION_H
 
+#include "utils/connectionPool.h"
+#include "utils/dbContext.h"
+#include "utils/replicaRouter.h"
 #include <nanodbc/nanodbc.h>
 #include <string>
 
 class DbConnection {
 public:
-    DbConnection();
-    ~DbConnection();
-    nanodbc::connection getConnection(); // Create new connection each time
-    static nanodbc::connection createConnection(); // Static method for new connections
+    // owner prefixes the calling method in query metrics, e.g. "ReservationData" + "::isTableAvailable".
+    // Borrows from context's pools, which are opened on the first borrow rather than here.
+    explicit DbConnection(std::string owner = "", DbContext& context = DbContext::instance());
+    // Borrow from the shared pool; returned when the handle goes out of scope. method defaults to
+    // the calling function's name (GCC/Clang builtin), so DAO call sites need not pass it.
+    PooledConnection getConnection(const char* method = __builtin_FUNCTION());
+    // For read-only queries that tolerate replication lag; the replica when healthy, else the primary.
+    // Writes and reads of just-written rows must use getConnection().
+    PooledConnection getReadConnection(const char* method = __builtin_FUNCTION());
     bool isConnected();
+    static ConnectionPoolStats getPoolStats();
+    static ReplicaStats getReplicaStats();
 
 private:
-    nanodbc::connection connection;
-    std::string connectionString;
-    void setupConnection();
+    std::string owner;
+    DbContext& context;
+
+    PooledConnection labelled(PooledConnection conn, const std::string& caller,
+                              std::chrono::steady_clock::time_point start);
+    std::string callerName(const char* method) const;
 };
 
 #endif // DB_CONNECTION_H
@@ -0,0 +1,41 @@
+#ifndef DB_CONTEXT_H
+#define DB_CONTEXT_H
+
+#include "utils/connectionPool.h"
+#include "utils/replicaRouter.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+// The database state every DAO shares: the primary pool and the read router over it. Passed to
+// the DAOs (and from them to DbConnection) by reference. Nothing is opened until the first
+// connection is borrowed, so constructing the context or any number of DAOs costs no round trip.
+class DbContext {
+public:
+    DbContext() = default;
+    DbContext(const DbContext&) = delete;
+    DbContext& operator=(const DbContext&) = delete;
+
+    // Process-wide context over the DB_* and DB_REPLICA_* settings
+    static DbContext& instance();
+
+    // Created, and warmed up, on first call
+    ConnectionPool& primary();
+    ReplicaRouter& reads();
+    // Closes connections idle for longer than DB_POOL_IDLE_TIMEOUT_MS in the primary and replica
+    // pools, down to their minimum sizes. Pools only do this as connections are returned, so an
+    // idle pool needs this to shrink; run periodically by the maintenance scheduler. Returns the
+    // number closed; never opens the pools.
+    std::size_t evictIdleConnections();
+
+private:
+    std::once_flag opened;
+    std::atomic<bool> isOpen{false};
+    std::unique_ptr<ConnectionPool> primaryPool;
+    std::unique_ptr<ReplicaRouter> readRouter;
+
+    void open();
+};
+
+#endif // DB_CONTEXT_H
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <functional>
 
 class EmailService {
 public:
@@ -38,6 +39,10 @@ public:
     
     std::string generateConfirmationToken();
     
+    // Runs send on the mail executor with a copy of this service so the caller does not wait on SMTP.
+    // Returns false if the mail queue is full; delivery failures are only logged.
+    bool sendInBackground(std::function<bool(EmailService&)> send, const std::string& description);
+    
 private:
     std::string smtpHost;
     int smtpPort;
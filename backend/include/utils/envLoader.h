@@ -3,12 +3,15 @@
 
 #include <string>
 #include <map>
+#include <cstddef>
 
 class EnvLoader {
 public:
     EnvLoader();
     static void loadFromFile(const std::string& filename = ".env");
     static std::string getEnv(const std::string& key, const std::string& defaultValue = "");
+    // Non-negative integer setting; logs and falls back to defaultValue when unset or malformed
+    static std::size_t getEnvSize(const std::string& key, std::size_t defaultValue);
     
 private:
     static std::map<std::string, std::string> envVars;
@@ -0,0 +1,40 @@
+#ifndef EXPORT_WRITER_H
+#define EXPORT_WRITER_H
+
+#include <nlohmann/json.hpp>
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+enum class ExportFormat {
+    Ndjson,
+    Csv
+};
+
+// "ndjson" or "csv"; nullopt for anything else
+std::optional<ExportFormat> parseExportFormat(const std::string& name);
+std::string exportFormatExtension(ExportFormat format);
+std::string exportFormatContentType(ExportFormat format);
+
+// Writes one row at a time, so an export holds a single row in memory however large the table.
+// NDJSON emits one JSON object per line; CSV emits a header line and RFC 4180 quoted fields.
+class ExportWriter {
+public:
+    ExportWriter(std::ostream& out, ExportFormat format, std::vector<std::string> columns);
+
+    // row is keyed by column name; missing keys are written as empty/null
+    void writeRow(const nlohmann::json& row);
+    std::size_t getRowCount() const;
+
+private:
+    std::ostream& out;
+    ExportFormat format;
+    std::vector<std::string> columns;
+    std::size_t rowCount;
+
+    void writeCsvField(const nlohmann::json& value);
+};
+
+#endif // EXPORT_WRITER_H
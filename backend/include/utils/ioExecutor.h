@@ -0,0 +1,98 @@
+#ifndef IO_EXECUTOR_H
+#define IO_EXECUTOR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+struct IoExecutorStats {
+    std::string name;
+    std::size_t threads = 0;
+    std::size_t queueDepth = 0;
+    std::size_t maxQueueDepth = 0; // high-water mark since start
+    std::size_t queueCapacity = 0;
+    std::size_t active = 0;
+    std::uint64_t submitted = 0;
+    std::uint64_t completed = 0;
+    std::uint64_t failed = 0;
+    std::uint64_t rejected = 0;
+    double totalQueueWaitMs = 0.0;
+    double maxQueueWaitMs = 0.0;
+};
+
+// Thrown by submit() when the queue is full or the executor is shutting down
+class IoExecutorRejected : public std::runtime_error {
+public:
+    explicit IoExecutorRejected(const std::string& message) : std::runtime_error(message) {}
+};
+
+// Fixed-size thread pool for blocking I/O (database queries, SMTP) so Crow's HTTP workers
+// are not held while a query or mail server is slow. The queue is bounded; work beyond it
+// is rejected rather than piling up behind a stalled backend.
+class IoExecutor {
+public:
+    IoExecutor(std::string name, std::size_t threads, std::size_t queueCapacity);
+    ~IoExecutor();
+    IoExecutor(const IoExecutor&) = delete;
+    IoExecutor& operator=(const IoExecutor&) = delete;
+
+    // Pool for DAO work (IO_DB_THREADS, IO_DB_QUEUE_CAPACITY)
+    static IoExecutor& database();
+    // Pool for outbound mail (IO_MAIL_THREADS, IO_MAIL_QUEUE_CAPACITY)
+    static IoExecutor& mail();
+    // Pool for password hashing (IO_HASH_THREADS, IO_HASH_QUEUE_CAPACITY); each running hash
+    // holds its scrypt buffer, so the thread count also caps that memory
+    static IoExecutor& hashing();
+
+    // Fire-and-forget; returns false if the task was rejected
+    bool execute(std::function<void()> task);
+
+    // Runs work on the pool and returns its result through a future; throws IoExecutorRejected
+    template <typename Work>
+    auto submit(Work&& work) -> std::future<std::invoke_result_t<std::decay_t<Work>>> {
+        using Result = std::invoke_result_t<std::decay_t<Work>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Work>(work));
+        std::future<Result> future = task->get_future();
+        if (!execute([task] { (*task)(); })) {
+            throw IoExecutorRejected("Executor '" + name + "' rejected task (queue full or stopped)");
+        }
+        return future;
+    }
+
+    IoExecutorStats getStats() const;
+
+    // Stops accepting work, runs what is already queued and joins the threads
+    void shutdown();
+
+private:
+    struct QueuedTask {
+        std::function<void()> run;
+        std::chrono::steady_clock::time_point enqueuedAt;
+    };
+
+    std::string name;
+    std::size_t queueCapacity;
+    mutable std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<QueuedTask> queue;
+    std::vector<std::thread> workers;
+    bool stopping;
+    IoExecutorStats counters;
+
+    void workerLoop();
+};
+
+#endif // IO_EXECUTOR_H
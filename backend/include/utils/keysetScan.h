@@ -0,0 +1,37 @@
+#ifndef KEYSET_SCAN_H
+#define KEYSET_SCAN_H
+
+#include "utils/dbConnection.h"
+#include <nanodbc/nanodbc.h>
+#include <string>
+
+// Walks a whole table in primary-key order, one bounded batch per round trip, so a full scan
+// never holds more than batchSize rows (the ODBC driver buffers each result set client-side).
+// query takes two parameters, the last id seen and the batch size, and must end with
+// "WHERE <id> > ? ORDER BY <id> LIMIT ?". Each batch is read through a block cursor
+// (PooledConnection::fetch); readRow takes a RowsetRow, read by column position, and returns its id.
+// Batches are read through getReadConnection(), so a scan may trail the primary by the replica
+// lag, and recorded in query metrics under the calling DAO method. The connection goes back to
+// the pool between batches. Throws nanodbc::database_error or ConnectionPoolError.
+template <typename ReadRow>
+void keysetScan(DbConnection& dbConnection, const std::string& query, int batchSize, ReadRow&& readRow,
+                const char* method = __builtin_FUNCTION()) {
+    if (batchSize < 1) {
+        batchSize = 1;
+    }
+    int after = 0;
+    for (;;) {
+        PooledConnection conn = dbConnection.getReadConnection(method);
+        nanodbc::statement& stmt = conn.prepare(query);
+        stmt.bind(0, &after);
+        stmt.bind(1, &batchSize);
+        long rows = conn.fetch(stmt, [&](const RowsetRow& row) {
+            after = readRow(row);
+        });
+        if (rows < batchSize) {
+            return;
+        }
+    }
+}
+
+#endif // KEYSET_SCAN_H
@@ -0,0 +1,97 @@
+#ifndef MAINTENANCE_SCHEDULER_H
+#define MAINTENANCE_SCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct MaintenanceConfig {
+    bool enabled = true;
+    int batchSize = 500;                    // rows per statement
+    int maxBatchesPerRun = 20;              // the rest waits for the next run
+    std::chrono::milliseconds batchPause{50}; // between batches, so other transactions get the rows' locks
+
+    // MAINTENANCE_ENABLED, MAINTENANCE_BATCH_SIZE, MAINTENANCE_MAX_BATCHES_PER_RUN, MAINTENANCE_BATCH_PAUSE_MS
+    static MaintenanceConfig fromEnvironment();
+};
+
+struct MaintenanceJobStats {
+    std::string name;
+    std::chrono::seconds interval{0};
+    std::uint64_t runs = 0;
+    std::uint64_t failures = 0;      // runs stopped by a failed batch
+    std::uint64_t truncatedRuns = 0; // runs that hit maxBatchesPerRun with rows left over
+    std::uint64_t batches = 0;
+    std::uint64_t rowsAffected = 0;
+    int lastRows = 0;
+    double lastDurationMs = 0.0;
+    double maxDurationMs = 0.0;
+    std::time_t lastRunAt = 0; // 0 until the first run
+};
+
+// Runs periodic cleanup jobs on one background thread. Jobs sit in a hashed timer wheel (one slot
+// per tick, with a round count for intervals longer than the wheel), so a tick only looks at the
+// jobs due in its slot. A run calls the job one batch at a time until a batch comes back short,
+// which keeps every statement small and its locks brief. Jobs run one after another, never
+// overlapping; ticks missed while a job runs are caught up afterwards.
+class MaintenanceScheduler {
+public:
+    // Processes at most limit rows; returns the rows changed, or -1 on failure
+    using BatchJob = std::function<int(int limit)>;
+
+    explicit MaintenanceScheduler(const MaintenanceConfig& config,
+                                  std::chrono::milliseconds tick = std::chrono::seconds(1),
+                                  std::size_t wheelSlots = 512);
+    ~MaintenanceScheduler();
+    MaintenanceScheduler(const MaintenanceScheduler&) = delete;
+    MaintenanceScheduler& operator=(const MaintenanceScheduler&) = delete;
+
+    static MaintenanceScheduler& instance();
+
+    // Jobs first run on the tick after start(), then every interval; an interval of 0 skips the job.
+    // Add them before start().
+    void addJob(const std::string& name, std::chrono::seconds interval, BatchJob job);
+    // No-op when disabled by the config or already running
+    void start();
+    // Finishes the current batch and joins the thread
+    void stop();
+    bool isRunning() const;
+    std::vector<MaintenanceJobStats> getJobStats() const;
+
+private:
+    struct Job {
+        BatchJob run;
+        std::uint64_t intervalTicks = 1;
+        MaintenanceJobStats stats;
+    };
+
+    struct WheelEntry {
+        std::size_t job;
+        std::uint64_t rounds; // full turns of the wheel left before the job is due
+    };
+
+    MaintenanceConfig config;
+    std::chrono::milliseconds tick;
+    std::vector<Job> jobs;
+    std::vector<std::vector<WheelEntry>> wheel;
+    std::size_t cursor = 0;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+
+    // Expects mutex held
+    void schedule(std::size_t job, std::uint64_t ticks);
+    void workerLoop();
+    void runJob(std::size_t job);
+};
+
+#endif // MAINTENANCE_SCHEDULER_H
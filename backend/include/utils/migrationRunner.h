@@ -0,0 +1,64 @@
+#ifndef MIGRATION_RUNNER_H
+#define MIGRATION_RUNNER_H
+
+#include "utils/dbConnection.h"
+#include <string>
+#include <vector>
+
+// One schema change. Statements must be safe to re-run (IF [NOT] EXISTS), because MariaDB commits
+// DDL implicitly and a migration interrupted part-way is retried from its first statement.
+struct Migration {
+    int version;
+    std::string description;
+    std::vector<std::string> statements;
+    // The code fails without it (not just runs slower), so the server will not start while it is pending
+    bool required = false;
+};
+
+struct AppliedMigration {
+    int version = 0;
+    std::string description;
+    std::string appliedAt;
+    long executionMs = 0;
+};
+
+// EXPLAIN of one hot query against the index it is meant to use
+struct IndexCheck {
+    std::string query;           // DAO method the SQL mirrors, e.g. "ReservationData::isTableAvailable"
+    std::string table;           // table or alias as EXPLAIN reports it
+    std::string expectedIndex;
+    std::string chosenIndex;     // EXPLAIN key; empty for a full scan
+    std::string possibleIndexes; // EXPLAIN possible_keys
+    std::string accessType;      // EXPLAIN type (const, ref, range, ALL, ...)
+    std::string extra;           // EXPLAIN Extra, e.g. "Using index" when the index covers the query
+
+    bool usesIndex() const { return chosenIndex == expectedIndex; }
+    // The optimizer may scan tiny tables even when the index exists, so only a missing candidate is a failure
+    bool indexAvailable() const;
+};
+
+// Applies the migrations compiled into the server, in version order, and records each one in
+// schema_migrations. A GET_LOCK advisory lock keeps two servers starting together from applying
+// the same migration twice. Failures are logged and reported through the return values.
+class MigrationRunner {
+public:
+    MigrationRunner();
+
+    static const std::vector<Migration>& migrations();
+
+    // Applies every pending migration; stops at the first failure. Returns false if any failed.
+    bool migrate();
+    std::vector<AppliedMigration> appliedMigrations();
+    // Known migrations not yet recorded as applied; empty if the database cannot be read
+    std::vector<Migration> pendingMigrations();
+
+    // EXPLAINs the reservation, table and token queries that run on every booking or request
+    std::vector<IndexCheck> checkIndexes();
+
+private:
+    DbConnection dbConnection{"MigrationRunner"};
+
+    void ensureVersionTable(PooledConnection& conn);
+};
+
+#endif // MIGRATION_RUNNER_H
@@ -0,0 +1,40 @@
+#ifndef PASSWORD_HASHER_H
+#define PASSWORD_HASHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// scrypt cost parameters. Memory per hash is about 128 * n * r bytes (32 MiB for the defaults),
+// so the hashing pool's thread count also bounds the memory logins can take.
+struct PasswordHashConfig {
+    std::uint64_t n = 1 << 15; // CPU/memory cost, a power of two
+    std::uint64_t r = 8;       // block size
+    std::uint64_t p = 3;       // parallelism; raises CPU cost without raising memory
+
+    // PASSWORD_SCRYPT_N, PASSWORD_SCRYPT_R, PASSWORD_SCRYPT_P
+    static PasswordHashConfig fromEnvironment();
+};
+
+struct PasswordCheck {
+    bool valid = false;
+    bool needsRehash = false; // valid, but stored in a legacy format or with other cost parameters
+};
+
+// Salted scrypt hashes through OpenSSL EVP, stored as "scrypt$<n>$<r>$<p>$<salt hex>$<hash hex>".
+// Also verifies the legacy unsalted SHA-256 hex hashes, reporting them for rehash.
+// CPU- and memory-heavy by design: call it from IoExecutor::hashing(), not from HTTP threads.
+class PasswordHasher {
+public:
+    explicit PasswordHasher(const PasswordHashConfig& config);
+
+    // Empty if the KDF fails (e.g. parameters beyond OpenSSL's limits)
+    std::string hash(const std::string& password) const;
+    PasswordCheck verify(const std::string& password, const std::string& stored) const;
+    const PasswordHashConfig& getConfig() const;
+
+private:
+    PasswordHashConfig config;
+};
+
+#endif // PASSWORD_HASHER_H
@@ -0,0 +1,91 @@
+#ifndef QUERY_STATS_H
+#define QUERY_STATS_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Latency histogram bucket upper bounds in milliseconds; the last bucket counts everything slower
+constexpr std::array<double, 11> queryLatencyBucketsMs = {1, 2, 5, 10, 25, 50, 100, 250, 500, 1000, 2500};
+
+struct StatementStats {
+    std::string caller;      // DAO method, e.g. "ReservationData::isTableAvailable"
+    std::string fingerprint; // normalised SQL
+    std::uint64_t calls = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t rows = 0;  // rows returned (SELECT) or affected (writes)
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+    std::array<std::uint64_t, queryLatencyBucketsMs.size() + 1> histogram{};
+
+    // Upper bound of the bucket holding the q-th quantile (0 < q <= 1); maxMs for the overflow bucket
+    double approximatePercentileMs(double q) const;
+};
+
+struct ConnectionAcquireStats {
+    std::string caller;
+    std::uint64_t borrows = 0;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+};
+
+struct SlowQueryEntry {
+    std::string caller;
+    std::string fingerprint;
+    std::string parameterShape; // e.g. "3 params" or "3 params x 80 rows" for array binds
+    double durationMs = 0.0;
+    long rows = 0;
+    bool failed = false;
+    std::string recordedAt;     // UTC, ISO 8601
+};
+
+// Process-wide per-statement timings for the data layer. Each (caller, fingerprint) pair gets
+// call/error/row counters and a latency histogram; statements slower than DB_SLOW_QUERY_MS also
+// go to a bounded slow-query log (DB_SLOW_QUERY_LOG_SIZE entries) and stderr. Counters are
+// sharded so concurrent DAO calls rarely contend on the same lock.
+class QueryStats {
+public:
+    QueryStats(std::chrono::milliseconds slowThreshold, std::size_t slowLogCapacity);
+    QueryStats(const QueryStats&) = delete;
+    QueryStats& operator=(const QueryStats&) = delete;
+
+    static QueryStats& instance();
+
+    // Collapses whitespace and IN (?, ?, ...) lists so batch sizes share one entry
+    static std::string fingerprint(const std::string& sql);
+
+    void recordStatement(const std::string& caller, const std::string& fingerprint, const std::string& parameterShape,
+                         double durationMs, long rows, bool failed);
+    void recordAcquire(const std::string& caller, double waitMs);
+
+    std::vector<StatementStats> getStatementStats() const;
+    std::vector<ConnectionAcquireStats> getAcquireStats() const;
+    std::vector<SlowQueryEntry> getSlowQueries() const; // newest first
+    std::chrono::milliseconds getSlowThreshold() const;
+    void reset();
+
+private:
+    static constexpr std::size_t shardCount = 16;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, StatementStats> statements;
+        std::unordered_map<std::string, ConnectionAcquireStats> acquisitions;
+    };
+
+    std::chrono::milliseconds slowThreshold;
+    std::size_t slowLogCapacity;
+    std::array<Shard, shardCount> shards;
+    mutable std::mutex slowLogMutex;
+    std::deque<SlowQueryEntry> slowLog;
+
+    Shard& shardFor(const std::string& key);
+};
+
+#endif // QUERY_STATS_H
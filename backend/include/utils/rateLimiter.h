@@ -0,0 +1,107 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Token bucket: up to `burst` requests at once, then one more every refillInterval
+struct RateLimitPolicy {
+    std::uint32_t burst = 10;
+    std::chrono::milliseconds refillInterval{6000};
+
+    // `requests` per `window`, all of them usable in a burst
+    static RateLimitPolicy perWindow(std::uint32_t requests, std::chrono::seconds window);
+    // "<requests>/<seconds>" from the environment, e.g. RATE_LIMIT_LOGIN_IP=20/60
+    static RateLimitPolicy fromEnvironment(const std::string& key, const RateLimitPolicy& fallback);
+};
+
+// One bucket per client IP and one per account (username, email or user id) for each route
+struct RouteRateLimits {
+    RateLimitPolicy perIp;
+    RateLimitPolicy perAccount;
+};
+
+struct RateLimitConfig {
+    bool enabled = true;
+    // Take the client IP from the first X-Forwarded-For entry; only behind a proxy that sets it
+    bool trustForwardedFor = false;
+    std::size_t maxBuckets = 100000;
+    RouteRateLimits login{RateLimitPolicy::perWindow(20, std::chrono::seconds(60)),
+                          RateLimitPolicy::perWindow(10, std::chrono::seconds(300))};
+    RouteRateLimits registration{RateLimitPolicy::perWindow(10, std::chrono::seconds(3600)),
+                                 RateLimitPolicy::perWindow(3, std::chrono::seconds(3600))};
+    RouteRateLimits resendConfirmation{RateLimitPolicy::perWindow(10, std::chrono::seconds(600)),
+                                       RateLimitPolicy::perWindow(3, std::chrono::seconds(600))};
+
+    // RATE_LIMIT_ENABLED, RATE_LIMIT_TRUST_FORWARDED_FOR, RATE_LIMIT_MAX_BUCKETS and
+    // RATE_LIMIT_{LOGIN,REGISTER,RESEND}_{IP,ACCOUNT}
+    static RateLimitConfig fromEnvironment();
+};
+
+struct RateLimitDecision {
+    bool allowed = true;
+    std::chrono::seconds retryAfter{0}; // until the next token, when not allowed
+};
+
+struct RateLimiterStats {
+    std::size_t buckets = 0;
+    std::uint64_t allowed = 0;
+    std::uint64_t limited = 0;
+    std::uint64_t evictions = 0; // idle buckets dropped to stay within maxBuckets
+    std::uint64_t untracked = 0; // requests let through because every bucket was busy
+};
+
+// Token buckets keyed by string, split across independently locked shards. A bucket's state (token
+// count and last refill time) is one 64-bit atomic updated by compare-and-swap, so requests only
+// take their shard's lock shared, to find the bucket; the exclusive lock is for adding one. A full
+// shard first drops buckets that have refilled completely, which are the same as no bucket at all.
+class RateLimiter {
+public:
+    explicit RateLimiter(std::size_t maxBuckets = 100000, std::size_t shards = 16);
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    // Takes a token from key's bucket, creating it full under policy on first use
+    RateLimitDecision acquire(const std::string& key, const RateLimitPolicy& policy);
+    RateLimiterStats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Bucket {
+        Bucket(std::uint64_t capacity, std::uint64_t refillMs, std::uint64_t state)
+            : capacity(capacity), refillMs(refillMs), state(state) {}
+        const std::uint64_t capacity; // millitokens
+        const std::uint64_t refillMs; // per token
+        std::atomic<std::uint64_t> state; // ms since start << 24 | millitokens
+    };
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
+        std::uint64_t lastSweepMs = 0; // guarded by mutex (exclusive)
+    };
+
+    Clock::time_point start;
+    std::size_t maxBucketsPerShard;
+    std::vector<Shard> shards;
+    std::atomic<std::uint64_t> allowed{0};
+    std::atomic<std::uint64_t> limited{0};
+    std::atomic<std::uint64_t> evictions{0};
+    std::atomic<std::uint64_t> untracked{0};
+
+    std::uint64_t nowMs() const;
+    Shard& shardFor(const std::string& key);
+    RateLimitDecision take(Bucket& bucket, std::uint64_t now);
+    // Expects shard.mutex held exclusively
+    void sweep(Shard& shard, std::uint64_t now);
+};
+
+#endif // RATE_LIMITER_H
@@ -0,0 +1,65 @@
+#ifndef REPLICA_ROUTER_H
+#define REPLICA_ROUTER_H
+
+#include "utils/connectionPool.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+struct ReplicaPolicy {
+    std::chrono::seconds maxLag{5};                  // replicas further behind are not used
+    std::chrono::milliseconds checkInterval{5000};   // how often health and lag are re-checked
+
+    // DB_REPLICA_MAX_LAG_SECONDS, DB_REPLICA_CHECK_INTERVAL_MS
+    static ReplicaPolicy fromEnvironment();
+};
+
+struct ReplicaStats {
+    bool configured = false;
+    bool healthy = false;
+    std::optional<long> lagSeconds; // last measured; empty if unknown or replication is stopped
+    std::uint64_t replicaReads = 0;
+    std::uint64_t primaryFallbacks = 0;
+    std::uint64_t checks = 0;
+    std::uint64_t checkFailures = 0;
+    ConnectionPoolStats pool;
+};
+
+// Hands out connections for read-only queries. They go to the replica pool while the replica is
+// reachable and no more than maxLag behind, and to the primary otherwise. Health is re-checked at
+// most once per checkInterval, by whichever reader arrives first, so routing costs no extra round
+// trip on the common path. Without a configured replica every read goes to the primary.
+class ReplicaRouter {
+public:
+    ReplicaRouter(ConnectionPool& primary, const std::optional<ConnectionPoolConfig>& replicaConfig,
+                  const ReplicaPolicy& policy);
+    ReplicaRouter(const ReplicaRouter&) = delete;
+    ReplicaRouter& operator=(const ReplicaRouter&) = delete;
+
+    PooledConnection acquireRead();
+    ReplicaStats getStats() const;
+    // ConnectionPool::evictIdle on the replica pool; 0 without a replica
+    std::size_t evictIdle();
+
+private:
+    ConnectionPool& primary;
+    std::unique_ptr<ConnectionPool> replica;
+    ReplicaPolicy policy;
+
+    mutable std::mutex mutex;
+    bool healthy;
+    bool checking;
+    std::chrono::steady_clock::time_point nextCheck;
+    ReplicaStats counters;
+
+    // Claims the pending health check if one is due; returns false if the replica should be skipped
+    bool shouldTryReplica(bool& runCheck);
+    void recordCheck(bool passed, std::optional<long> lagSeconds);
+    PooledConnection fallBackToPrimary();
+    // Seconds_Behind_Master from SHOW SLAVE STATUS; 0 when the server is not a replica at all
+    std::optional<long> measureLag(PooledConnection& conn);
+};
+
+#endif // REPLICA_ROUTER_H
@@ -0,0 +1,66 @@
+#ifndef ROWSET_FETCH_H
+#define ROWSET_FETCH_H
+
+#include <nanodbc/nanodbc.h>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Bound buffers of one result column; defined in rowsetFetch.cpp
+struct RowsetColumn;
+
+// One row of a block-cursor fetch. Columns are read by 0-based position in the SELECT list, with
+// the same conventions as nanodbc::result::get: get<T>(column) throws nanodbc::null_access_error
+// on NULL, get<T>(column, fallback) returns the fallback instead. Valid only inside the visit call.
+class RowsetRow {
+public:
+    RowsetRow(const std::vector<RowsetColumn>& columns, std::size_t row);
+
+    short columns() const;
+    bool isNull(short column) const;
+
+    template <class T>
+    T get(short column) const;
+
+    template <class T>
+    T get(short column, const T& fallback) const {
+        return isNull(column) ? fallback : get<T>(column);
+    }
+
+private:
+    const std::vector<RowsetColumn>* columnData;
+    std::size_t row;
+
+    const RowsetColumn& at(short column) const;
+};
+
+template <> int RowsetRow::get<int>(short column) const;
+template <> long long RowsetRow::get<long long>(short column) const;
+template <> bool RowsetRow::get<bool>(short column) const;
+template <> double RowsetRow::get<double>(short column) const;
+template <> float RowsetRow::get<float>(short column) const;
+template <> std::string RowsetRow::get<std::string>(short column) const;
+
+// Executes a statement prepared and bound through nanodbc, then reads its result with an ODBC block
+// cursor: each SQLFetch fills rowsetSize rows into column-wise bound arrays (integers as 64-bit,
+// FLOAT/DOUBLE as double, everything else as text), instead of one driver call per row plus a
+// by-name column lookup per value. Text buffers are sized from the column width but capped at
+// longColumnBytes; longer TEXT values are read in full with SQLSetPos + SQLGetData. The first block
+// is only a few rows, so single-row lookups and short lists do not allocate rowsetSize buffers.
+// nanodbc's own rowsets are not used because it applies the rowset size as the parameter-set size
+// too. The statement is closed and unbound afterwards, so the cached handle can be reused by
+// nanodbc. Returns the number of rows visited. Throws nanodbc::database_error.
+long fetchRowsets(nanodbc::statement& stmt, std::size_t rowsetSize, std::size_t longColumnBytes,
+                  const std::function<void(const RowsetRow&)>& visit);
+
+// fetchRowsets for a statement batch ("SELECT ...; SELECT ...") prepared as one statement: executes
+// it once and reads result set i with visitors[i], moving on with SQLMoreResults, so several
+// queries cost a single round trip on one connection. Statements without a result set (writes)
+// still take a visitor slot. Requires multi-statement support on the connection (MariaDB
+// Connector/ODBC MULTI_STATEMENTS=1). Throws nanodbc::database_error, also when the batch returns
+// fewer result sets than there are visitors.
+long fetchResultSets(nanodbc::statement& stmt, std::size_t rowsetSize, std::size_t longColumnBytes,
+                     const std::vector<std::function<void(const RowsetRow&)>>& visitors);
+
+#endif // ROWSET_FETCH_H
@@ -0,0 +1,58 @@
+#ifndef STATEMENT_CACHE_H
+#define STATEMENT_CACHE_H
+
+#include <nanodbc/nanodbc.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+// Shared by every cache in a pool so hit rates can be reported without touching borrowed connections
+struct StatementCacheCounters {
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+    std::atomic<std::uint64_t> evictions{0};
+};
+
+// LRU cache of prepared statements keyed by SQL text. Belongs to a single pooled connection,
+// so it is only ever used by the thread currently holding that connection. Statements handed out
+// during a borrow are pinned until unpinAll() (called when the connection goes back to the pool),
+// so a method that prepares more statements than the capacity never loses one it still holds;
+// the cache grows past capacity for that borrow instead and is trimmed on unpinAll().
+class StatementCache {
+public:
+    StatementCache(std::size_t capacity, StatementCacheCounters* counters);
+    StatementCache(const StatementCache&) = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    // Returns a statement prepared for sql on conn and pins it; parameters must be re-bound before executing
+    nanodbc::statement& prepare(nanodbc::connection& conn, const std::string& sql);
+    // Ends the borrow: every statement becomes evictable again and the cache shrinks to capacity
+    void unpinAll();
+    // QueryStats fingerprint of a statement returned by prepare(), computed once when it was
+    // prepared; nullptr for statements this cache does not own
+    const std::string* fingerprintOf(const nanodbc::statement& stmt) const;
+    void clear();
+    std::size_t size() const;
+
+private:
+    struct Entry {
+        std::string sql;
+        std::string fingerprint;
+        nanodbc::statement statement;
+        bool pinned = true;
+    };
+
+    std::size_t capacity;
+    StatementCacheCounters* counters;
+    std::list<Entry> entries; // most recently used at the front
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    std::unordered_map<const nanodbc::statement*, std::list<Entry>::iterator> byStatement;
+
+    // Drops the least recently used unpinned entry; false if every entry is pinned
+    bool evictOne();
+};
+
+#endif // STATEMENT_CACHE_H
@@ -0,0 +1,26 @@
+#ifndef STRIPED_MUTEX_H
+#define STRIPED_MUTEX_H
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Fixed set of mutexes selected by key hash. Serialises work on the same key (e.g. one
+// restaurant table) without a lock per key and without blocking unrelated keys.
+class StripedMutex {
+public:
+    explicit StripedMutex(std::size_t stripes = 64) : locks(stripes == 0 ? 1 : stripes) {}
+    StripedMutex(const StripedMutex&) = delete;
+    StripedMutex& operator=(const StripedMutex&) = delete;
+
+    template <typename Key>
+    std::mutex& forKey(const Key& key) {
+        return locks[std::hash<Key>{}(key) % locks.size()];
+    }
+
+private:
+    std::vector<std::mutex> locks;
+};
+
+#endif // STRIPED_MUTEX_H
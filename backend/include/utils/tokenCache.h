@@ -0,0 +1,79 @@
+#ifndef TOKEN_CACHE_H
+#define TOKEN_CACHE_H
+
+#include "models/authSession.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct TokenCacheConfig {
+    std::chrono::seconds ttl{60};  // longest a session is trusted without asking the database again
+    std::size_t maxEntries = 10000;
+    std::size_t shards = 16;
+
+    // AUTH_CACHE_TTL_SECONDS, AUTH_CACHE_MAX_ENTRIES; a TTL of 0 disables the cache
+    static TokenCacheConfig fromEnvironment();
+};
+
+struct TokenCacheStats {
+    std::size_t entries = 0;
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t expirations = 0;   // entries found past their TTL or token expiry
+    std::uint64_t invalidations = 0; // entries dropped by logout or a role/status change
+    std::uint64_t evictions = 0;     // entries dropped to stay within maxEntries
+};
+
+// Token -> AuthSession map split into independently locked shards, so concurrent requests with
+// different tokens rarely contend. Each entry expires at the earlier of the configured TTL and the
+// token's own expiry; the TTL bounds how long a change made outside AuthService (another server,
+// a manual UPDATE) can go unnoticed.
+class TokenCache {
+public:
+    explicit TokenCache(const TokenCacheConfig& config);
+    TokenCache(const TokenCache&) = delete;
+    TokenCache& operator=(const TokenCache&) = delete;
+
+    bool isEnabled() const;
+    std::optional<AuthSession> find(const std::string& token);
+    // tokenExpiresIn is the token's remaining lifetime, if it has one
+    void put(const std::string& token, const AuthSession& session, std::optional<std::chrono::seconds> tokenExpiresIn);
+    void erase(const std::string& token);
+    // Drops every cached session of userId; a scan of all shards, which is fine for admin actions
+    void eraseUser(int userId);
+    TokenCacheStats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        AuthSession session;
+        Clock::time_point expiresAt;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, Entry> entries;
+    };
+
+    TokenCacheConfig config;
+    std::size_t maxEntriesPerShard;
+    std::vector<Shard> shards;
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+    std::atomic<std::uint64_t> expirations{0};
+    std::atomic<std::uint64_t> invalidations{0};
+    std::atomic<std::uint64_t> evictions{0};
+
+    Shard& shardFor(const std::string& token);
+    // Makes room for one more entry; expired entries go first. Caller holds shard.mutex.
+    void evictLocked(Shard& shard, Clock::time_point now);
+};
+
+#endif // TOKEN_CACHE_H
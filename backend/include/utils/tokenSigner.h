@@ -0,0 +1,95 @@
+#ifndef TOKEN_SIGNER_H
+#define TOKEN_SIGNER_H
+
+#include "models/permission.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// What a signed access token asserts
+struct TokenClaims {
+    int userId = -1;
+    int roleId = 0;
+    PermissionSet permissions;
+    bool isAdmin = false;
+    std::int64_t issuedAt = 0;  // Unix milliseconds, so a cut-off does not catch tokens issued later in its second
+    std::int64_t expiresAt = 0; // Unix seconds
+    std::string id; // random, hex; what logout revokes
+};
+
+struct SigningKey {
+    std::string id;     // travels in the token so verification can pick the key
+    std::string secret; // at least TokenSignerConfig::minSecretLength bytes
+};
+
+struct TokenSignerConfig {
+    static constexpr std::size_t minSecretLength = 32;
+
+    bool enabled = false;
+    std::vector<SigningKey> keys; // the first key signs; all of them verify
+    std::chrono::seconds lifetime{24 * 60 * 60};
+
+    // AUTH_TOKEN_FORMAT=signed enables it; AUTH_SIGNING_KEYS is "id:secret,id:secret,...",
+    // newest first; AUTH_SIGNED_TOKEN_TTL_SECONDS sets the lifetime. Keys with short secrets are
+    // skipped, and without a usable key signed tokens stay disabled.
+    static TokenSignerConfig fromEnvironment();
+};
+
+// Self-contained access tokens: "v1.<key id>.<claims>.<HMAC-SHA256>", base64url. Verifying one
+// needs only the keys, never the database. To rotate, put a new key first in AUTH_SIGNING_KEYS
+// and drop the old one once every token it signed has expired.
+class TokenSigner {
+public:
+    explicit TokenSigner(const TokenSignerConfig& config);
+
+    bool isEnabled() const;
+    std::chrono::seconds getLifetime() const;
+    const std::string& activeKeyId() const;
+    // Whether token is in the signed format at all (opaque tokens never are)
+    static bool isSignedToken(const std::string& token);
+
+    std::string sign(const TokenClaims& claims) const;
+    // Claims of a token signed by a configured key and not yet expired
+    std::optional<TokenClaims> verify(const std::string& token) const;
+
+private:
+    TokenSignerConfig config;
+};
+
+// Signed tokens cannot be deleted, so logout and role/status changes are recorded here instead:
+// revoked token ids, kept only until the token would have expired anyway, and per-user cut-offs
+// that reject every token issued before them. In-process only; a restart forgets them, so
+// rotating the signing keys is the way to invalidate everything at once.
+class TokenRevocations {
+public:
+    // Cut-offs are dropped once every token they could reject has expired
+    explicit TokenRevocations(std::chrono::seconds tokenLifetime);
+
+    void revoke(const TokenClaims& claims);
+    // Rejects userId's tokens issued at or before the current millisecond
+    void revokeUser(int userId);
+    bool isRevoked(const TokenClaims& claims) const;
+    std::size_t size() const;
+
+private:
+    // Expired entries are swept at most this often, so a burst of logouts does not rescan both
+    // maps under the exclusive lock each time while signed-token requests wait on isRevoked
+    static constexpr std::int64_t pruneIntervalSeconds = 60;
+
+    std::int64_t tokenLifetime;
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::uint64_t, std::int64_t> revokedIds; // id prefix -> token expiry (s)
+    std::unordered_map<int, std::int64_t> userCutoffs;         // userId -> issued-at cut-off (ms)
+    std::int64_t lastPrune = 0;
+
+    static std::uint64_t compactId(const std::string& id);
+    // Sweeps expired entries if pruneIntervalSeconds have passed since the last sweep
+    void pruneLocked(std::int64_t now);
+};
+
+#endif // TOKEN_SIGNER_H
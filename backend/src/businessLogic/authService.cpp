@@ -1,27 +1,34 @@
 #include "businessLogic/authService.h"
-#include <openssl/sha.h>
 #include <openssl/rand.h>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <chrono>
 #include <ctime>
 
-AuthService::AuthService() {}
+namespace {
 
-std::string AuthService::hashPassword(const std::string& password) {
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256_CTX sha256;
-    SHA256_Init(&sha256);
-    SHA256_Update(&sha256, password.c_str(), password.size());
-    SHA256_Final(hash, &sha256);
+const std::chrono::hours loginTokenLifetime(24);
 
-    std::stringstream ss;
-    for(int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
-    }
-    return ss.str();
+AuthSession sessionFor(const User& user) {
+    AuthSession session;
+    session.userId = user.getId();
+    session.roleId = user.getRoleId();
+    session.roleName = user.getRoleName();
+    session.permissions = user.getPermissions();
+    session.isAdmin = user.isAdmin();
+    return session;
 }
 
+} // namespace
+
+AuthService::AuthService()
+    : userData(Storage::instance().users()), tokenData(Storage::instance().tokens()),
+      sessionCache(TokenCacheConfig::fromEnvironment()),
+      tokenSigner(TokenSignerConfig::fromEnvironment()),
+      revokedTokens(tokenSigner.getLifetime()),
+      passwordHasher(PasswordHashConfig::fromEnvironment()) {}
+
 std::string AuthService::generateToken(int userId) {
     unsigned char random[16];
     RAND_bytes(random, sizeof(random));
@@ -38,23 +45,42 @@ std::string AuthService::generateToken(int userId) {
     return ss.str();
 }
 
-bool AuthService::registerUser(const std::string& username, const std::string& email, const std::string& password, 
-                               const std::string& firstName, const std::string& lastName) {
-    if (!isPasswordStrong(password)) {
-        return false;
+std::string AuthService::generateSignedToken(const User& user) {
+    unsigned char random[16];
+    RAND_bytes(random, sizeof(random));
+
+    std::stringstream id;
+    for (int i = 0; i < sizeof(random); i++) {
+        id << std::hex << std::setw(2) << std::setfill('0') << (int)random[i];
     }
-    
-    auto existingUsername = userData.getUserByUsername(username);
-    auto existingEmail = userData.getUserByEmail(email);
 
-    if (existingUsername || existingEmail) {
-        return false;
+    TokenClaims claims;
+    claims.userId = user.getId();
+    claims.roleId = user.getRoleId();
+    claims.permissions = user.getPermissions();
+    claims.isAdmin = user.isAdmin();
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    claims.issuedAt = std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+    claims.expiresAt = std::chrono::duration_cast<std::chrono::seconds>(now).count() + tokenSigner.getLifetime().count();
+    claims.id = id.str();
+    return tokenSigner.sign(claims);
+}
+
+std::optional<std::string> AuthService::registerUser(const std::string& username, const std::string& email, const std::string& password, 
+                                                     const std::string& firstName, const std::string& lastName) {
+    if (!isPasswordStrong(password)) {
+        return std::nullopt;
     }
 
     User newUser;
     newUser.setUsername(username);
     newUser.setEmail(email);
-    newUser.setPasswordHash(hashPassword(password));
+    std::string passwordHash = passwordHasher.hash(password);
+    if (passwordHash.empty()) {
+        std::cerr << "Password hashing failed; check PASSWORD_SCRYPT_*" << std::endl;
+        return std::nullopt;
+    }
+    newUser.setPasswordHash(passwordHash);
     newUser.setFirstName(firstName);
     newUser.setLastName(lastName);
     newUser.setEmailVerified(false);
@@ -66,123 +92,128 @@ bool AuthService::registerUser(const std::string& username, const std::string& e
     std::time_t expires = now + (24 * 60 * 60);
     newUser.setEmailVerificationExpires(std::to_string(expires));
 
-    return userData.addUser(newUser);
-}
-
-std::string AuthService::loginUser(const std::string& username, const std::string& password) {
-    if (!userData.validateUser(username, hashPassword(password))) {
-        return "";
+    if (!userData.addUser(newUser)) {
+        return std::nullopt;
     }
+    return verificationToken;
+}
 
+LoginResult AuthService::loginUser(const std::string& username, const std::string& password) {
+    LoginResult result;
     auto user = userData.getUserByUsername(username);
     if (!user) {
-        return "";
+        return result;
+    }
+
+    if (!user->isActive()) {
+        std::cerr << "Login attempt for inactive user: " << username << std::endl;
+        return result;
+    }
+
+    PasswordCheck check = passwordHasher.verify(password, user->getPasswordHash());
+    if (!check.valid) {
+        return result;
+    }
+
+    if (check.needsRehash) {
+        // Legacy or outdated hash: upgrade it now that the plaintext is at hand. A failure
+        // leaves the old hash, which still verifies, and is retried on the next login.
+        std::string upgraded = passwordHasher.hash(password);
+        if (!upgraded.empty()) {
+            userData.updatePasswordHash(user->getId(), upgraded);
+        }
     }
     
     if (!user->isEmailVerified()) {
-        return "EMAIL_NOT_VERIFIED";
+        result.status = LoginStatus::EmailNotVerified;
+        return result;
+    }
+
+    if (tokenSigner.isEnabled()) {
+        result.token = generateSignedToken(*user);
+    } else {
+        result.token = generateToken(user->getId());
+        if (!tokenData.storeToken(result.token, user->getId(), loginTokenLifetime)) {
+            result.status = LoginStatus::Failed;
+            result.token.clear();
+            return result;
+        }
+        sessionCache.put(result.token, sessionFor(*user), loginTokenLifetime);
+    }
+
+    result.status = LoginStatus::Success;
+    result.user = std::move(user);
+    return result;
+}
+
+std::optional<AuthSession> AuthService::authenticate(const std::string& token) {
+    if (TokenSigner::isSignedToken(token)) {
+        auto claims = tokenSigner.verify(token);
+        if (!claims || revokedTokens.isRevoked(*claims)) {
+            return std::nullopt;
+        }
+        AuthSession session;
+        session.userId = claims->userId;
+        session.roleId = claims->roleId;
+        session.permissions = claims->permissions;
+        session.isAdmin = claims->isAdmin;
+        return session;
     }
 
-    std::string token = generateToken(user->getId());
+    if (auto cached = sessionCache.find(token)) {
+        return cached;
+    }
 
-    if (!storeTokenInDatabase(token, user->getId())) {
-        return "";
+    auto active = tokenData.getActiveToken(token);
+    if (!active) {
+        return std::nullopt;
+    }
+    auto user = userData.getUserById(active->userId);
+    if (!user || !user->isActive()) {
+        return std::nullopt;
     }
 
-    return token;
+    AuthSession session = sessionFor(*user);
+    sessionCache.put(token, session, active->expiresIn);
+    return session;
 }
 
 bool AuthService::validateToken(const std::string& token) {
-    return validateTokenInDatabase(token);
+    return authenticate(token).has_value();
 }
 
 int AuthService::getUserIdFromToken(const std::string& token) {
-    return getUserIdFromTokenInDatabase(token);
+    auto session = authenticate(token);
+    return session ? session->userId : -1;
 }
 
 void AuthService::logoutUser(const std::string& token) {
-    removeTokenFromDatabase(token);
-}
-
-bool AuthService::storeTokenInDatabase(const std::string& token, int userId) {
-    try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-
-        nanodbc::prepare(stmt, "INSERT INTO user_tokens (token, user_id, expires_at) VALUES (?, ?, DATE_ADD(NOW(), INTERVAL 24 HOUR))");
-
-        stmt.bind(0, token.c_str());
-        stmt.bind(1, &userId);
-
-        nanodbc::execute(stmt);
-        return true;
-    } catch (const nanodbc::database_error& e) {
-        std::cerr << "Database error storing token: " << e.what() << std::endl;
-        return false;
-    }
-}
-
-bool AuthService::validateTokenInDatabase(const std::string& token) {
-    try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT COUNT(*) FROM user_tokens WHERE token = ? AND is_active = TRUE AND (expires_at IS NULL OR expires_at > NOW())");
-
-        stmt.bind(0, token.c_str());
-        nanodbc::result result = nanodbc::execute(stmt);
-
-        if (result.next()) {
-            return result.get<int>(0) > 0;
+    if (TokenSigner::isSignedToken(token)) {
+        if (auto claims = tokenSigner.verify(token)) {
+            revokedTokens.revoke(*claims);
         }
-        return false;
-    } catch (const nanodbc::database_error& e) {
-        std::cerr << "Database error validating token: " << e.what() << std::endl;
-        return false;
+        return;
     }
+    tokenData.revokeToken(token);
+    sessionCache.erase(token);
 }
 
-int AuthService::getUserIdFromTokenInDatabase(const std::string& token) {
-    try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT user_id FROM user_tokens WHERE token = ? AND is_active = TRUE AND (expires_at IS NULL OR expires_at > NOW())");
-
-        stmt.bind(0, token.c_str());
-        nanodbc::result result = nanodbc::execute(stmt);
-
-        if (result.next()) {
-            return result.get<int>("user_id");
-        }
-        return -1;
-    } catch (const nanodbc::database_error& e) {
-        std::cerr << "Database error getting user ID from token: " << e.what() << std::endl;
-        return -1;
-    }
+void AuthService::invalidateUser(int userId) {
+    sessionCache.eraseUser(userId);
+    // Signed tokens carry the old role and status until they expire, so they are cut off instead
+    revokedTokens.revokeUser(userId);
 }
 
-void AuthService::removeTokenFromDatabase(const std::string& token) {
-    try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE user_tokens SET is_active = FALSE WHERE token = ?");
-
-        stmt.bind(0, token.c_str());
-        nanodbc::execute(stmt);
-    } catch (const nanodbc::database_error& e) {
-        std::cerr << "Database error removing token: " << e.what() << std::endl;
-    }
+SignedTokenStats AuthService::getSignedTokenStats() const {
+    SignedTokenStats stats;
+    stats.enabled = tokenSigner.isEnabled();
+    stats.activeKeyId = tokenSigner.activeKeyId();
+    stats.revocations = revokedTokens.size();
+    return stats;
 }
 
-void AuthService::cleanupExpiredTokens() {
-    try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "DELETE FROM user_tokens WHERE expires_at IS NOT NULL AND expires_at < NOW()");
-
-        nanodbc::execute(stmt);
-    } catch (const nanodbc::database_error& e) {
-        std::cerr << "Database error cleaning up expired tokens: " << e.what() << std::endl;
-    }
+TokenCacheStats AuthService::getSessionCacheStats() const {
+    return sessionCache.getStats();
 }
 
 bool AuthService::isPasswordStrong(const std::string& password) {
@@ -239,32 +270,5 @@ std::string AuthService::generateEmailVerificationToken() {
 }
 
 bool AuthService::verifyEmailToken(const std::string& token) {
-    try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-
-        nanodbc::prepare(stmt, 
-            "SELECT id FROM users WHERE email_verification_token = ? AND email_verification_expires > NOW() AND email_verified = 0");
-        
-        stmt.bind(0, token.c_str());
-        auto result = nanodbc::execute(stmt);
-
-        if (result.next()) {
-            int userId = result.get<int>(0);
-            
-            nanodbc::statement updateStmt(conn);
-            nanodbc::prepare(updateStmt,
-                "UPDATE users SET email_verified = 1, email_verification_token = NULL, email_verification_expires = NULL WHERE id = ?");
-            
-            updateStmt.bind(0, &userId);
-            nanodbc::execute(updateStmt);
-            
-            return true;
-        }
-        
-        return false;
-    } catch (const std::exception& e) {
-        std::cerr << "Error verifying email token: " << e.what() << std::endl;
-        return false;
-    }
+    return userData.verifyEmailToken(token);
 }
@@ -0,0 +1,197 @@
+#include "businessLogic/exportService.h"
+#include "utils/envLoader.h"
+#include <atomic>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+
+using json = nlohmann::json;
+
+namespace {
+
+std::atomic<unsigned long> exportSequence{0};
+
+std::string timestampForFileName() {
+    std::time_t now = std::time(nullptr);
+    std::tm utc{};
+    gmtime_r(&now, &utc);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y%m%d-%H%M%S", &utc);
+    return buffer;
+}
+
+json reservationToJson(const Reservation& reservation) {
+    json row;
+    row["id"] = reservation.getId();
+    row["userId"] = reservation.getUserId();
+    row["tableId"] = reservation.getTableId();
+    row["restaurantId"] = reservation.getRestaurantId();
+    row["restaurantName"] = reservation.getRestaurantName();
+    row["customerName"] = reservation.getCustomerName();
+    row["date"] = reservation.getDate();
+    row["startTime"] = reservation.getStartTime();
+    row["endTime"] = reservation.getEndTime();
+    row["guestCount"] = reservation.getGuestCount();
+    row["status"] = reservation.getStatus();
+    row["phoneNumber"] = reservation.getPhoneNumber();
+    row["email"] = reservation.getEmail();
+    row["specialRequests"] = reservation.getSpecialRequests();
+    row["totalAmount"] = reservation.getTotalAmount();
+    row["paymentStatus"] = reservation.getPaymentStatus();
+    row["paymentMethod"] = reservation.getPaymentMethod();
+    return row;
+}
+
+// Password hashes and verification tokens are deliberately left out
+json userToJson(const User& user) {
+    json row;
+    row["id"] = user.getId();
+    row["username"] = user.getUsername();
+    row["email"] = user.getEmail();
+    row["roleId"] = user.getRoleId();
+    row["roleName"] = user.getRoleName();
+    row["firstName"] = user.getFirstName();
+    row["lastName"] = user.getLastName();
+    row["phoneNumber"] = user.getPhoneNumber();
+    row["isActive"] = user.isActive();
+    row["createdAt"] = user.getCreatedAt();
+    return row;
+}
+
+json reviewToJson(const Review& review) {
+    json row;
+    row["id"] = review.getId();
+    row["userId"] = review.getUserId();
+    row["restaurantId"] = review.getRestaurantId();
+    row["rating"] = review.getRating();
+    row["comment"] = review.getComment();
+    return row;
+}
+
+json auditLogEntryToJson(const AuditLogEntry& entry) {
+    json row;
+    row["id"] = entry.getId();
+    row["adminUserId"] = entry.getAdminUserId();
+    row["adminUsername"] = entry.getAdminUsername();
+    row["action"] = entry.getAction();
+    row["targetType"] = entry.getTargetType();
+    row["targetId"] = entry.getTargetId() > 0 ? json(entry.getTargetId()) : json(nullptr);
+    row["details"] = entry.getDetails();
+    row["ipAddress"] = entry.getIpAddress();
+    row["createdAt"] = entry.getCreatedAt();
+    return row;
+}
+
+} // namespace
+
+ExportService::ExportService()
+    : reservationData(Storage::instance().reservations()),
+      userData(Storage::instance().users()),
+      reviewData(Storage::instance().reviews()),
+      batchSize(static_cast<int>(EnvLoader::getEnvSize("EXPORT_BATCH_SIZE", 1000))),
+      retention(static_cast<int>(EnvLoader::getEnvSize("EXPORT_RETENTION_MINUTES", 15))) {
+    if (batchSize < 1) {
+        batchSize = 1000;
+    }
+    std::string directory = EnvLoader::getEnv("EXPORT_DIR");
+    if (!directory.empty()) {
+        spoolDirectory = directory;
+    } else {
+        std::error_code error;
+        spoolDirectory = std::filesystem::temp_directory_path(error) / "bookbite-exports";
+    }
+}
+
+bool ExportService::isKnownDataset(const std::string& dataset) {
+    return dataset == "reservations" || dataset == "users" || dataset == "reviews" || dataset == "audit-log";
+}
+
+std::optional<ExportFile> ExportService::exportDataset(const std::string& dataset, ExportFormat format) {
+    if (!isKnownDataset(dataset)) {
+        return std::nullopt;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(spoolDirectory, error);
+    if (error) {
+        std::cerr << "Export error: cannot create " << spoolDirectory << ": " << error.message() << std::endl;
+        return std::nullopt;
+    }
+    removeStaleFiles();
+
+    ExportFile file;
+    file.fileName = dataset + "-" + timestampForFileName() + "." + exportFormatExtension(format);
+    file.contentType = exportFormatContentType(format);
+    file.path = (spoolDirectory / (std::to_string(++exportSequence) + "-" + file.fileName)).string();
+
+    // Written under a temporary name so a failed export never looks complete
+    std::string partialPath = file.path + ".part";
+    bool written = false;
+    {
+        std::ofstream out(partialPath, std::ios::binary | std::ios::trunc);
+        if (out) {
+            written = writeDataset(dataset, format, out, file.rows);
+            out.flush();
+            written = written && out.good();
+        }
+    }
+
+    if (written) {
+        std::filesystem::rename(partialPath, file.path, error);
+        written = !error;
+    }
+    if (!written) {
+        std::cerr << "Export error: " << dataset << " export failed after " << file.rows << " rows" << std::endl;
+        std::filesystem::remove(partialPath, error);
+        return std::nullopt;
+    }
+    return file;
+}
+
+bool ExportService::writeDataset(const std::string& dataset, ExportFormat format, std::ostream& out, std::size_t& rows) {
+    bool success = false;
+    if (dataset == "reservations") {
+        ExportWriter writer(out, format, {"id", "userId", "tableId", "restaurantId", "restaurantName", "customerName",
+                                          "date", "startTime", "endTime", "guestCount", "status", "phoneNumber", "email",
+                                          "specialRequests", "totalAmount", "paymentStatus", "paymentMethod"});
+        success = reservationData.forEachReservation([&writer](const Reservation& reservation) {
+            writer.writeRow(reservationToJson(reservation));
+        }, batchSize);
+        rows = writer.getRowCount();
+    } else if (dataset == "users") {
+        ExportWriter writer(out, format, {"id", "username", "email", "roleId", "roleName", "firstName", "lastName",
+                                          "phoneNumber", "isActive", "createdAt"});
+        success = userData.forEachUser([&writer](const User& user) {
+            writer.writeRow(userToJson(user));
+        }, batchSize);
+        rows = writer.getRowCount();
+    } else if (dataset == "reviews") {
+        ExportWriter writer(out, format, {"id", "userId", "restaurantId", "rating", "comment"});
+        success = reviewData.forEachReview([&writer](const Review& review) {
+            writer.writeRow(reviewToJson(review));
+        }, batchSize);
+        rows = writer.getRowCount();
+    } else if (dataset == "audit-log") {
+        ExportWriter writer(out, format, {"id", "adminUserId", "adminUsername", "action", "targetType", "targetId",
+                                          "details", "ipAddress", "createdAt"});
+        success = userData.forEachAuditLogEntry([&writer](const AuditLogEntry& entry) {
+            writer.writeRow(auditLogEntryToJson(entry));
+        }, batchSize);
+        rows = writer.getRowCount();
+    }
+    return success;
+}
+
+void ExportService::removeStaleFiles() {
+    // Files are only deleted once they are old enough that any download of them has finished
+    // (an already-open file stays readable after unlink anyway)
+    auto cutoff = std::filesystem::file_time_type::clock::now() - retention;
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(spoolDirectory, error), end; !error && it != end; it.increment(error)) {
+        std::error_code entryError;
+        if (it->is_regular_file(entryError) && it->last_write_time(entryError) < cutoff && !entryError) {
+            std::filesystem::remove(it->path(), entryError);
+        }
+    }
+}
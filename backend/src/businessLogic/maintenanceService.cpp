@@ -0,0 +1,52 @@
+#include "businessLogic/maintenanceService.h"
+#include "utils/dbContext.h"
+#include "utils/envLoader.h"
+
+MaintenanceJobConfig MaintenanceJobConfig::fromEnvironment() {
+    MaintenanceJobConfig config;
+    auto seconds = [](const char* key, std::chrono::seconds fallback) {
+        return std::chrono::seconds(EnvLoader::getEnvSize(key, static_cast<std::size_t>(fallback.count())));
+    };
+    config.tokenInterval = seconds("MAINTENANCE_TOKEN_INTERVAL_SECONDS", config.tokenInterval);
+    config.reservationInterval = seconds("MAINTENANCE_RESERVATION_INTERVAL_SECONDS", config.reservationInterval);
+    config.verificationInterval = seconds("MAINTENANCE_VERIFICATION_INTERVAL_SECONDS", config.verificationInterval);
+    config.poolInterval = seconds("MAINTENANCE_POOL_INTERVAL_SECONDS", config.poolInterval);
+    config.pendingReservationHold = std::chrono::minutes(EnvLoader::getEnvSize(
+        "PENDING_RESERVATION_HOLD_MINUTES", static_cast<std::size_t>(config.pendingReservationHold.count())));
+    return config;
+}
+
+MaintenanceService::MaintenanceService()
+    : config(MaintenanceJobConfig::fromEnvironment()),
+      tokenData(Storage::instance().tokens()),
+      reservationData(Storage::instance().reservations()),
+      userData(Storage::instance().users()) {}
+
+void MaintenanceService::registerJobs(MaintenanceScheduler& scheduler) {
+    scheduler.addJob("expiredTokens", config.tokenInterval,
+                     [this](int limit) { return deleteExpiredTokens(limit); });
+    scheduler.addJob("pendingReservations", config.reservationInterval,
+                     [this](int limit) { return expirePendingReservations(limit); });
+    scheduler.addJob("emailVerifications", config.verificationInterval,
+                     [this](int limit) { return clearExpiredVerificationTokens(limit); });
+    if (Storage::usesDatabase(Storage::instance().backend())) {
+        // Not a batch job: one pass over the idle lists, so the limit does not apply
+        scheduler.addJob("idleConnections", config.poolInterval, [this](int) { return evictIdleConnections(); });
+    }
+}
+
+int MaintenanceService::deleteExpiredTokens(int limit) {
+    return tokenData.deleteExpiredTokens(limit);
+}
+
+int MaintenanceService::expirePendingReservations(int limit) {
+    return reservationData.expirePendingReservations(config.pendingReservationHold, limit);
+}
+
+int MaintenanceService::clearExpiredVerificationTokens(int limit) {
+    return userData.clearExpiredVerificationTokens(limit);
+}
+
+int MaintenanceService::evictIdleConnections() {
+    return static_cast<int>(DbContext::instance().evictIdleConnections());
+}
@@ -1,12 +1,20 @@
 #include "businessLogic/reservationService.h"
 #include <iostream>
 
-ReservationService::ReservationService() {}
+ReservationService::ReservationService()
+    : reservationData(Storage::instance().reservations()),
+      tableData(Storage::instance().tables()),
+      userData(Storage::instance().users()),
+      restaurantData(Storage::instance().restaurants()) {}
 
 std::vector<Reservation> ReservationService::getAllReservations() {
     return reservationData.getAllReservations();
 }
 
+Page<Reservation> ReservationService::getAllReservations(const PageRequest& pageRequest) {
+    return reservationData.getAllReservations(pageRequest);
+}
+
 std::vector<Reservation> ReservationService::getReservationsByUserId(int userId) {
     return reservationData.getReservationsByUserId(userId);
 }
@@ -19,59 +27,58 @@ std::optional<Reservation> ReservationService::getReservationById(int id) {
     return reservationData.getReservationById(id);
 }
 
-bool ReservationService::createReservation(const Reservation& reservation) {
-    auto table = tableData.getTableById(reservation.getTableId());
-    if (!table) {
-        return false;
+std::unordered_map<int, User> ReservationService::getUsersForReservations(const std::vector<Reservation>& reservations) {
+    std::vector<int> userIds;
+    userIds.reserve(reservations.size());
+    for (const auto& reservation : reservations) {
+        userIds.push_back(reservation.getUserId());
     }
+    return userData.getUsersByIds(userIds);
+}
 
-    if (!reservationData.isTableAvailable(reservation.getTableId(),
-                                          reservation.getDate(),
-                                          reservation.getStartTime(),
-                                          reservation.getEndTime())) {
-        return false;
+std::unordered_map<int, Restaurant> ReservationService::getRestaurantsForReservations(const std::vector<Reservation>& reservations) {
+    std::vector<int> restaurantIds;
+    restaurantIds.reserve(reservations.size());
+    for (const auto& reservation : reservations) {
+        restaurantIds.push_back(reservation.getRestaurantId());
     }
+    return restaurantData.getRestaurantsByIds(restaurantIds);
+}
 
+std::optional<int> ReservationService::createReservation(const Reservation& reservation) {
     Reservation pendingReservation = reservation;
     pendingReservation.setStatus("pending");
     
     std::string confirmationToken = emailService.generateConfirmationToken();
     pendingReservation.setConfirmationToken(confirmationToken);
 
-    bool success = reservationData.addReservation(pendingReservation);
+    // That the table exists in this restaurant and the slot is free are checked by the insert
+    // itself, under the table row lock
+    auto booked = reservationData.addReservationIfAvailable(pendingReservation);
+    if (!booked) {
+        return std::nullopt;
+    }
     
-    if (success) {
-        auto createdReservation = reservationData.getReservationByConfirmationToken(confirmationToken);
-        if (createdReservation) {
-            auto user = userData.getUserById(reservation.getUserId());
-            auto restaurant = restaurantData.getRestaurantById(reservation.getRestaurantId());
-            
-            if (user && restaurant) {
-                std::string customerName = user->getFirstName() + " " + user->getLastName();
-                if (customerName.empty() || customerName == " ") {
-                    customerName = user->getUsername();
-                }
-                
-                std::string timeSlot = reservation.getStartTime() + " - " + reservation.getEndTime();
-                
-                emailService.sendReservationConfirmation(
-                    reservation.getEmail().empty() ? user->getEmail() : reservation.getEmail(),
-                    customerName,
-                    restaurant->getName(),
-                    reservation.getDate(),
-                    timeSlot,
-                    reservation.getGuestCount(),
-                    confirmationToken,
-                    createdReservation->getId()
-                );
-                
-                std::cout << "Reservation created with ID: " << createdReservation->getId() 
-                         << ", confirmation email sent to: " << (reservation.getEmail().empty() ? user->getEmail() : reservation.getEmail()) << std::endl;
-            }
-        }
+    int reservationId = booked->getId();
+    std::string toEmail = booked->getEmail();
+    std::string customerName = booked->getCustomerName();
+    std::string restaurantName = booked->getRestaurantName();
+    
+    if (!customerName.empty() && !restaurantName.empty()) {
+        std::string timeSlot = reservation.getStartTime() + " - " + reservation.getEndTime();
+        std::string date = reservation.getDate();
+        int guestCount = reservation.getGuestCount();
+        
+        emailService.sendInBackground([=](EmailService& mailer) {
+            return mailer.sendReservationConfirmation(toEmail, customerName, restaurantName, date, timeSlot,
+                                                      guestCount, confirmationToken, reservationId);
+        }, "reservation confirmation to " + toEmail);
+        
+        std::cout << "Reservation created with ID: " << reservationId 
+                 << ", confirmation email queued for: " << toEmail << std::endl;
     }
     
-    return success;
+    return reservationId;
 }
 
 bool ReservationService::updateReservation(const Reservation& reservation) {
@@ -116,6 +123,17 @@ bool ReservationService::completeReservation(int id) {
     return reservationData.updateReservationStatus(id, "completed");
 }
 
+int ReservationService::updateReservationStatuses(const std::vector<int>& ids, const std::string& status) {
+    if (!isValidStatus(status)) {
+        return -1;
+    }
+    return reservationData.updateReservationStatuses(ids, status);
+}
+
+bool ReservationService::isValidStatus(const std::string& status) {
+    return status == "pending" || status == "confirmed" || status == "cancelled" || status == "completed";
+}
+
 void ReservationService::updateTableAvailability(int tableId, bool isAvailable) {
     tableData.updateTableAvailability(tableId, isAvailable);
 }
@@ -151,18 +169,19 @@ bool ReservationService::confirmReservation(const std::string& token) {
             std::string timeSlot = reservation->getStartTime() + " - " + reservation->getEndTime();
             
             // Send confirmation email
-            emailService.sendReservationConfirmed(
-                reservation->getEmail().empty() ? user->getEmail() : reservation->getEmail(),
-                customerName,
-                restaurant->getName(),
-                reservation->getDate(),
-                timeSlot,
-                reservation->getGuestCount(),
-                reservation->getId()
-            );
+            std::string toEmail = reservation->getEmail().empty() ? user->getEmail() : reservation->getEmail();
+            std::string restaurantName = restaurant->getName();
+            std::string date = reservation->getDate();
+            int guestCount = reservation->getGuestCount();
+            int reservationId = reservation->getId();
+            
+            emailService.sendInBackground([=](EmailService& mailer) {
+                return mailer.sendReservationConfirmed(toEmail, customerName, restaurantName, date, timeSlot,
+                                                       guestCount, reservationId);
+            }, "reservation confirmed email to " + toEmail);
             
-            std::cout << "Reservation confirmed: ID " << reservation->getId() 
-                     << ", confirmation email sent to: " << (reservation->getEmail().empty() ? user->getEmail() : reservation->getEmail()) << std::endl;
+            std::cout << "Reservation confirmed: ID " << reservationId 
+                     << ", confirmation email queued for: " << toEmail << std::endl;
         }
     }
     
@@ -1,6 +1,7 @@
 #include "businessLogic/restaurantService.h"
 
-RestaurantService::RestaurantService() {}
+RestaurantService::RestaurantService()
+    : restaurantData(Storage::instance().restaurants()), tableData(Storage::instance().tables()) {}
 
 std::vector<Restaurant> RestaurantService::getAllRestaurants() {
     return restaurantData.getAllRestaurants();
@@ -10,6 +11,10 @@ std::optional<Restaurant> RestaurantService::getRestaurantById(int id) {
     return restaurantData.getRestaurantById(id);
 }
 
+std::optional<RestaurantDetails> RestaurantService::getRestaurantDetails(int id, const PageRequest& reviewPage) {
+    return restaurantData.getRestaurantDetails(id, reviewPage);
+}
+
 bool RestaurantService::addRestaurant(const Restaurant& restaurant) {
     return restaurantData.addRestaurant(restaurant);
 }
@@ -42,6 +47,10 @@ bool RestaurantService::addTable(const Table& table) {
     return tableData.addTable(table);
 }
 
+int RestaurantService::addTables(int restaurantId, const std::vector<Table>& tables) {
+    return tableData.addTables(restaurantId, tables);
+}
+
 bool RestaurantService::updateTable(const Table& table) {
     return tableData.updateTable(table);
 }
@@ -1,6 +1,6 @@
 #include "businessLogic/reviewService.h"
 
-ReviewService::ReviewService() {}
+ReviewService::ReviewService() : reviewData(Storage::instance().reviews()) {}
 
 std::vector<Review> ReviewService::getAllReviews() {
     return reviewData.getAllReviews();
@@ -14,6 +14,10 @@ std::vector<Review> ReviewService::getReviewsByRestaurantId(int restaurantId) {
     return reviewData.getReviewsByRestaurantId(restaurantId);
 }
 
+Page<Review> ReviewService::getReviewsByRestaurantId(int restaurantId, const PageRequest& pageRequest) {
+    return reviewData.getReviewsByRestaurantId(restaurantId, pageRequest);
+}
+
 std::optional<Review> ReviewService::getReviewById(int id) {
     return reviewData.getReviewById(id);
 }
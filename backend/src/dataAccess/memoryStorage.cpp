@@ -0,0 +1,1385 @@
+#include "dataAccess/memoryStorage.h"
+#include "utils/envLoader.h"
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <utility>
+
+namespace {
+
+using IdSet = std::set<int>;
+using Clock = std::chrono::system_clock;
+
+struct MemoryToken {
+    int userId = 0;
+    Clock::time_point expiresAt;
+    bool active = true;
+};
+
+constexpr PermissionSet userPermissions = permissionSetOf({
+    Permission::MakeReservation, Permission::ViewReservations, Permission::CancelReservation, Permission::WriteReview});
+constexpr PermissionSet adminPermissions = permissionSetOf({
+    Permission::MakeReservation, Permission::ViewReservations, Permission::CancelReservation, Permission::WriteReview,
+    Permission::ManageRestaurants, Permission::ManageUsers, Permission::ViewAdminPanel, Permission::PromoteUsers});
+
+std::string formatLocalTime(const char* format) {
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+    localtime_r(&now, &local);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), format, &local);
+    return buffer;
+}
+
+std::string currentTimestamp() {
+    return formatLocalTime("%Y-%m-%d %H:%M:%S");
+}
+
+std::string currentDate() {
+    return formatLocalTime("%Y-%m-%d");
+}
+
+// TIME columns read back as HH:MM:SS while clients send HH:MM; times are stored and compared in
+// the long form so string order is time order
+std::string normalizeTime(const std::string& time) {
+    return time.size() == 5 ? time + ":00" : time;
+}
+
+Reservation normalized(Reservation reservation) {
+    reservation.setStartTime(normalizeTime(reservation.getStartTime()));
+    reservation.setEndTime(normalizeTime(reservation.getEndTime()));
+    return reservation;
+}
+
+// The SQL backend's conflict predicate; both times already normalized
+bool overlaps(const Reservation& existing, const std::string& startTime, const std::string& endTime) {
+    std::string existingStart = existing.getStartTime();
+    std::string existingEnd = existing.getEndTime();
+    return (existingStart < startTime && existingEnd > startTime) ||
+           (existingStart < endTime && existingEnd > endTime) ||
+           (existingStart >= startTime && existingEnd <= endTime);
+}
+
+template <typename Key>
+void addToIndex(std::unordered_map<Key, IdSet>& index, const Key& key, int id) {
+    index[key].insert(id);
+}
+
+template <typename Index, typename Key>
+void removeFromIndex(Index& index, const Key& key, int id) {
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second.erase(id);
+        if (it->second.empty()) {
+            index.erase(it);
+        }
+    }
+}
+
+// Copy of the ids under key, safe to iterate while the index is being changed
+template <typename Index, typename Key>
+IdSet idsIn(const Index& index, const Key& key) {
+    auto it = index.find(key);
+    return it != index.end() ? it->second : IdSet();
+}
+
+template <typename Row>
+std::optional<Row> findRow(const std::map<int, Row>& rows, int id) {
+    auto it = rows.find(id);
+    if (it == rows.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+} // namespace
+
+class MemoryDatabase {
+public:
+    mutable std::shared_mutex mutex;
+
+    std::map<int, User> users;
+    std::map<int, UserRole> roles;
+    std::map<int, Restaurant> restaurants;
+    std::map<int, Table> tables;
+    std::map<int, Reservation> reservations;
+    std::map<int, Review> reviews;
+    std::map<int, Payment> payments;
+    std::map<int, AuditLogEntry> auditLog;
+    std::unordered_map<std::string, MemoryToken> tokens;
+
+    std::unordered_map<std::string, int> userByUsername;
+    std::unordered_map<std::string, int> userByEmail;
+    std::unordered_map<std::string, int> userByVerificationToken;
+    std::unordered_map<int, IdSet> tablesByRestaurant;
+    std::unordered_map<int, IdSet> reservationsByUser;
+    std::unordered_map<int, IdSet> reservationsByRestaurant;
+    std::unordered_map<int, IdSet> reservationsByTable;
+    std::map<std::pair<int, std::string>, IdSet> reservationsBySlot; // (table id, date)
+    std::unordered_map<std::string, int> reservationByConfirmationToken;
+    std::unordered_map<int, Clock::time_point> reservationCreatedAt; // reservations.created_at
+    std::unordered_map<int, IdSet> reviewsByUser;
+    std::unordered_map<int, IdSet> reviewsByRestaurant;
+    std::map<std::pair<int, int>, int> reviewByUserAndRestaurant;
+    std::unordered_map<int, IdSet> paymentsByUser;
+    std::unordered_map<int, IdSet> paymentsByReservation;
+
+    int nextUserId = 1;
+    int nextRestaurantId = 1;
+    int nextTableId = 1;
+    int nextReservationId = 1;
+    int nextReviewId = 1;
+    int nextPaymentId = 1;
+    int nextAuditLogId = 1;
+
+    MemoryDatabase() {
+        roles[1] = UserRole(1, "user", "Regular user with basic permissions", userPermissions);
+        roles[2] = UserRole(2, "admin", "Administrator with full permissions", adminPermissions);
+    }
+
+    // Everything below expects the caller to hold the lock: shared for the const members,
+    // exclusive for the rest.
+
+    User withRole(User user) const {
+        auto role = roles.find(user.getRoleId());
+        user.setRoleName(role != roles.end() ? role->second.getName() : "user");
+        user.setPermissions(role != roles.end() ? role->second.getPermissions() : PermissionSet());
+        return user;
+    }
+
+    std::optional<User> userByKey(const std::unordered_map<std::string, int>& index, const std::string& key) const {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            return std::nullopt;
+        }
+        return withRole(users.at(it->second));
+    }
+
+    void indexUser(const User& user) {
+        userByUsername[user.getUsername()] = user.getId();
+        userByEmail[user.getEmail()] = user.getId();
+        if (!user.getEmailVerificationToken().empty()) {
+            userByVerificationToken[user.getEmailVerificationToken()] = user.getId();
+        }
+    }
+
+    void unindexUser(const User& user) {
+        userByUsername.erase(user.getUsername());
+        userByEmail.erase(user.getEmail());
+        userByVerificationToken.erase(user.getEmailVerificationToken());
+    }
+
+    // UNIQUE KEY username / email, ignoring the row being updated
+    bool userKeysTaken(const User& user) const {
+        auto username = userByUsername.find(user.getUsername());
+        auto email = userByEmail.find(user.getEmail());
+        return (username != userByUsername.end() && username->second != user.getId()) ||
+               (email != userByEmail.end() && email->second != user.getId());
+    }
+
+    Restaurant withTableCount(Restaurant restaurant) const {
+        auto it = tablesByRestaurant.find(restaurant.getId());
+        restaurant.setTableCount(it != tablesByRestaurant.end() ? static_cast<int>(it->second.size()) : 0);
+        return restaurant;
+    }
+
+    // Adds restaurant_name and customer_name as the reservations-with-names queries do
+    Reservation withNames(Reservation reservation) const {
+        auto restaurant = restaurants.find(reservation.getRestaurantId());
+        reservation.setRestaurantName(restaurant != restaurants.end() ? restaurant->second.getName() : "");
+        auto user = users.find(reservation.getUserId());
+        reservation.setCustomerName(user != users.end()
+            ? user->second.getFirstName() + " " + user->second.getLastName() : "");
+        return reservation;
+    }
+
+    void indexReservation(const Reservation& reservation) {
+        int id = reservation.getId();
+        addToIndex(reservationsByUser, reservation.getUserId(), id);
+        addToIndex(reservationsByRestaurant, reservation.getRestaurantId(), id);
+        addToIndex(reservationsByTable, reservation.getTableId(), id);
+        reservationsBySlot[{reservation.getTableId(), reservation.getDate()}].insert(id);
+        if (!reservation.getConfirmationToken().empty()) {
+            reservationByConfirmationToken[reservation.getConfirmationToken()] = id;
+        }
+    }
+
+    void unindexReservation(const Reservation& reservation) {
+        int id = reservation.getId();
+        removeFromIndex(reservationsByUser, reservation.getUserId(), id);
+        removeFromIndex(reservationsByRestaurant, reservation.getRestaurantId(), id);
+        removeFromIndex(reservationsByTable, reservation.getTableId(), id);
+        removeFromIndex(reservationsBySlot, std::make_pair(reservation.getTableId(), reservation.getDate()), id);
+        reservationByConfirmationToken.erase(reservation.getConfirmationToken());
+    }
+
+    // Only the reservations on that table and date are examined
+    bool hasConflict(int tableId, const std::string& date, const std::string& startTime,
+                     const std::string& endTime, int excludeReservationId) const {
+        auto slot = reservationsBySlot.find({tableId, date});
+        if (slot == reservationsBySlot.end()) {
+            return false;
+        }
+        std::string start = normalizeTime(startTime);
+        std::string end = normalizeTime(endTime);
+        for (int id : slot->second) {
+            const Reservation& existing = reservations.at(id);
+            if (id != excludeReservationId && existing.getStatus() != "cancelled" && overlaps(existing, start, end)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // FOREIGN KEY user_id, table_id, restaurant_id
+    bool reservationReferencesExist(const Reservation& reservation) const {
+        return users.count(reservation.getUserId()) && tables.count(reservation.getTableId()) &&
+               restaurants.count(reservation.getRestaurantId());
+    }
+
+    int insertReservation(Reservation reservation) {
+        reservation.setId(nextReservationId++);
+        reservations[reservation.getId()] = reservation;
+        reservationCreatedAt[reservation.getId()] = Clock::now();
+        indexReservation(reservation);
+        return reservation.getId();
+    }
+
+    void replaceReservation(const Reservation& reservation) {
+        Reservation& stored = reservations.at(reservation.getId());
+        unindexReservation(stored);
+        stored = reservation;
+        indexReservation(stored);
+    }
+
+    void removeReservation(int id) {
+        auto it = reservations.find(id);
+        if (it == reservations.end()) {
+            return;
+        }
+        for (int paymentId : idsIn(paymentsByReservation, id)) {
+            removePayment(paymentId);
+        }
+        unindexReservation(it->second);
+        reservationCreatedAt.erase(id);
+        reservations.erase(it);
+    }
+
+    void removeTable(int id) {
+        auto it = tables.find(id);
+        if (it == tables.end()) {
+            return;
+        }
+        for (int reservationId : idsIn(reservationsByTable, id)) {
+            removeReservation(reservationId);
+        }
+        removeFromIndex(tablesByRestaurant, it->second.getRestaurantId(), id);
+        tables.erase(it);
+    }
+
+    void indexReview(const Review& review) {
+        addToIndex(reviewsByUser, review.getUserId(), review.getId());
+        addToIndex(reviewsByRestaurant, review.getRestaurantId(), review.getId());
+        reviewByUserAndRestaurant[{review.getUserId(), review.getRestaurantId()}] = review.getId();
+    }
+
+    void unindexReview(const Review& review) {
+        removeFromIndex(reviewsByUser, review.getUserId(), review.getId());
+        removeFromIndex(reviewsByRestaurant, review.getRestaurantId(), review.getId());
+        reviewByUserAndRestaurant.erase(std::make_pair(review.getUserId(), review.getRestaurantId()));
+    }
+
+    float averageRating(int restaurantId) const {
+        auto it = reviewsByRestaurant.find(restaurantId);
+        if (it == reviewsByRestaurant.end() || it->second.empty()) {
+            return 0.0f;
+        }
+        double total = 0.0;
+        for (int id : it->second) {
+            total += reviews.at(id).getRating();
+        }
+        return static_cast<float>(total / it->second.size());
+    }
+
+    void refreshRating(int restaurantId) {
+        auto it = restaurants.find(restaurantId);
+        if (it != restaurants.end()) {
+            it->second.setRating(averageRating(restaurantId));
+        }
+    }
+
+    void removeReview(int id) {
+        auto it = reviews.find(id);
+        if (it == reviews.end()) {
+            return;
+        }
+        int restaurantId = it->second.getRestaurantId();
+        unindexReview(it->second);
+        reviews.erase(it);
+        refreshRating(restaurantId);
+    }
+
+    void indexPayment(const Payment& payment) {
+        addToIndex(paymentsByUser, payment.getUserId(), payment.getId());
+        addToIndex(paymentsByReservation, payment.getReservationId(), payment.getId());
+    }
+
+    void unindexPayment(const Payment& payment) {
+        removeFromIndex(paymentsByUser, payment.getUserId(), payment.getId());
+        removeFromIndex(paymentsByReservation, payment.getReservationId(), payment.getId());
+    }
+
+    void removePayment(int id) {
+        auto it = payments.find(id);
+        if (it == payments.end()) {
+            return;
+        }
+        unindexPayment(it->second);
+        payments.erase(it);
+    }
+
+    void removeRestaurant(int id) {
+        for (int tableId : idsIn(tablesByRestaurant, id)) {
+            removeTable(tableId);
+        }
+        for (int reservationId : idsIn(reservationsByRestaurant, id)) {
+            removeReservation(reservationId);
+        }
+        for (int reviewId : idsIn(reviewsByRestaurant, id)) {
+            removeReview(reviewId);
+        }
+        restaurants.erase(id);
+    }
+
+    void removeUser(int id) {
+        auto it = users.find(id);
+        if (it == users.end()) {
+            return;
+        }
+        for (int reservationId : idsIn(reservationsByUser, id)) {
+            removeReservation(reservationId);
+        }
+        for (int reviewId : idsIn(reviewsByUser, id)) {
+            removeReview(reviewId);
+        }
+        for (int paymentId : idsIn(paymentsByUser, id)) {
+            removePayment(paymentId);
+        }
+        for (auto entry = auditLog.begin(); entry != auditLog.end();) {
+            entry = entry->second.getAdminUserId() == id ? auditLog.erase(entry) : std::next(entry);
+        }
+        for (auto token = tokens.begin(); token != tokens.end();) {
+            token = token->second.userId == id ? tokens.erase(token) : std::next(token);
+        }
+        unindexUser(it->second);
+        users.erase(it);
+    }
+
+    AuditLogEntry withAdminName(AuditLogEntry entry) const {
+        auto admin = users.find(entry.getAdminUserId());
+        entry.setAdminUsername(admin != users.end() ? admin->second.getUsername() : "");
+        return entry;
+    }
+};
+
+namespace {
+
+// Rows in id order, limit + 1 of them when bounded, as the keyset queries fetch
+template <typename Row, typename Convert>
+Page<Row> pageAfter(const std::map<int, Row>& rows, const PageRequest& pageRequest, Convert convert) {
+    Page<Row> page;
+    for (auto it = rows.upper_bound(pageRequest.after); it != rows.end(); ++it) {
+        if (pageRequest.isBounded() && static_cast<int>(page.items.size()) > pageRequest.limit) {
+            break;
+        }
+        page.items.push_back(convert(it->second));
+    }
+    finishPage(page, pageRequest);
+    return page;
+}
+
+// Full walk in id order. Each batch is copied under the shared lock and visited after it is
+// released, so a slow visitor (an export writing to disk) never holds up writers.
+template <typename Row, typename Convert>
+void scanInBatches(std::shared_mutex& mutex, const std::map<int, Row>& rows, int batchSize, Convert convert,
+                   const std::function<void(const Row&)>& visit) {
+    if (batchSize < 1) {
+        batchSize = 1;
+    }
+    int after = 0;
+    for (;;) {
+        std::vector<Row> batch;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            for (auto it = rows.upper_bound(after); it != rows.end() && static_cast<int>(batch.size()) < batchSize; ++it) {
+                batch.push_back(convert(it->second));
+            }
+        }
+        for (const Row& row : batch) {
+            visit(row);
+        }
+        if (static_cast<int>(batch.size()) < batchSize) {
+            return;
+        }
+        after = batch.back().getId();
+    }
+}
+
+template <typename Row>
+std::vector<Row> rowsFor(const std::map<int, Row>& rows, const IdSet& ids) {
+    std::vector<Row> result;
+    result.reserve(ids.size());
+    for (int id : ids) {
+        result.push_back(rows.at(id));
+    }
+    return result;
+}
+
+template <typename Row>
+Row identity(const Row& row) {
+    return row;
+}
+
+// Tables of a restaurant with their current and upcoming bookings; caller holds the shared lock
+std::vector<Table> tablesWithReservations(const MemoryDatabase& db, int restaurantId) {
+    std::string today = currentDate();
+    std::vector<Table> tables = rowsFor(db.tables, idsIn(db.tablesByRestaurant, restaurantId));
+    for (auto& table : tables) {
+        table.setIsAvailable(true);
+
+        // Current and upcoming bookings in date, start time order
+        std::vector<const Reservation*> upcoming;
+        for (int id : idsIn(db.reservationsByTable, table.getId())) {
+            const Reservation& reservation = db.reservations.at(id);
+            if (reservation.getStatus() != "cancelled" && reservation.getDate() >= today) {
+                upcoming.push_back(&reservation);
+            }
+        }
+        std::sort(upcoming.begin(), upcoming.end(), [](const Reservation* a, const Reservation* b) {
+            return std::make_pair(a->getDate(), a->getStartTime()) < std::make_pair(b->getDate(), b->getStartTime());
+        });
+
+        std::vector<ReservationInfo> infos;
+        infos.reserve(upcoming.size());
+        for (const Reservation* reservation : upcoming) {
+            ReservationInfo info;
+            info.id = reservation->getId();
+            info.date = reservation->getDate();
+            info.startTime = reservation->getStartTime();
+            info.endTime = reservation->getEndTime();
+            info.status = reservation->getStatus();
+            info.guestCount = reservation->getGuestCount();
+            infos.push_back(info);
+        }
+        table.setReservations(infos);
+    }
+    return tables;
+}
+
+// A restaurant's reviews in id order after pageRequest.after; caller holds the shared lock
+Page<Review> reviewsAfter(const MemoryDatabase& db, int restaurantId, const PageRequest& pageRequest) {
+    Page<Review> page;
+    auto index = db.reviewsByRestaurant.find(restaurantId);
+    if (index == db.reviewsByRestaurant.end()) {
+        return page;
+    }
+    for (auto it = index->second.upper_bound(pageRequest.after); it != index->second.end(); ++it) {
+        if (pageRequest.isBounded() && static_cast<int>(page.items.size()) > pageRequest.limit) {
+            break;
+        }
+        page.items.push_back(db.reviews.at(*it));
+    }
+    finishPage(page, pageRequest);
+    return page;
+}
+
+} // namespace
+
+// Reservations
+
+MemoryReservationStore::MemoryReservationStore(MemoryDatabase& db) : db(db) {}
+
+std::vector<Reservation> MemoryReservationStore::getAllReservations() {
+    return getAllReservations(PageRequest::unbounded()).items;
+}
+
+Page<Reservation> MemoryReservationStore::getAllReservations(const PageRequest& pageRequest) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return pageAfter(db.reservations, pageRequest, [this](const Reservation& r) { return db.withNames(r); });
+}
+
+bool MemoryReservationStore::forEachReservation(const std::function<void(const Reservation&)>& visit, int batchSize) {
+    scanInBatches(db.mutex, db.reservations, batchSize, [this](const Reservation& r) { return db.withNames(r); }, visit);
+    return true;
+}
+
+std::vector<Reservation> MemoryReservationStore::getReservationsByUserId(int userId) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return rowsFor(db.reservations, idsIn(db.reservationsByUser, userId));
+}
+
+std::vector<Reservation> MemoryReservationStore::getReservationsByRestaurantId(int restaurantId) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return rowsFor(db.reservations, idsIn(db.reservationsByRestaurant, restaurantId));
+}
+
+std::vector<Reservation> MemoryReservationStore::getReservationsByTableId(int tableId) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return rowsFor(db.reservations, idsIn(db.reservationsByTable, tableId));
+}
+
+std::optional<Reservation> MemoryReservationStore::getReservationById(int id) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return findRow(db.reservations, id);
+}
+
+std::optional<Reservation> MemoryReservationStore::getReservationByIdWithDetails(int id) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    auto reservation = findRow(db.reservations, id);
+    if (!reservation) {
+        return std::nullopt;
+    }
+    return db.withNames(*reservation);
+}
+
+bool MemoryReservationStore::addReservation(const Reservation& reservation) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    if (!db.reservationReferencesExist(reservation)) {
+        return false;
+    }
+    db.insertReservation(normalized(reservation));
+    return true;
+}
+
+std::optional<Reservation> MemoryReservationStore::addReservationIfAvailable(const Reservation& reservation) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    if (!db.reservationReferencesExist(reservation) ||
+        db.tables.at(reservation.getTableId()).getRestaurantId() != reservation.getRestaurantId() ||
+        db.hasConflict(reservation.getTableId(), reservation.getDate(), reservation.getStartTime(), reservation.getEndTime(), 0)) {
+        return std::nullopt;
+    }
+    Reservation booked = reservation;
+    booked.setId(db.insertReservation(normalized(reservation)));
+    booked.setRestaurantName(db.restaurants.at(booked.getRestaurantId()).getName());
+
+    const User& user = db.users.at(booked.getUserId());
+    std::string customerName = user.getFirstName() + " " + user.getLastName();
+    if (customerName == " ") {
+        customerName = user.getUsername();
+    }
+    booked.setCustomerName(customerName);
+    if (booked.getEmail().empty()) {
+        booked.setEmail(user.getEmail());
+    }
+    return booked;
+}
+
+bool MemoryReservationStore::updateReservation(const Reservation& reservation) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.reservations.find(reservation.getId());
+    if (it == db.reservations.end()) {
+        return true;
+    }
+    if (!db.reservationReferencesExist(reservation)) {
+        return false;
+    }
+    Reservation updated = normalized(reservation);
+    updated.setConfirmationToken(it->second.getConfirmationToken());
+    db.replaceReservation(updated);
+    return true;
+}
+
+bool MemoryReservationStore::deleteReservation(int id) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    db.removeReservation(id);
+    return true;
+}
+
+bool MemoryReservationStore::updateReservationStatus(int id, const std::string& status) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.reservations.find(id);
+    if (it != db.reservations.end()) {
+        it->second.setStatus(status);
+    }
+    return true;
+}
+
+int MemoryReservationStore::updateReservationStatuses(const std::vector<int>& ids, const std::string& status) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    int changed = 0;
+    for (int id : ids) {
+        auto it = db.reservations.find(id);
+        if (it != db.reservations.end() && it->second.getStatus() != status) {
+            it->second.setStatus(status);
+            ++changed;
+        }
+    }
+    return changed;
+}
+
+bool MemoryReservationStore::isTableAvailable(int tableId, const std::string& date, const std::string& startTime, const std::string& endTime, int excludeReservationId) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return !db.hasConflict(tableId, date, startTime, endTime, excludeReservationId);
+}
+
+std::vector<int> MemoryReservationStore::getAvailableTableIds(int restaurantId, const std::string& date, const std::string& startTime, const std::string& endTime, int minCapacity) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    std::vector<int> availableTableIds;
+    for (int tableId : idsIn(db.tablesByRestaurant, restaurantId)) {
+        if (minCapacity > 0 && db.tables.at(tableId).getSeatCount() < minCapacity) {
+            continue;
+        }
+        if (!db.hasConflict(tableId, date, startTime, endTime, 0)) {
+            availableTableIds.push_back(tableId);
+        }
+    }
+    return availableTableIds;
+}
+
+std::optional<Reservation> MemoryReservationStore::getReservationByConfirmationToken(const std::string& token) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.reservationByConfirmationToken.find(token);
+    if (it == db.reservationByConfirmationToken.end()) {
+        return std::nullopt;
+    }
+    return db.reservations.at(it->second);
+}
+
+bool MemoryReservationStore::updateReservationConfirmationToken(int id, const std::string& token) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.reservations.find(id);
+    if (it != db.reservations.end()) {
+        Reservation updated = it->second;
+        updated.setConfirmationToken(token);
+        db.replaceReservation(updated);
+    }
+    return true;
+}
+
+bool MemoryReservationStore::confirmReservation(const std::string& token) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.reservationByConfirmationToken.find(token);
+    if (it == db.reservationByConfirmationToken.end()) {
+        return false;
+    }
+    Reservation updated = db.reservations.at(it->second);
+    if (updated.getStatus() != "pending") {
+        return false;
+    }
+    updated.setStatus("confirmed");
+    updated.setConfirmationToken("");
+    db.replaceReservation(updated);
+    return true;
+}
+
+int MemoryReservationStore::expirePendingReservations(std::chrono::minutes holdFor, int limit) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    Clock::time_point cutoff = Clock::now() - holdFor;
+    std::vector<int> expired;
+    for (const auto& entry : db.reservations) {
+        if (static_cast<int>(expired.size()) >= limit) {
+            break;
+        }
+        auto created = db.reservationCreatedAt.find(entry.first);
+        if (entry.second.getStatus() == "pending" && entry.second.getPaymentStatus() != "paid" &&
+            created != db.reservationCreatedAt.end() && created->second < cutoff) {
+            expired.push_back(entry.first);
+        }
+    }
+    for (int id : expired) {
+        Reservation updated = db.reservations.at(id);
+        updated.setStatus("cancelled");
+        updated.setConfirmationToken("");
+        db.replaceReservation(updated);
+    }
+    return static_cast<int>(expired.size());
+}
+
+// Tables
+
+MemoryTableStore::MemoryTableStore(MemoryDatabase& db) : db(db) {}
+
+std::vector<Table> MemoryTableStore::getAllTables() {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    std::vector<Table> tables;
+    tables.reserve(db.tables.size());
+    for (const auto& entry : db.tables) {
+        tables.push_back(entry.second);
+    }
+    return tables;
+}
+
+std::vector<Table> MemoryTableStore::getTablesByRestaurantId(int restaurantId) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return rowsFor(db.tables, idsIn(db.tablesByRestaurant, restaurantId));
+}
+
+std::vector<Table> MemoryTableStore::getAvailableTablesByRestaurantId(int restaurantId) {
+    // Availability is time-based, so every table is bookable in principle
+    std::vector<Table> tables = getTablesByRestaurantId(restaurantId);
+    for (auto& table : tables) {
+        table.setIsAvailable(true);
+    }
+    return tables;
+}
+
+std::vector<Table> MemoryTableStore::getTablesWithReservationsByRestaurantId(int restaurantId) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return tablesWithReservations(db, restaurantId);
+}
+
+std::optional<Table> MemoryTableStore::getTableById(int id) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return findRow(db.tables, id);
+}
+
+int MemoryTableStore::addTable(const Table& table) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    if (!db.restaurants.count(table.getRestaurantId())) {
+        return 0;
+    }
+    Table stored = table;
+    stored.setId(db.nextTableId++);
+    stored.setReservations({});
+    db.tables[stored.getId()] = stored;
+    addToIndex(db.tablesByRestaurant, stored.getRestaurantId(), stored.getId());
+    return stored.getId();
+}
+
+int MemoryTableStore::addTables(int restaurantId, const std::vector<Table>& tables) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    if (tables.empty() || !db.restaurants.count(restaurantId)) {
+        return 0;
+    }
+    for (const auto& table : tables) {
+        Table stored;
+        stored.setId(db.nextTableId++);
+        stored.setRestaurantId(restaurantId);
+        stored.setSeatCount(table.getSeatCount());
+        stored.setIsAvailable(table.getIsAvailable());
+        db.tables[stored.getId()] = stored;
+        addToIndex(db.tablesByRestaurant, restaurantId, stored.getId());
+    }
+    return static_cast<int>(tables.size());
+}
+
+bool MemoryTableStore::updateTable(const Table& table) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.tables.find(table.getId());
+    if (it == db.tables.end()) {
+        return true;
+    }
+    if (!db.restaurants.count(table.getRestaurantId())) {
+        return false;
+    }
+    removeFromIndex(db.tablesByRestaurant, it->second.getRestaurantId(), table.getId());
+    it->second.setRestaurantId(table.getRestaurantId());
+    it->second.setSeatCount(table.getSeatCount());
+    it->second.setIsAvailable(table.getIsAvailable());
+    addToIndex(db.tablesByRestaurant, table.getRestaurantId(), table.getId());
+    return true;
+}
+
+bool MemoryTableStore::deleteTable(int id) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    db.removeTable(id);
+    return true;
+}
+
+bool MemoryTableStore::updateTableAvailability(int id, bool isAvailable) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.tables.find(id);
+    if (it != db.tables.end()) {
+        it->second.setIsAvailable(isAvailable);
+    }
+    return true;
+}
+
+// Users, roles and the admin audit log
+
+MemoryUserStore::MemoryUserStore(MemoryDatabase& db) : db(db) {}
+
+std::vector<User> MemoryUserStore::getAllUsers() {
+    return getAllUsers(PageRequest::unbounded()).items;
+}
+
+Page<User> MemoryUserStore::getAllUsers(const PageRequest& pageRequest) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return pageAfter(db.users, pageRequest, [this](const User& user) { return db.withRole(user); });
+}
+
+bool MemoryUserStore::forEachUser(const std::function<void(const User&)>& visit, int batchSize) {
+    scanInBatches(db.mutex, db.users, batchSize, [this](const User& user) { return db.withRole(user); }, visit);
+    return true;
+}
+
+bool MemoryUserStore::forEachAuditLogEntry(const std::function<void(const AuditLogEntry&)>& visit, int batchSize) {
+    scanInBatches(db.mutex, db.auditLog, batchSize, [this](const AuditLogEntry& entry) { return db.withAdminName(entry); }, visit);
+    return true;
+}
+
+std::optional<User> MemoryUserStore::getUserById(int id) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    auto user = findRow(db.users, id);
+    if (!user) {
+        return std::nullopt;
+    }
+    return db.withRole(*user);
+}
+
+std::unordered_map<int, User> MemoryUserStore::getUsersByIds(const std::vector<int>& ids) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    std::unordered_map<int, User> users;
+    for (int id : ids) {
+        auto it = db.users.find(id);
+        if (it != db.users.end()) {
+            users[id] = db.withRole(it->second);
+        }
+    }
+    return users;
+}
+
+std::optional<User> MemoryUserStore::getUserByUsername(const std::string& username) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return db.userByKey(db.userByUsername, username);
+}
+
+std::optional<User> MemoryUserStore::getUserByEmail(const std::string& email) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return db.userByKey(db.userByEmail, email);
+}
+
+bool MemoryUserStore::addUser(const User& user) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    User stored = user;
+    stored.setId(0);
+    if (db.userKeysTaken(stored)) {
+        return false;
+    }
+    // Column defaults: role_id 1, is_active 1
+    stored.setId(db.nextUserId++);
+    stored.setRoleId(1);
+    stored.setActive(true);
+    stored.setCreatedAt(currentTimestamp());
+    db.users[stored.getId()] = stored;
+    db.indexUser(stored);
+    return true;
+}
+
+bool MemoryUserStore::updateUser(const User& user) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.users.find(user.getId());
+    if (it == db.users.end()) {
+        return true;
+    }
+    if (db.userKeysTaken(user)) {
+        return false;
+    }
+    db.unindexUser(it->second);
+    it->second.setUsername(user.getUsername());
+    it->second.setEmail(user.getEmail());
+    it->second.setPasswordHash(user.getPasswordHash());
+    db.indexUser(it->second);
+    return true;
+}
+
+bool MemoryUserStore::deleteUser(int id) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    db.removeUser(id);
+    return true;
+}
+
+bool MemoryUserStore::updatePasswordHash(int userId, const std::string& passwordHash) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.users.find(userId);
+    if (it == db.users.end()) {
+        return false;
+    }
+    it->second.setPasswordHash(passwordHash);
+    return true;
+}
+
+bool MemoryUserStore::verifyEmailToken(const std::string& token) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.userByVerificationToken.find(token);
+    if (it == db.userByVerificationToken.end()) {
+        return false;
+    }
+    User& user = db.users.at(it->second);
+
+    // AuthService stores the expiry as Unix seconds
+    long long expires = 0;
+    try {
+        expires = std::stoll(user.getEmailVerificationExpires());
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (user.isEmailVerified() || expires <= static_cast<long long>(std::time(nullptr))) {
+        return false;
+    }
+
+    db.userByVerificationToken.erase(it);
+    user.setEmailVerified(true);
+    user.setEmailVerificationToken("");
+    user.setEmailVerificationExpires("");
+    return true;
+}
+
+int MemoryUserStore::clearExpiredVerificationTokens(int limit) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    long long now = static_cast<long long>(std::time(nullptr));
+    int cleared = 0;
+    for (auto it = db.userByVerificationToken.begin(); it != db.userByVerificationToken.end() && cleared < limit;) {
+        User& user = db.users.at(it->second);
+        long long expires = 0;
+        try {
+            expires = std::stoll(user.getEmailVerificationExpires());
+        } catch (const std::exception&) {
+            // No parsable expiry: the SQL comparison would be NULL, so the row is left alone
+            ++it;
+            continue;
+        }
+        if (expires >= now) {
+            ++it;
+            continue;
+        }
+        user.setEmailVerificationToken("");
+        user.setEmailVerificationExpires("");
+        it = db.userByVerificationToken.erase(it);
+        ++cleared;
+    }
+    return cleared;
+}
+
+std::vector<UserRole> MemoryUserStore::getAllRoles() {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    std::vector<UserRole> roles;
+    for (const auto& entry : db.roles) {
+        roles.push_back(entry.second);
+    }
+    return roles;
+}
+
+std::optional<UserRole> MemoryUserStore::getRoleById(int id) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return findRow(db.roles, id);
+}
+
+bool MemoryUserStore::updateUserRole(int userId, int roleId) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.users.find(userId);
+    if (it == db.users.end()) {
+        return true;
+    }
+    if (!db.roles.count(roleId)) {
+        return false;
+    }
+    it->second.setRoleId(roleId);
+    return true;
+}
+
+bool MemoryUserStore::updateUserStatus(int userId, bool isActive) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.users.find(userId);
+    if (it != db.users.end()) {
+        it->second.setActive(isActive);
+    }
+    return true;
+}
+
+int MemoryUserStore::updateUserStatuses(const std::vector<int>& userIds, bool isActive) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    int changed = 0;
+    for (int id : userIds) {
+        auto it = db.users.find(id);
+        if (it != db.users.end() && it->second.isActive() != isActive) {
+            it->second.setActive(isActive);
+            ++changed;
+        }
+    }
+    return changed;
+}
+
+bool MemoryUserStore::logAdminAction(int adminUserId, const std::string& action, const std::string& targetType,
+                                     int targetId, const std::string& details, const std::string& ipAddress) {
+    return logAdminActions(adminUserId, action, targetType, {targetId}, details, ipAddress);
+}
+
+bool MemoryUserStore::logAdminActions(int adminUserId, const std::string& action, const std::string& targetType,
+                                      const std::vector<int>& targetIds, const std::string& details, const std::string& ipAddress) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    if (targetIds.empty()) {
+        return true;
+    }
+    if (!db.users.count(adminUserId)) {
+        return false;
+    }
+    std::string createdAt = currentTimestamp();
+    for (int targetId : targetIds) {
+        AuditLogEntry entry;
+        entry.setId(db.nextAuditLogId++);
+        entry.setAdminUserId(adminUserId);
+        entry.setAction(action);
+        entry.setTargetType(targetType);
+        entry.setTargetId(targetId);
+        entry.setDetails(details);
+        entry.setIpAddress(ipAddress);
+        entry.setCreatedAt(createdAt);
+        db.auditLog[entry.getId()] = entry;
+    }
+    return true;
+}
+
+// Restaurants
+
+MemoryRestaurantStore::MemoryRestaurantStore(MemoryDatabase& db) : db(db) {}
+
+std::vector<Restaurant> MemoryRestaurantStore::getAllRestaurants() {
+    return getAllRestaurants(PageRequest::unbounded()).items;
+}
+
+Page<Restaurant> MemoryRestaurantStore::getAllRestaurants(const PageRequest& pageRequest) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return pageAfter(db.restaurants, pageRequest, [this](const Restaurant& r) { return db.withTableCount(r); });
+}
+
+std::optional<Restaurant> MemoryRestaurantStore::getRestaurantById(int id) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    auto restaurant = findRow(db.restaurants, id);
+    if (!restaurant) {
+        return std::nullopt;
+    }
+    return db.withTableCount(*restaurant);
+}
+
+std::optional<RestaurantDetails> MemoryRestaurantStore::getRestaurantDetails(int id, const PageRequest& reviewPage) {
+    // One shared lock for the whole load, so the parts are consistent with each other
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    auto restaurant = findRow(db.restaurants, id);
+    if (!restaurant) {
+        return std::nullopt;
+    }
+    RestaurantDetails details;
+    details.restaurant = db.withTableCount(*restaurant);
+    details.tables = tablesWithReservations(db, id);
+    details.reviews = reviewsAfter(db, id, reviewPage);
+    details.averageRating = db.averageRating(id);
+    auto reviews = db.reviewsByRestaurant.find(id);
+    details.reviewCount = reviews != db.reviewsByRestaurant.end() ? static_cast<int>(reviews->second.size()) : 0;
+    return details;
+}
+
+std::unordered_map<int, Restaurant> MemoryRestaurantStore::getRestaurantsByIds(const std::vector<int>& ids) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    std::unordered_map<int, Restaurant> restaurants;
+    for (int id : ids) {
+        auto it = db.restaurants.find(id);
+        if (it != db.restaurants.end()) {
+            restaurants[id] = db.withTableCount(it->second);
+        }
+    }
+    return restaurants;
+}
+
+int MemoryRestaurantStore::addRestaurant(const Restaurant& restaurant) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    Restaurant stored = restaurant;
+    stored.setId(db.nextRestaurantId++);
+    db.restaurants[stored.getId()] = stored;
+    return stored.getId();
+}
+
+bool MemoryRestaurantStore::updateRestaurant(const Restaurant& restaurant) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.restaurants.find(restaurant.getId());
+    if (it == db.restaurants.end()) {
+        return true;
+    }
+    // reservation_fee and is_active are not part of the update
+    Restaurant updated = restaurant;
+    updated.setReservationFee(it->second.getReservationFee());
+    updated.setIsActive(it->second.getIsActive());
+    it->second = updated;
+    return true;
+}
+
+bool MemoryRestaurantStore::deleteRestaurant(int id) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    db.removeRestaurant(id);
+    return true;
+}
+
+// Reviews
+
+MemoryReviewStore::MemoryReviewStore(MemoryDatabase& db) : db(db) {}
+
+std::vector<Review> MemoryReviewStore::getAllReviews() {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    std::vector<Review> reviews;
+    reviews.reserve(db.reviews.size());
+    for (const auto& entry : db.reviews) {
+        reviews.push_back(entry.second);
+    }
+    return reviews;
+}
+
+bool MemoryReviewStore::forEachReview(const std::function<void(const Review&)>& visit, int batchSize) {
+    scanInBatches(db.mutex, db.reviews, batchSize, identity<Review>, visit);
+    return true;
+}
+
+std::vector<Review> MemoryReviewStore::getReviewsByUserId(int userId) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return rowsFor(db.reviews, idsIn(db.reviewsByUser, userId));
+}
+
+std::vector<Review> MemoryReviewStore::getReviewsByRestaurantId(int restaurantId) {
+    return getReviewsByRestaurantId(restaurantId, PageRequest::unbounded()).items;
+}
+
+Page<Review> MemoryReviewStore::getReviewsByRestaurantId(int restaurantId, const PageRequest& pageRequest) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return reviewsAfter(db, restaurantId, pageRequest);
+}
+
+std::optional<Review> MemoryReviewStore::getReviewById(int id) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return findRow(db.reviews, id);
+}
+
+std::optional<Review> MemoryReviewStore::getUserReviewForRestaurant(int userId, int restaurantId) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.reviewByUserAndRestaurant.find({userId, restaurantId});
+    if (it == db.reviewByUserAndRestaurant.end()) {
+        return std::nullopt;
+    }
+    return db.reviews.at(it->second);
+}
+
+bool MemoryReviewStore::addReview(const Review& review) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    // FOREIGN KEY user_id, restaurant_id; UNIQUE KEY (user_id, restaurant_id)
+    if (!db.users.count(review.getUserId()) || !db.restaurants.count(review.getRestaurantId()) ||
+        db.reviewByUserAndRestaurant.count(std::make_pair(review.getUserId(), review.getRestaurantId()))) {
+        return false;
+    }
+    Review stored = review;
+    stored.setId(db.nextReviewId++);
+    db.reviews[stored.getId()] = stored;
+    db.indexReview(stored);
+    db.refreshRating(stored.getRestaurantId());
+    return true;
+}
+
+bool MemoryReviewStore::updateReview(const Review& review) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.reviews.find(review.getId());
+    if (it != db.reviews.end()) {
+        it->second.setRating(review.getRating());
+        it->second.setComment(review.getComment());
+        db.refreshRating(it->second.getRestaurantId());
+    }
+    return true;
+}
+
+bool MemoryReviewStore::deleteReview(int id) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    db.removeReview(id);
+    return true;
+}
+
+float MemoryReviewStore::getAverageRatingForRestaurant(int restaurantId) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return db.averageRating(restaurantId);
+}
+
+int MemoryReviewStore::getReviewCountForRestaurant(int restaurantId) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.reviewsByRestaurant.find(restaurantId);
+    return it != db.reviewsByRestaurant.end() ? static_cast<int>(it->second.size()) : 0;
+}
+
+// Payments
+
+MemoryPaymentStore::MemoryPaymentStore(MemoryDatabase& db) : db(db) {}
+
+std::vector<Payment> MemoryPaymentStore::getAllPayments() {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    std::vector<Payment> payments;
+    payments.reserve(db.payments.size());
+    for (const auto& entry : db.payments) {
+        payments.push_back(entry.second);
+    }
+    return payments;
+}
+
+std::vector<Payment> MemoryPaymentStore::getPaymentsByUserId(int userId) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return rowsFor(db.payments, idsIn(db.paymentsByUser, userId));
+}
+
+std::vector<Payment> MemoryPaymentStore::getPaymentsByReservationId(int reservationId) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return rowsFor(db.payments, idsIn(db.paymentsByReservation, reservationId));
+}
+
+std::optional<Payment> MemoryPaymentStore::getPaymentById(int id) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    return findRow(db.payments, id);
+}
+
+bool MemoryPaymentStore::addPayment(const Payment& payment) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    if (!db.reservations.count(payment.getReservationId()) || !db.users.count(payment.getUserId())) {
+        return false;
+    }
+    Payment stored = payment;
+    std::string now = currentTimestamp();
+    stored.setId(db.nextPaymentId++);
+    stored.setCreatedAt(now);
+    stored.setUpdatedAt(now);
+    db.payments[stored.getId()] = stored;
+    db.indexPayment(stored);
+    return true;
+}
+
+bool MemoryPaymentStore::updatePayment(const Payment& payment) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.payments.find(payment.getId());
+    if (it == db.payments.end()) {
+        return true;
+    }
+    if (!db.reservations.count(payment.getReservationId()) || !db.users.count(payment.getUserId())) {
+        return false;
+    }
+    Payment updated = payment;
+    updated.setCreatedAt(it->second.getCreatedAt());
+    updated.setUpdatedAt(currentTimestamp());
+    db.unindexPayment(it->second);
+    it->second = updated;
+    db.indexPayment(updated);
+    return true;
+}
+
+bool MemoryPaymentStore::updatePaymentStatus(int id, const std::string& status) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.payments.find(id);
+    if (it != db.payments.end()) {
+        it->second.setPaymentStatus(status);
+        it->second.setUpdatedAt(currentTimestamp());
+    }
+    return true;
+}
+
+bool MemoryPaymentStore::deletePayment(int id) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    db.removePayment(id);
+    return true;
+}
+
+// Login tokens
+
+MemoryTokenStore::MemoryTokenStore(MemoryDatabase& db) : db(db) {}
+
+bool MemoryTokenStore::storeToken(const std::string& token, int userId, std::chrono::seconds ttl) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    if (!db.users.count(userId) || db.tokens.count(token)) {
+        return false;
+    }
+    MemoryToken stored;
+    stored.userId = userId;
+    stored.expiresAt = Clock::now() + ttl;
+    db.tokens[token] = stored;
+    return true;
+}
+
+bool MemoryTokenStore::isTokenActive(const std::string& token) {
+    return getUserIdForToken(token) != -1;
+}
+
+int MemoryTokenStore::getUserIdForToken(const std::string& token) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.tokens.find(token);
+    if (it == db.tokens.end() || !it->second.active || it->second.expiresAt <= Clock::now()) {
+        return -1;
+    }
+    return it->second.userId;
+}
+
+std::optional<ActiveToken> MemoryTokenStore::getActiveToken(const std::string& token) {
+    std::shared_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.tokens.find(token);
+    Clock::time_point now = Clock::now();
+    if (it == db.tokens.end() || !it->second.active || it->second.expiresAt <= now) {
+        return std::nullopt;
+    }
+    ActiveToken active;
+    active.userId = it->second.userId;
+    active.expiresIn = std::chrono::duration_cast<std::chrono::seconds>(it->second.expiresAt - now);
+    return active;
+}
+
+void MemoryTokenStore::revokeToken(const std::string& token) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    auto it = db.tokens.find(token);
+    if (it != db.tokens.end()) {
+        it->second.active = false;
+    }
+}
+
+int MemoryTokenStore::deleteExpiredTokens(int limit) {
+    std::unique_lock<std::shared_mutex> lock(db.mutex);
+    Clock::time_point now = Clock::now();
+    int deleted = 0;
+    for (auto it = db.tokens.begin(); it != db.tokens.end() && deleted < limit;) {
+        if (it->second.expiresAt < now) {
+            it = db.tokens.erase(it);
+            ++deleted;
+        } else {
+            ++it;
+        }
+    }
+    return deleted;
+}
+
+// Storage
+
+MemoryStorage::MemoryStorage()
+    : db(std::make_unique<MemoryDatabase>()),
+      reservationStore(*db),
+      tableStore(*db),
+      userStore(*db),
+      restaurantStore(*db),
+      reviewStore(*db),
+      paymentStore(*db),
+      tokenStore(*db) {}
+
+MemoryStorage::~MemoryStorage() = default;
+
+std::unique_ptr<MemoryStorage> MemoryStorage::fromEnvironment() {
+    auto storage = std::make_unique<MemoryStorage>();
+
+    std::string username = EnvLoader::getEnv("MEMORY_ADMIN_USERNAME");
+    std::string passwordHash = EnvLoader::getEnv("MEMORY_ADMIN_PASSWORD_HASH");
+    if (!username.empty() && !passwordHash.empty()) {
+        User admin;
+        admin.setUsername(username);
+        admin.setEmail(EnvLoader::getEnv("MEMORY_ADMIN_EMAIL", username + "@localhost"));
+        admin.setPasswordHash(passwordHash);
+        admin.setEmailVerified(true);
+
+        UserStore& users = storage->users();
+        auto created = users.addUser(admin) ? users.getUserByUsername(username) : std::nullopt;
+        if (created && users.updateUserRole(created->getId(), 2)) {
+            std::cout << "Memory storage: created admin account '" << username << "'" << std::endl;
+        } else {
+            std::cerr << "Memory storage: could not create admin account '" << username << "'" << std::endl;
+        }
+    }
+    return storage;
+}
@@ -0,0 +1,581 @@
+#include "dataAccess/native/nativeConnection.h"
+#include "utils/envLoader.h"
+#include "utils/queryStats.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+struct NativeColumn {
+    enum_field_types type = MYSQL_TYPE_STRING; // buffer type the value was fetched as
+    long long integer = 0;
+    double real = 0.0;
+    MYSQL_TIME time{};
+    std::vector<char> text;
+    unsigned long length = 0;
+    my_bool isNull = 0;
+    my_bool error = 0;
+};
+
+namespace {
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool isTemporal(enum_field_types type) {
+    return type == MYSQL_TYPE_DATE || type == MYSQL_TYPE_NEWDATE || type == MYSQL_TYPE_TIME ||
+           type == MYSQL_TYPE_DATETIME || type == MYSQL_TYPE_TIMESTAMP;
+}
+
+// Picks the client buffer for a result column: integers as 64-bit, FLOAT/DOUBLE as double,
+// temporal types as MYSQL_TIME and everything else (DECIMAL, strings, TEXT, JSON) as text sized
+// from the stored result's max_length, so no value is ever truncated.
+void describeColumn(const MYSQL_FIELD& field, NativeColumn& column, MYSQL_BIND& bind) {
+    switch (field.type) {
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONGLONG:
+    case MYSQL_TYPE_YEAR:
+        column.type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &column.integer;
+        bind.buffer_length = sizeof(column.integer);
+        break;
+    case MYSQL_TYPE_FLOAT:
+    case MYSQL_TYPE_DOUBLE:
+        column.type = MYSQL_TYPE_DOUBLE;
+        bind.buffer = &column.real;
+        bind.buffer_length = sizeof(column.real);
+        break;
+    default:
+        if (isTemporal(field.type)) {
+            column.type = field.type;
+            bind.buffer = &column.time;
+            bind.buffer_length = sizeof(column.time);
+        } else {
+            column.type = MYSQL_TYPE_STRING;
+            column.text.resize(static_cast<std::size_t>(field.max_length) + 1);
+            bind.buffer = column.text.data();
+            bind.buffer_length = static_cast<unsigned long>(column.text.size());
+        }
+        break;
+    }
+    bind.buffer_type = column.type;
+    bind.length = &column.length;
+    bind.is_null = &column.isNull;
+    bind.error = &column.error;
+}
+
+// MariaDB's text form of a temporal value, as the ODBC driver returns it
+std::string formatTime(const MYSQL_TIME& time) {
+    char buffer[64];
+    switch (time.time_type) {
+    case MYSQL_TIMESTAMP_DATE:
+        std::snprintf(buffer, sizeof(buffer), "%04u-%02u-%02u", time.year, time.month, time.day);
+        break;
+    case MYSQL_TIMESTAMP_TIME:
+        std::snprintf(buffer, sizeof(buffer), "%s%02u:%02u:%02u", time.neg ? "-" : "",
+                      time.day * 24 + time.hour, time.minute, time.second);
+        break;
+    default:
+        std::snprintf(buffer, sizeof(buffer), "%04u-%02u-%02u %02u:%02u:%02u", time.year, time.month, time.day,
+                      time.hour, time.minute, time.second);
+        break;
+    }
+    std::string text(buffer);
+    if (time.second_part != 0) {
+        std::snprintf(buffer, sizeof(buffer), ".%06lu", time.second_part);
+        text += buffer;
+    }
+    return text;
+}
+
+// Frees the buffered result on every exit, including a throwing visit callback, so the cached
+// statement can be executed again
+class StoredResult {
+public:
+    explicit StoredResult(MYSQL_STMT* handle) : handle(handle), metadata(nullptr) {}
+    ~StoredResult() {
+        if (metadata) {
+            mysql_free_result(metadata);
+        }
+        mysql_stmt_free_result(handle);
+    }
+    StoredResult(const StoredResult&) = delete;
+    StoredResult& operator=(const StoredResult&) = delete;
+
+    MYSQL_STMT* handle;
+    MYSQL_RES* metadata;
+};
+
+} // namespace
+
+NativeConnectionConfig NativeConnectionConfig::fromEnvironment() {
+    NativeConnectionConfig config;
+    config.host = EnvLoader::getEnv("DB_HOST", config.host);
+    config.port = static_cast<unsigned int>(EnvLoader::getEnvSize("DB_PORT", config.port));
+    config.database = EnvLoader::getEnv("DB_NAME", config.database);
+    config.user = EnvLoader::getEnv("DB_USER", config.user);
+    config.password = EnvLoader::getEnv("DB_PASSWORD", config.password);
+    config.pool = ConnectionPoolConfig::fromEnvironment();
+    config.pool.name = "native";
+    return config;
+}
+
+NativeDbError::NativeDbError(const std::string& message, unsigned int code)
+    : std::runtime_error(message), code(code) {}
+
+bool NativeDbError::connectionLost() const {
+    return code >= CR_MIN_ERROR;
+}
+
+NativeParams& NativeParams::add(int value) {
+    return add(static_cast<long long>(value));
+}
+
+NativeParams& NativeParams::add(long long value) {
+    Value param;
+    param.type = MYSQL_TYPE_LONGLONG;
+    param.integer = value;
+    values.push_back(std::move(param));
+    return *this;
+}
+
+NativeParams& NativeParams::add(double value) {
+    Value param;
+    param.type = MYSQL_TYPE_DOUBLE;
+    param.real = value;
+    values.push_back(std::move(param));
+    return *this;
+}
+
+NativeParams& NativeParams::add(const std::string& value) {
+    Value param;
+    param.type = MYSQL_TYPE_STRING;
+    param.text = value;
+    param.length = static_cast<unsigned long>(value.size());
+    values.push_back(std::move(param));
+    return *this;
+}
+
+NativeParams& NativeParams::addNull() {
+    Value param;
+    param.type = MYSQL_TYPE_NULL;
+    param.isNull = 1;
+    values.push_back(std::move(param));
+    return *this;
+}
+
+std::size_t NativeParams::size() const {
+    return values.size();
+}
+
+NativeRow::NativeRow(const std::vector<NativeColumn>& columns) : columnData(&columns) {}
+
+short NativeRow::columns() const {
+    return static_cast<short>(columnData->size());
+}
+
+const NativeColumn& NativeRow::at(short column) const {
+    if (column < 0 || static_cast<std::size_t>(column) >= columnData->size()) {
+        throw nanodbc::index_range_error();
+    }
+    return (*columnData)[column];
+}
+
+bool NativeRow::isNull(short column) const {
+    return at(column).isNull != 0;
+}
+
+template <>
+long long NativeRow::get<long long>(short column) const {
+    const NativeColumn& data = at(column);
+    if (data.isNull) {
+        throw nanodbc::null_access_error();
+    }
+    if (data.type == MYSQL_TYPE_LONGLONG) {
+        return data.integer;
+    }
+    if (data.type == MYSQL_TYPE_DOUBLE) {
+        return static_cast<long long>(data.real);
+    }
+    return std::stoll(get<std::string>(column));
+}
+
+template <>
+int NativeRow::get<int>(short column) const {
+    return static_cast<int>(get<long long>(column));
+}
+
+template <>
+bool NativeRow::get<bool>(short column) const {
+    return get<long long>(column) != 0;
+}
+
+template <>
+double NativeRow::get<double>(short column) const {
+    const NativeColumn& data = at(column);
+    if (data.isNull) {
+        throw nanodbc::null_access_error();
+    }
+    if (data.type == MYSQL_TYPE_DOUBLE) {
+        return data.real;
+    }
+    if (data.type == MYSQL_TYPE_LONGLONG) {
+        return static_cast<double>(data.integer);
+    }
+    return std::stod(get<std::string>(column));
+}
+
+template <>
+float NativeRow::get<float>(short column) const {
+    return static_cast<float>(get<double>(column));
+}
+
+template <>
+std::string NativeRow::get<std::string>(short column) const {
+    const NativeColumn& data = at(column);
+    if (data.isNull) {
+        throw nanodbc::null_access_error();
+    }
+    if (data.type == MYSQL_TYPE_LONGLONG) {
+        return std::to_string(data.integer);
+    }
+    if (data.type == MYSQL_TYPE_DOUBLE) {
+        std::ostringstream out;
+        out.precision(std::numeric_limits<double>::max_digits10);
+        out << data.real;
+        return out.str();
+    }
+    if (isTemporal(data.type)) {
+        return formatTime(data.time);
+    }
+    return std::string(data.text.data(), std::min<std::size_t>(data.length, data.text.size()));
+}
+
+NativeSession::~NativeSession() {
+    for (auto& statement : statements) {
+        mysql_stmt_close(statement.handle);
+    }
+    if (mysql) {
+        mysql_close(mysql);
+    }
+}
+
+NativeConnection::NativeConnection(NativeConnectionPool* pool, std::unique_ptr<NativeSession> session, std::string caller)
+    : pool(pool), session(std::move(session)), caller(std::move(caller)), broken(false), insertId(0) {}
+
+NativeConnection::NativeConnection(NativeConnection&& other) noexcept
+    : pool(other.pool), session(std::move(other.session)), caller(std::move(other.caller)),
+      broken(other.broken), insertId(other.insertId) {
+    other.pool = nullptr;
+}
+
+NativeConnection& NativeConnection::operator=(NativeConnection&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool = other.pool;
+        session = std::move(other.session);
+        caller = std::move(other.caller);
+        broken = other.broken;
+        insertId = other.insertId;
+        other.pool = nullptr;
+    }
+    return *this;
+}
+
+NativeConnection::~NativeConnection() {
+    release();
+}
+
+void NativeConnection::release() {
+    if (pool && session) {
+        pool->release(std::move(session), broken);
+    }
+    pool = nullptr;
+}
+
+void NativeConnection::fail(MYSQL_STMT* handle, const char* call) {
+    NativeDbError error(std::string(call) + ": " + mysql_stmt_error(handle), mysql_stmt_errno(handle));
+    if (error.connectionLost()) {
+        broken = true;
+    }
+    throw error;
+}
+
+NativeSession::Statement& NativeConnection::prepare(const std::string& sql) {
+    auto it = session->index.find(sql);
+    if (it != session->index.end()) {
+        session->statements.splice(session->statements.begin(), session->statements, it->second);
+        return *it->second;
+    }
+
+    MYSQL_STMT* handle = mysql_stmt_init(session->mysql);
+    if (!handle) {
+        broken = true;
+        throw NativeDbError(std::string("mysql_stmt_init: ") + mysql_error(session->mysql), mysql_errno(session->mysql));
+    }
+    if (mysql_stmt_prepare(handle, sql.c_str(), static_cast<unsigned long>(sql.size())) != 0) {
+        NativeDbError error(std::string("mysql_stmt_prepare: ") + mysql_stmt_error(handle), mysql_stmt_errno(handle));
+        mysql_stmt_close(handle);
+        broken = broken || error.connectionLost();
+        throw error;
+    }
+    my_bool updateMaxLength = 1;
+    mysql_stmt_attr_set(handle, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+
+    std::size_t capacity = std::max<std::size_t>(1, pool->getConfig().pool.statementCacheSize);
+    if (session->statements.size() >= capacity) {
+        mysql_stmt_close(session->statements.back().handle);
+        session->index.erase(session->statements.back().sql);
+        session->statements.pop_back();
+    }
+    session->statements.push_front(NativeSession::Statement{sql, QueryStats::fingerprint(sql), handle});
+    session->index[sql] = session->statements.begin();
+    return session->statements.front();
+}
+
+MYSQL_STMT* NativeConnection::run(NativeSession::Statement& statement, const NativeParams& params) {
+    MYSQL_STMT* handle = statement.handle;
+    if (mysql_stmt_param_count(handle) != params.size()) {
+        throw NativeDbError("Statement expects " + std::to_string(mysql_stmt_param_count(handle)) + " parameters, got " +
+                            std::to_string(params.size()), 0);
+    }
+
+    // Connector/C only reads parameter buffers, so binding the caller's values in place is safe
+    std::vector<MYSQL_BIND> binds(params.size());
+    for (std::size_t i = 0; i < params.size(); ++i) {
+        auto& value = const_cast<NativeParams::Value&>(params.values[i]);
+        MYSQL_BIND& bind = binds[i];
+        bind = MYSQL_BIND{};
+        bind.buffer_type = value.type;
+        bind.is_null = &value.isNull;
+        switch (value.type) {
+        case MYSQL_TYPE_LONGLONG:
+            bind.buffer = &value.integer;
+            break;
+        case MYSQL_TYPE_DOUBLE:
+            bind.buffer = &value.real;
+            break;
+        case MYSQL_TYPE_STRING:
+            bind.buffer = const_cast<char*>(value.text.data());
+            bind.buffer_length = value.length;
+            bind.length = &value.length;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (!binds.empty() && mysql_stmt_bind_param(handle, binds.data()) != 0) {
+        fail(handle, "mysql_stmt_bind_param");
+    }
+    if (mysql_stmt_execute(handle) != 0) {
+        fail(handle, "mysql_stmt_execute");
+    }
+    return handle;
+}
+
+void NativeConnection::record(const NativeSession::Statement& statement, const NativeParams& params,
+                              std::chrono::steady_clock::time_point start, double excludedMs, long rows, bool failed) {
+    QueryStats::instance().recordStatement(caller, statement.fingerprint,
+                                           std::to_string(params.size()) + " params, binary protocol",
+                                           elapsedMs(start) - excludedMs, rows, failed);
+}
+
+long NativeConnection::query(const std::string& sql, const NativeParams& params,
+                             const std::function<void(const NativeRow&)>& visit) {
+    NativeSession::Statement& statement = prepare(sql);
+    auto start = std::chrono::steady_clock::now();
+    double visitMs = 0.0;
+    try {
+        MYSQL_STMT* handle = run(statement, params);
+        StoredResult result(handle);
+        if (mysql_stmt_store_result(handle) != 0) {
+            fail(handle, "mysql_stmt_store_result");
+        }
+        result.metadata = mysql_stmt_result_metadata(handle);
+        if (!result.metadata) {
+            record(statement, params, start, 0.0, 0, false);
+            return 0;
+        }
+
+        unsigned int count = mysql_num_fields(result.metadata);
+        MYSQL_FIELD* fields = mysql_fetch_fields(result.metadata);
+        std::vector<NativeColumn> columns(count);
+        std::vector<MYSQL_BIND> binds(count);
+        for (unsigned int i = 0; i < count; ++i) {
+            binds[i] = MYSQL_BIND{};
+            describeColumn(fields[i], columns[i], binds[i]);
+        }
+        if (mysql_stmt_bind_result(handle, binds.data()) != 0) {
+            fail(handle, "mysql_stmt_bind_result");
+        }
+
+        long rows = 0;
+        for (;;) {
+            int rc = mysql_stmt_fetch(handle);
+            if (rc == MYSQL_NO_DATA) {
+                break;
+            }
+            if (rc == MYSQL_DATA_TRUNCATED) {
+                throw NativeDbError("mysql_stmt_fetch: value truncated despite max_length sizing", 0);
+            }
+            if (rc != 0) {
+                fail(handle, "mysql_stmt_fetch");
+            }
+            auto visitStart = std::chrono::steady_clock::now();
+            visit(NativeRow(columns));
+            visitMs += elapsedMs(visitStart);
+            ++rows;
+        }
+        record(statement, params, start, visitMs, rows, false);
+        return rows;
+    } catch (const std::runtime_error&) {
+        record(statement, params, start, visitMs, 0, true);
+        throw;
+    }
+}
+
+long NativeConnection::execute(const std::string& sql, const NativeParams& params) {
+    NativeSession::Statement& statement = prepare(sql);
+    auto start = std::chrono::steady_clock::now();
+    try {
+        MYSQL_STMT* handle = run(statement, params);
+        long affected = static_cast<long>(mysql_stmt_affected_rows(handle));
+        insertId = static_cast<long long>(mysql_stmt_insert_id(handle));
+        mysql_stmt_free_result(handle);
+        record(statement, params, start, 0.0, affected, false);
+        return affected;
+    } catch (const std::runtime_error&) {
+        record(statement, params, start, 0.0, 0, true);
+        throw;
+    }
+}
+
+long long NativeConnection::lastInsertId() const {
+    return insertId;
+}
+
+NativeConnectionPool::NativeConnectionPool(const NativeConnectionConfig& config) : config(config), total(0) {
+    // Not thread-safe; the pool is created once, before any session is opened
+    mysql_library_init(0, nullptr, nullptr);
+    std::cout << "Native MariaDB connection pool ready (max " << config.pool.maxSize << ")" << std::endl;
+}
+
+NativeConnectionPool::~NativeConnectionPool() {
+    std::lock_guard<std::mutex> lock(mutex);
+    idle.clear();
+}
+
+NativeConnectionPool& NativeConnectionPool::instance() {
+    static NativeConnectionPool pool(NativeConnectionConfig::fromEnvironment());
+    return pool;
+}
+
+const NativeConnectionConfig& NativeConnectionPool::getConfig() const {
+    return config;
+}
+
+std::unique_ptr<NativeSession> NativeConnectionPool::openSession() {
+    auto session = std::make_unique<NativeSession>();
+    session->mysql = mysql_init(nullptr);
+    if (!session->mysql) {
+        throw NativeDbError("mysql_init: out of memory", 0);
+    }
+    unsigned int connectTimeout = static_cast<unsigned int>(
+        std::max<long long>(1, std::chrono::duration_cast<std::chrono::seconds>(config.pool.borrowTimeout).count()));
+    mysql_options(session->mysql, MYSQL_OPT_CONNECT_TIMEOUT, &connectTimeout);
+    mysql_options(session->mysql, MYSQL_SET_CHARSET_NAME, "utf8mb4");
+    if (!mysql_real_connect(session->mysql, config.host.c_str(), config.user.c_str(), config.password.c_str(),
+                            config.database.c_str(), config.port, nullptr, 0)) {
+        throw NativeDbError(std::string("mysql_real_connect: ") + mysql_error(session->mysql), mysql_errno(session->mysql));
+    }
+    session->lastUsed = std::chrono::steady_clock::now();
+    session->lastValidated = session->lastUsed;
+    return session;
+}
+
+bool NativeConnectionPool::validate(NativeSession& session) {
+    auto now = std::chrono::steady_clock::now();
+    if (now - session.lastValidated < config.pool.validationInterval) {
+        return true;
+    }
+    if (mysql_ping(session.mysql) != 0) {
+        std::cerr << "Discarding stale native connection: " << mysql_error(session.mysql) << std::endl;
+        return false;
+    }
+    session.lastValidated = now;
+    return true;
+}
+
+NativeConnection NativeConnectionPool::acquire(const std::string& caller) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + config.pool.borrowTimeout;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        if (!idle.empty()) {
+            std::unique_ptr<NativeSession> session = std::move(idle.back());
+            idle.pop_back();
+            lock.unlock();
+
+            if (validate(*session)) {
+                QueryStats::instance().recordAcquire(caller, elapsedMs(start));
+                return NativeConnection(this, std::move(session), caller);
+            }
+
+            session.reset();
+            lock.lock();
+            --total;
+            continue;
+        }
+
+        if (total < config.pool.maxSize) {
+            ++total;
+            lock.unlock();
+
+            try {
+                auto session = openSession();
+                QueryStats::instance().recordAcquire(caller, elapsedMs(start));
+                return NativeConnection(this, std::move(session), caller);
+            } catch (...) {
+                lock.lock();
+                --total;
+                available.notify_one();
+                throw;
+            }
+        }
+
+        if (!available.wait_until(lock, deadline, [this] { return !idle.empty() || total < config.pool.maxSize; })) {
+            throw ConnectionPoolError("Timed out after " + std::to_string(config.pool.borrowTimeout.count()) +
+                                      "ms waiting for a native database connection (max " +
+                                      std::to_string(config.pool.maxSize) + ")");
+        }
+    }
+}
+
+void NativeConnectionPool::release(std::unique_ptr<NativeSession> session, bool broken) {
+    std::unique_ptr<NativeSession> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (broken) {
+            --total;
+            dropped = std::move(session);
+        } else {
+            session->lastUsed = std::chrono::steady_clock::now();
+            idle.push_back(std::move(session));
+        }
+    }
+    available.notify_one();
+    // dropped closes its socket here, outside the lock
+}
+
+NativeDbConnection::NativeDbConnection(std::string owner) : owner(std::move(owner)) {}
+
+NativeConnection NativeDbConnection::getConnection(const char* method) {
+    return NativeConnectionPool::instance().acquire(owner + "::" + method);
+}
@@ -0,0 +1,357 @@
+#include "dataAccess/native/nativeStores.h"
+#include "utils/stripedMutex.h"
+#include <iostream>
+
+namespace {
+
+// Same overlap test as ReservationData's conflict checks, parameterised identically
+const std::string overlapCondition =
+    "((r.start_time < ? AND r.end_time > ?) OR "
+    " (r.start_time < ? AND r.end_time > ?) OR "
+    " (r.start_time >= ? AND r.end_time <= ?))";
+
+void addOverlapParams(NativeParams& params, const std::string& startTime, const std::string& endTime) {
+    params.add(startTime).add(startTime).add(endTime).add(endTime).add(startTime).add(endTime);
+}
+
+const std::string reservationColumns =
+    "id, user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, "
+    "special_requests, phone_number, email, total_amount, payment_status, payment_method";
+
+Reservation reservationFromRow(const NativeRow& row) {
+    Reservation reservation;
+    reservation.setId(row.get<int>(0));
+    reservation.setUserId(row.get<int>(1));
+    reservation.setTableId(row.get<int>(2));
+    reservation.setRestaurantId(row.get<int>(3));
+    reservation.setDate(row.get<std::string>(4, ""));
+    reservation.setStartTime(row.get<std::string>(5, ""));
+    reservation.setEndTime(row.get<std::string>(6, ""));
+    reservation.setGuestCount(row.get<int>(7));
+    reservation.setStatus(row.get<std::string>(8, ""));
+    reservation.setSpecialRequests(row.get<std::string>(9, ""));
+    reservation.setPhoneNumber(row.get<std::string>(10, ""));
+    reservation.setEmail(row.get<std::string>(11, ""));
+    reservation.setTotalAmount(row.get<double>(12, 0.0));
+    reservation.setPaymentStatus(row.get<std::string>(13, ""));
+    reservation.setPaymentMethod(row.get<std::string>(14, ""));
+    return reservation;
+}
+
+// Columns of UserData::getUserByUsername/getUserByEmail: the whole user, so login needs no
+// second lookup, plus the email verification state
+const std::string loginColumns =
+    "id, username, email, password_hash, role_id, first_name, last_name, phone_number, is_active, created_at, "
+    "email_verified, email_verification_token, email_verification_expires";
+
+User loginUserFromRow(const NativeRow& row) {
+    User user;
+    user.setId(row.get<int>(0));
+    user.setUsername(row.get<std::string>(1, ""));
+    user.setEmail(row.get<std::string>(2, ""));
+    user.setPasswordHash(row.get<std::string>(3, ""));
+    user.setRoleId(row.get<int>(4, 1));
+    user.setFirstName(row.get<std::string>(5, ""));
+    user.setLastName(row.get<std::string>(6, ""));
+    user.setPhoneNumber(row.get<std::string>(7, ""));
+    user.setActive(row.get<int>(8, 1) == 1);
+    user.setCreatedAt(row.get<std::string>(9, ""));
+    user.setEmailVerified(row.get<int>(10, 0) == 1);
+    user.setEmailVerificationToken(row.get<std::string>(11, ""));
+    user.setEmailVerificationExpires(row.get<std::string>(12, ""));
+    return user;
+}
+
+// Bookers for the same table queue here instead of each holding a session while waiting on the
+// database row lock, as in ReservationData
+StripedMutex bookingLocks(128);
+
+} // namespace
+
+std::vector<Reservation> NativeReservationStore::getReservationsByUserId(int userId) {
+    std::vector<Reservation> reservations;
+    try {
+        NativeConnection conn = nativeConnection.getConnection();
+        conn.query("SELECT " + reservationColumns + " FROM reservations WHERE user_id = ?", NativeParams().add(userId),
+                   [&](const NativeRow& row) {
+                       reservations.push_back(reservationFromRow(row));
+                   });
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in getReservationsByUserId: " << e.what() << std::endl;
+    }
+    return reservations;
+}
+
+std::optional<Reservation> NativeReservationStore::getReservationById(int id) {
+    std::optional<Reservation> reservation;
+    try {
+        NativeConnection conn = nativeConnection.getConnection();
+        conn.query("SELECT " + reservationColumns + " FROM reservations WHERE id = ?", NativeParams().add(id),
+                   [&](const NativeRow& row) {
+                       reservation = reservationFromRow(row);
+                   });
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in getReservationById: " << e.what() << std::endl;
+    }
+    return reservation;
+}
+
+bool NativeReservationStore::isTableAvailable(int tableId, const std::string& date, const std::string& startTime, const std::string& endTime, int excludeReservationId) {
+    std::string sql = "SELECT COUNT(*) FROM reservations r WHERE r.table_id = ? AND r.date = ? AND r.status != 'cancelled' AND " +
+                      overlapCondition;
+    NativeParams params;
+    params.add(tableId).add(date);
+    addOverlapParams(params, startTime, endTime);
+    if (excludeReservationId > 0) {
+        sql += " AND r.id != ?";
+        params.add(excludeReservationId);
+    }
+
+    try {
+        NativeConnection conn = nativeConnection.getConnection();
+        long long conflicts = -1;
+        conn.query(sql, params, [&](const NativeRow& row) {
+            conflicts = row.get<long long>(0);
+        });
+        return conflicts == 0;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in isTableAvailable: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+std::optional<Reservation> NativeReservationStore::addReservationIfAvailable(const Reservation& reservation) {
+    const std::string& startTime = reservation.getStartTime();
+    const std::string& endTime = reservation.getEndTime();
+
+    NativeParams insertParams;
+    insertParams.add(reservation.getUserId())
+        .add(reservation.getRestaurantId())
+        .add(reservation.getDate())
+        .add(startTime)
+        .add(endTime)
+        .add(reservation.getGuestCount())
+        .add(reservation.getStatus())
+        .add(reservation.getSpecialRequests())
+        .add(reservation.getPhoneNumber())
+        .add(reservation.getEmail())
+        .add(reservation.getTotalAmount())
+        .add(reservation.getPaymentStatus())
+        .add(reservation.getPaymentMethod())
+        .add(reservation.getConfirmationToken())
+        .add(reservation.getTableId())
+        .add(reservation.getRestaurantId())
+        .add(reservation.getDate());
+    addOverlapParams(insertParams, startTime, endTime);
+
+    std::lock_guard<std::mutex> tableLock(bookingLocks.forKey(reservation.getTableId()));
+    try {
+        NativeConnection conn = nativeConnection.getConnection();
+
+        // Same single-statement check-and-insert as ReservationData::addReservationIfAvailable:
+        // FOR UPDATE on the tables row serialises bookings for the table across server processes
+        long inserted = conn.execute(
+            "INSERT INTO reservations (user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, "
+            "special_requests, phone_number, email, total_amount, payment_status, payment_method, confirmation_token) "
+            "SELECT ?, t.id, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ? FROM tables t "
+            "WHERE t.id = ? AND t.restaurant_id = ? AND NOT EXISTS ("
+            "SELECT 1 FROM reservations r WHERE r.table_id = t.id AND r.date = ? AND r.status != 'cancelled' AND " +
+                overlapCondition + ") FOR UPDATE",
+            insertParams);
+        if (inserted == 0) {
+            return std::nullopt; // Slot taken, or no such table in this restaurant
+        }
+
+        // The generated id comes back in the OK packet, so only the names need a second round trip.
+        // The insert is already committed: from here on a failure must not report the slot as taken.
+        Reservation booked = reservation;
+        booked.setId(static_cast<int>(conn.lastInsertId()));
+        try {
+            conn.query(
+                "SELECT u.username, u.first_name, u.last_name, u.email, r.name "
+                "FROM (SELECT 1) booking "
+                "LEFT JOIN users u ON u.id = ? "
+                "LEFT JOIN restaurants r ON r.id = ?",
+                NativeParams().add(reservation.getUserId()).add(reservation.getRestaurantId()),
+                [&](const NativeRow& row) {
+                    booked.setRestaurantName(row.get<std::string>(4, ""));
+                    std::string customerName = row.get<std::string>(1, "") + " " + row.get<std::string>(2, "");
+                    if (customerName == " ") {
+                        customerName = row.get<std::string>(0, "");
+                    }
+                    booked.setCustomerName(customerName);
+                    if (booked.getEmail().empty()) {
+                        booked.setEmail(row.get<std::string>(3, ""));
+                    }
+                });
+        } catch (const std::runtime_error& e) {
+            // Booked with empty display fields; the confirmation email falls back to what the request carried
+            std::cerr << "Database error reading booking details in addReservationIfAvailable: " << e.what() << std::endl;
+        }
+        return booked;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in addReservationIfAvailable: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
+std::vector<int> NativeReservationStore::getAvailableTableIds(int restaurantId, const std::string& date, const std::string& startTime, const std::string& endTime, int minCapacity) {
+    std::vector<int> availableTableIds;
+    std::string sql = "SELECT t.id FROM tables t WHERE t.restaurant_id = ?";
+    NativeParams params;
+    params.add(restaurantId);
+    if (minCapacity > 0) {
+        sql += " AND t.capacity >= ?";
+        params.add(minCapacity);
+    }
+    sql += " AND t.id NOT IN ("
+           "SELECT DISTINCT r.table_id FROM reservations r "
+           "WHERE r.date = ? AND r.status != 'cancelled' AND " + overlapCondition + ")";
+    params.add(date);
+    addOverlapParams(params, startTime, endTime);
+
+    try {
+        NativeConnection conn = nativeConnection.getConnection();
+        conn.query(sql, params, [&](const NativeRow& row) {
+            availableTableIds.push_back(row.get<int>(0));
+        });
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in getAvailableTableIds: " << e.what() << std::endl;
+    }
+    return availableTableIds;
+}
+
+std::optional<User> NativeUserStore::getUserById(int id) {
+    std::optional<User> user;
+    ensureRolesLoaded();
+    try {
+        NativeConnection conn = nativeConnection.getConnection();
+        conn.query(
+            "SELECT u.id, u.username, u.email, u.password_hash, u.role_id, u.first_name, u.last_name, "
+            "u.phone_number, u.is_active, u.created_at FROM users u WHERE u.id = ?",
+            NativeParams().add(id),
+            [&](const NativeRow& row) {
+                User found;
+                found.setId(row.get<int>(0));
+                found.setUsername(row.get<std::string>(1, ""));
+                found.setEmail(row.get<std::string>(2, ""));
+                found.setPasswordHash(row.get<std::string>(3, ""));
+                found.setRoleId(row.get<int>(4, 1));
+                found.setFirstName(row.get<std::string>(5, ""));
+                found.setLastName(row.get<std::string>(6, ""));
+                found.setPhoneNumber(row.get<std::string>(7, ""));
+                found.setActive(row.get<int>(8, 1) == 1);
+                found.setCreatedAt(row.get<std::string>(9, ""));
+                applyRole(found);
+                user = found;
+            });
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in getUserById: " << e.what() << std::endl;
+    }
+    return user;
+}
+
+std::optional<User> NativeUserStore::getUserByUsername(const std::string& username) {
+    std::optional<User> user;
+    ensureRolesLoaded();
+    try {
+        NativeConnection conn = nativeConnection.getConnection();
+        conn.query("SELECT " + loginColumns + " FROM users WHERE username = ?", NativeParams().add(username),
+                   [&](const NativeRow& row) {
+                       user = loginUserFromRow(row);
+                       applyRole(*user);
+                   });
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in getUserByUsername: " << e.what() << std::endl;
+    }
+    return user;
+}
+
+std::optional<User> NativeUserStore::getUserByEmail(const std::string& email) {
+    std::optional<User> user;
+    ensureRolesLoaded();
+    try {
+        NativeConnection conn = nativeConnection.getConnection();
+        conn.query("SELECT " + loginColumns + " FROM users WHERE email = ?", NativeParams().add(email),
+                   [&](const NativeRow& row) {
+                       user = loginUserFromRow(row);
+                       applyRole(*user);
+                   });
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in getUserByEmail: " << e.what() << std::endl;
+    }
+    return user;
+}
+
+bool NativeTokenStore::storeToken(const std::string& token, int userId, std::chrono::seconds ttl) {
+    try {
+        NativeConnection conn = nativeConnection.getConnection();
+        conn.execute("INSERT INTO user_tokens (token, user_id, expires_at) VALUES (?, ?, DATE_ADD(NOW(), INTERVAL ? SECOND))",
+                     NativeParams().add(token).add(userId).add(static_cast<long long>(ttl.count())));
+        return true;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in storeToken: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool NativeTokenStore::isTokenActive(const std::string& token) {
+    return getUserIdForToken(token) != -1;
+}
+
+int NativeTokenStore::getUserIdForToken(const std::string& token) {
+    try {
+        NativeConnection conn = nativeConnection.getConnection();
+        int userId = -1;
+        conn.query("SELECT user_id FROM user_tokens WHERE token = ? AND is_active = TRUE AND (expires_at IS NULL OR expires_at > NOW())",
+                   NativeParams().add(token),
+                   [&](const NativeRow& row) {
+                       userId = row.get<int>(0);
+                   });
+        return userId;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in getUserIdForToken: " << e.what() << std::endl;
+        return -1;
+    }
+}
+
+std::optional<ActiveToken> NativeTokenStore::getActiveToken(const std::string& token) {
+    try {
+        NativeConnection conn = nativeConnection.getConnection();
+        std::optional<ActiveToken> active;
+        conn.query("SELECT user_id, TIMESTAMPDIFF(SECOND, NOW(), expires_at) FROM user_tokens WHERE token = ? AND is_active = TRUE AND (expires_at IS NULL OR expires_at > NOW())",
+                   NativeParams().add(token),
+                   [&](const NativeRow& row) {
+                       active = ActiveToken();
+                       active->userId = row.get<int>(0);
+                       if (!row.isNull(1)) {
+                           active->expiresIn = std::chrono::seconds(row.get<long long>(1));
+                       }
+                   });
+        return active;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in getActiveToken: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
+void NativeTokenStore::revokeToken(const std::string& token) {
+    try {
+        NativeConnection conn = nativeConnection.getConnection();
+        conn.execute("UPDATE user_tokens SET is_active = FALSE WHERE token = ?", NativeParams().add(token));
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in revokeToken: " << e.what() << std::endl;
+    }
+}
+
+int NativeTokenStore::deleteExpiredTokens(int limit) {
+    try {
+        NativeConnection conn = nativeConnection.getConnection();
+        return static_cast<int>(conn.execute(
+            "DELETE FROM user_tokens WHERE expires_at IS NOT NULL AND expires_at < NOW() ORDER BY expires_at LIMIT ?",
+            NativeParams().add(limit)));
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in deleteExpiredTokens: " << e.what() << std::endl;
+        return -1;
+    }
+}
@@ -2,34 +2,44 @@
 #include <nanodbc/nanodbc.h>
 #include <iostream>
 
-PaymentData::PaymentData() {}
+namespace {
+
+// SELECT list of the multi-row payment queries, read by position in paymentFromRow
+const std::string paymentColumns =
+    "id, reservation_id, user_id, amount, payment_method, payment_status, transaction_id, card_last_four, "
+    "card_type, cardholder_name, billing_address, created_at, updated_at";
+
+Payment paymentFromRow(const RowsetRow& row) {
+    Payment payment;
+    payment.setId(row.get<int>(0));
+    payment.setReservationId(row.get<int>(1));
+    payment.setUserId(row.get<int>(2));
+    payment.setAmount(row.get<double>(3, 0.0));
+    payment.setPaymentMethod(row.get<nanodbc::string>(4, ""));
+    payment.setPaymentStatus(row.get<nanodbc::string>(5, ""));
+    payment.setTransactionId(row.get<nanodbc::string>(6, ""));
+    payment.setCardLastFour(row.get<nanodbc::string>(7, ""));
+    payment.setCardType(row.get<nanodbc::string>(8, ""));
+    payment.setCardholderName(row.get<nanodbc::string>(9, ""));
+    payment.setBillingAddress(row.get<nanodbc::string>(10, ""));
+    payment.setCreatedAt(row.get<nanodbc::string>(11, ""));
+    payment.setUpdatedAt(row.get<nanodbc::string>(12, ""));
+    return payment;
+}
+
+} // namespace
+
+PaymentData::PaymentData(DbContext& context) : dbConnection("PaymentData", context) {}
 
 std::vector<Payment> PaymentData::getAllPayments() {
     std::vector<Payment> payments;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, reservation_id, user_id, amount, payment_method, payment_status, transaction_id, card_last_four, card_type, cardholder_name, billing_address, created_at, updated_at FROM payments");
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            Payment payment;
-            payment.setId(result.get<int>("id"));
-            payment.setReservationId(result.get<int>("reservation_id"));
-            payment.setUserId(result.get<int>("user_id"));
-            payment.setAmount(result.get<double>("amount", 0.0));
-            payment.setPaymentMethod(result.get<nanodbc::string>("payment_method", ""));
-            payment.setPaymentStatus(result.get<nanodbc::string>("payment_status", ""));
-            payment.setTransactionId(result.get<nanodbc::string>("transaction_id", ""));
-            payment.setCardLastFour(result.get<nanodbc::string>("card_last_four", ""));
-            payment.setCardType(result.get<nanodbc::string>("card_type", ""));
-            payment.setCardholderName(result.get<nanodbc::string>("cardholder_name", ""));
-            payment.setBillingAddress(result.get<nanodbc::string>("billing_address", ""));
-            payment.setCreatedAt(result.get<nanodbc::string>("created_at", ""));
-            payment.setUpdatedAt(result.get<nanodbc::string>("updated_at", ""));
-            payments.push_back(payment);
-        }
-    } catch (const nanodbc::database_error& e) {
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT " + paymentColumns + " FROM payments");
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            payments.push_back(paymentFromRow(row));
+        });
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getAllPayments: " << e.what() << std::endl;
     }
     return payments;
@@ -38,30 +48,13 @@ std::vector<Payment> PaymentData::getAllPayments() {
 std::vector<Payment> PaymentData::getPaymentsByUserId(int userId) {
     std::vector<Payment> payments;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, reservation_id, user_id, amount, payment_method, payment_status, transaction_id, card_last_four, card_type, cardholder_name, billing_address, created_at, updated_at FROM payments WHERE user_id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT " + paymentColumns + " FROM payments WHERE user_id = ?");
         stmt.bind(0, &userId);
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            Payment payment;
-            payment.setId(result.get<int>("id"));
-            payment.setReservationId(result.get<int>("reservation_id"));
-            payment.setUserId(result.get<int>("user_id"));
-            payment.setAmount(result.get<double>("amount", 0.0));
-            payment.setPaymentMethod(result.get<nanodbc::string>("payment_method", ""));
-            payment.setPaymentStatus(result.get<nanodbc::string>("payment_status", ""));
-            payment.setTransactionId(result.get<nanodbc::string>("transaction_id", ""));
-            payment.setCardLastFour(result.get<nanodbc::string>("card_last_four", ""));
-            payment.setCardType(result.get<nanodbc::string>("card_type", ""));
-            payment.setCardholderName(result.get<nanodbc::string>("cardholder_name", ""));
-            payment.setBillingAddress(result.get<nanodbc::string>("billing_address", ""));
-            payment.setCreatedAt(result.get<nanodbc::string>("created_at", ""));
-            payment.setUpdatedAt(result.get<nanodbc::string>("updated_at", ""));
-            payments.push_back(payment);
-        }
-    } catch (const nanodbc::database_error& e) {
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            payments.push_back(paymentFromRow(row));
+        });
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getPaymentsByUserId: " << e.what() << std::endl;
     }
     return payments;
@@ -70,30 +63,13 @@ std::vector<Payment> PaymentData::getPaymentsByUserId(int userId) {
 std::vector<Payment> PaymentData::getPaymentsByReservationId(int reservationId) {
     std::vector<Payment> payments;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, reservation_id, user_id, amount, payment_method, payment_status, transaction_id, card_last_four, card_type, cardholder_name, billing_address, created_at, updated_at FROM payments WHERE reservation_id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT " + paymentColumns + " FROM payments WHERE reservation_id = ?");
         stmt.bind(0, &reservationId);
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            Payment payment;
-            payment.setId(result.get<int>("id"));
-            payment.setReservationId(result.get<int>("reservation_id"));
-            payment.setUserId(result.get<int>("user_id"));
-            payment.setAmount(result.get<double>("amount", 0.0));
-            payment.setPaymentMethod(result.get<nanodbc::string>("payment_method", ""));
-            payment.setPaymentStatus(result.get<nanodbc::string>("payment_status", ""));
-            payment.setTransactionId(result.get<nanodbc::string>("transaction_id", ""));
-            payment.setCardLastFour(result.get<nanodbc::string>("card_last_four", ""));
-            payment.setCardType(result.get<nanodbc::string>("card_type", ""));
-            payment.setCardholderName(result.get<nanodbc::string>("cardholder_name", ""));
-            payment.setBillingAddress(result.get<nanodbc::string>("billing_address", ""));
-            payment.setCreatedAt(result.get<nanodbc::string>("created_at", ""));
-            payment.setUpdatedAt(result.get<nanodbc::string>("updated_at", ""));
-            payments.push_back(payment);
-        }
-    } catch (const nanodbc::database_error& e) {
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            payments.push_back(paymentFromRow(row));
+        });
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getPaymentsByReservationId: " << e.what() << std::endl;
     }
     return payments;
@@ -101,11 +77,10 @@ std::vector<Payment> PaymentData::getPaymentsByReservationId(int reservationId)
 
 std::optional<Payment> PaymentData::getPaymentById(int id) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, reservation_id, user_id, amount, payment_method, payment_status, transaction_id, card_last_four, card_type, cardholder_name, billing_address, created_at, updated_at FROM payments WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT id, reservation_id, user_id, amount, payment_method, payment_status, transaction_id, card_last_four, card_type, cardholder_name, billing_address, created_at, updated_at FROM payments WHERE id = ?");
         stmt.bind(0, &id);
-        nanodbc::result result = nanodbc::execute(stmt);
+        nanodbc::result result = conn.execute(stmt);
         
         if (result.next()) {
             Payment payment;
@@ -124,7 +99,7 @@ std::optional<Payment> PaymentData::getPaymentById(int id) {
             payment.setUpdatedAt(result.get<nanodbc::string>("updated_at", ""));
             return payment;
         }
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getPaymentById: " << e.what() << std::endl;
     }
     return std::nullopt;
@@ -132,9 +107,8 @@ std::optional<Payment> PaymentData::getPaymentById(int id) {
 
 bool PaymentData::addPayment(const Payment& payment) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "INSERT INTO payments (reservation_id, user_id, amount, payment_method, payment_status, transaction_id, card_last_four, card_type, cardholder_name, billing_address) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("INSERT INTO payments (reservation_id, user_id, amount, payment_method, payment_status, transaction_id, card_last_four, card_type, cardholder_name, billing_address) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
         
         int reservationId = payment.getReservationId();
         int userId = payment.getUserId();
@@ -158,9 +132,9 @@ bool PaymentData::addPayment(const Payment& payment) {
         stmt.bind(8, cardholderName.c_str());
         stmt.bind(9, billingAddress.c_str());
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in addPayment: " << e.what() << std::endl;
         return false;
     }
@@ -168,9 +142,8 @@ bool PaymentData::addPayment(const Payment& payment) {
 
 bool PaymentData::updatePayment(const Payment& payment) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE payments SET reservation_id = ?, user_id = ?, amount = ?, payment_method = ?, payment_status = ?, transaction_id = ?, card_last_four = ?, card_type = ?, cardholder_name = ?, billing_address = ? WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE payments SET reservation_id = ?, user_id = ?, amount = ?, payment_method = ?, payment_status = ?, transaction_id = ?, card_last_four = ?, card_type = ?, cardholder_name = ?, billing_address = ? WHERE id = ?");
         
         int reservationId = payment.getReservationId();
         int userId = payment.getUserId();
@@ -196,9 +169,9 @@ bool PaymentData::updatePayment(const Payment& payment) {
         stmt.bind(9, billingAddress.c_str());
         stmt.bind(10, &id);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in updatePayment: " << e.what() << std::endl;
         return false;
     }
@@ -206,14 +179,13 @@ bool PaymentData::updatePayment(const Payment& payment) {
 
 bool PaymentData::updatePaymentStatus(int id, const std::string& status) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE payments SET payment_status = ? WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE payments SET payment_status = ? WHERE id = ?");
         stmt.bind(0, status.c_str());
         stmt.bind(1, &id);
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in updatePaymentStatus: " << e.what() << std::endl;
         return false;
     }
@@ -221,13 +193,12 @@ bool PaymentData::updatePaymentStatus(int id, const std::string& status) {
 
 bool PaymentData::deletePayment(int id) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "DELETE FROM payments WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("DELETE FROM payments WHERE id = ?");
         stmt.bind(0, &id);
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in deletePayment: " << e.what() << std::endl;
         return false;
     }
@@ -1,82 +1,142 @@
 #include "dataAccess/reservationData.h"
+#include "utils/keysetScan.h"
+#include "utils/stripedMutex.h"
 #include <nanodbc/nanodbc.h>
 #include <iostream>
 
-ReservationData::ReservationData() {}
+namespace {
+
+// Counts non-cancelled reservations on a table that overlap [start_time, end_time) on a date
+std::string conflictCountQuery(bool excludeReservation) {
+    std::string query = "SELECT COUNT(*) as conflict_count FROM reservations WHERE table_id = ? AND date = ? AND status != 'cancelled' AND "
+                       "((start_time < ? AND end_time > ?) OR "
+                       " (start_time < ? AND end_time > ?) OR "
+                       " (start_time >= ? AND end_time <= ?))";
+    if (excludeReservation) {
+        query += " AND id != ?";
+    }
+    return query;
+}
+
+void bindConflictParams(nanodbc::statement& stmt, const int& tableId, const std::string& date,
+                        const std::string& startTime, const std::string& endTime) {
+    stmt.bind(0, &tableId);
+    stmt.bind(1, date.c_str());
+    stmt.bind(2, startTime.c_str());
+    stmt.bind(3, startTime.c_str());
+    stmt.bind(4, endTime.c_str());
+    stmt.bind(5, endTime.c_str());
+    stmt.bind(6, startTime.c_str());
+    stmt.bind(7, endTime.c_str());
+}
+
+// SELECT list of the multi-row reservation queries, read by position in reservationFromRow
+const std::string reservationColumns =
+    "id, user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, "
+    "special_requests, phone_number, email, total_amount, payment_status, payment_method";
+
+Reservation reservationFromRow(const RowsetRow& row) {
+    Reservation reservation;
+    reservation.setId(row.get<int>(0));
+    reservation.setUserId(row.get<int>(1));
+    reservation.setTableId(row.get<int>(2));
+    reservation.setRestaurantId(row.get<int>(3));
+    reservation.setDate(row.get<nanodbc::string>(4, ""));
+    reservation.setStartTime(row.get<nanodbc::string>(5, ""));
+    reservation.setEndTime(row.get<nanodbc::string>(6, ""));
+    reservation.setGuestCount(row.get<int>(7));
+    reservation.setStatus(row.get<nanodbc::string>(8, ""));
+    reservation.setSpecialRequests(row.get<nanodbc::string>(9, ""));
+    reservation.setPhoneNumber(row.get<nanodbc::string>(10, ""));
+    reservation.setEmail(row.get<nanodbc::string>(11, ""));
+    reservation.setTotalAmount(row.get<double>(12, 0.0));
+    reservation.setPaymentStatus(row.get<nanodbc::string>(13, ""));
+    reservation.setPaymentMethod(row.get<nanodbc::string>(14, ""));
+    return reservation;
+}
+
+// Maps a reservationsWithNamesQuery row: the reservation columns, then restaurant_name and customer_name
+Reservation reservationWithNamesFromRow(const RowsetRow& row) {
+    Reservation reservation = reservationFromRow(row);
+    reservation.setRestaurantName(row.get<nanodbc::string>(15, ""));
+    reservation.setCustomerName(row.get<nanodbc::string>(16, ""));
+    return reservation;
+}
+
+const std::string reservationsWithNamesQuery = R"(
+    SELECT r.id, r.user_id, r.table_id, r.restaurant_id, r.date, r.start_time, r.end_time, 
+           r.guest_count, r.status, r.special_requests, r.phone_number, r.email, 
+           r.total_amount, r.payment_status, r.payment_method,
+           rest.name as restaurant_name,
+           CONCAT(u.first_name, ' ', u.last_name) as customer_name
+    FROM reservations r
+    LEFT JOIN restaurants rest ON r.restaurant_id = rest.id
+    LEFT JOIN users u ON r.user_id = u.id
+    WHERE r.id > ?
+    ORDER BY r.id
+)";
+
+// Bookers for the same table queue here instead of each holding a pooled connection while
+// waiting on the database row lock
+StripedMutex bookingLocks(128);
+
+} // namespace
+
+ReservationData::ReservationData(DbContext& context) : dbConnection("ReservationData", context) {}
 
 std::vector<Reservation> ReservationData::getAllReservations() {
-    std::vector<Reservation> reservations;
+    return getAllReservations(PageRequest::unbounded()).items;
+}
+
+Page<Reservation> ReservationData::getAllReservations(const PageRequest& pageRequest) {
+    Page<Reservation> page;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, R"(
-            SELECT r.id, r.user_id, r.table_id, r.restaurant_id, r.date, r.start_time, r.end_time, 
-                   r.guest_count, r.status, r.special_requests, r.phone_number, r.email, 
-                   r.total_amount, r.payment_status, r.payment_method,
-                   rest.name as restaurant_name,
-                   CONCAT(u.first_name, ' ', u.last_name) as customer_name
-            FROM reservations r
-            LEFT JOIN restaurants rest ON r.restaurant_id = rest.id
-            LEFT JOIN users u ON r.user_id = u.id
-        )");
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            Reservation reservation;
-            reservation.setId(result.get<int>("id"));
-            reservation.setUserId(result.get<int>("user_id"));
-            reservation.setTableId(result.get<int>("table_id"));
-            reservation.setRestaurantId(result.get<int>("restaurant_id"));
-            reservation.setDate(result.get<nanodbc::string>("date", ""));
-            reservation.setStartTime(result.get<nanodbc::string>("start_time", ""));
-            reservation.setEndTime(result.get<nanodbc::string>("end_time", ""));
-            reservation.setGuestCount(result.get<int>("guest_count"));
-            reservation.setStatus(result.get<nanodbc::string>("status", ""));
-            reservation.setSpecialRequests(result.get<nanodbc::string>("special_requests", ""));
-            reservation.setPhoneNumber(result.get<nanodbc::string>("phone_number", ""));
-            reservation.setEmail(result.get<nanodbc::string>("email", ""));
-            reservation.setTotalAmount(result.get<double>("total_amount", 0.0));
-            reservation.setPaymentStatus(result.get<nanodbc::string>("payment_status", ""));
-            reservation.setPaymentMethod(result.get<nanodbc::string>("payment_method", ""));
-            reservation.setRestaurantName(result.get<nanodbc::string>("restaurant_name", ""));
-            reservation.setCustomerName(result.get<nanodbc::string>("customer_name", ""));
-            reservations.push_back(reservation);
+        PooledConnection conn = dbConnection.getConnection();
+        std::string query = reservationsWithNamesQuery;
+        if (pageRequest.isBounded()) {
+            query += " LIMIT ?";
+        }
+        nanodbc::statement& stmt = conn.prepare(query);
+        int after = pageRequest.after;
+        int fetchLimit = pageRequest.limit + 1;
+        stmt.bind(0, &after);
+        if (pageRequest.isBounded()) {
+            stmt.bind(1, &fetchLimit);
         }
-    } catch (const nanodbc::database_error& e) {
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            page.items.push_back(reservationWithNamesFromRow(row));
+        });
+        finishPage(page, pageRequest);
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getAllReservations: " << e.what() << std::endl;
     }
-    return reservations;
+    return page;
+}
+
+bool ReservationData::forEachReservation(const std::function<void(const Reservation&)>& visit, int batchSize) {
+    try {
+        keysetScan(dbConnection, reservationsWithNamesQuery + " LIMIT ?", batchSize, [&](const RowsetRow& row) {
+            Reservation reservation = reservationWithNamesFromRow(row);
+            visit(reservation);
+            return reservation.getId();
+        });
+        return true;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in forEachReservation: " << e.what() << std::endl;
+        return false;
+    }
 }
 
 std::vector<Reservation> ReservationData::getReservationsByUserId(int userId) {
     std::vector<Reservation> reservations;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, special_requests, phone_number, email, total_amount, payment_status, payment_method FROM reservations WHERE user_id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT " + reservationColumns + " FROM reservations WHERE user_id = ?");
         stmt.bind(0, &userId);
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            Reservation reservation;
-            reservation.setId(result.get<int>("id"));
-            reservation.setUserId(result.get<int>("user_id"));
-            reservation.setTableId(result.get<int>("table_id"));
-            reservation.setRestaurantId(result.get<int>("restaurant_id"));
-            reservation.setDate(result.get<nanodbc::string>("date", ""));
-            reservation.setStartTime(result.get<nanodbc::string>("start_time", ""));
-            reservation.setEndTime(result.get<nanodbc::string>("end_time", ""));
-            reservation.setGuestCount(result.get<int>("guest_count"));
-            reservation.setStatus(result.get<nanodbc::string>("status", ""));
-            reservation.setSpecialRequests(result.get<nanodbc::string>("special_requests", ""));
-            reservation.setPhoneNumber(result.get<nanodbc::string>("phone_number", ""));
-            reservation.setEmail(result.get<nanodbc::string>("email", ""));
-            reservation.setTotalAmount(result.get<double>("total_amount", 0.0));
-            reservation.setPaymentStatus(result.get<nanodbc::string>("payment_status", ""));
-            reservation.setPaymentMethod(result.get<nanodbc::string>("payment_method", ""));
-            reservations.push_back(reservation);
-        }
-    } catch (const nanodbc::database_error& e) {
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            reservations.push_back(reservationFromRow(row));
+        });
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getReservationsByUserId: " << e.what() << std::endl;
     }
     return reservations;
@@ -85,29 +145,13 @@ std::vector<Reservation> ReservationData::getReservationsByUserId(int userId) {
 std::vector<Reservation> ReservationData::getReservationsByRestaurantId(int restaurantId) {
     std::vector<Reservation> reservations;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, special_requests, phone_number, email FROM reservations WHERE restaurant_id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT " + reservationColumns + " FROM reservations WHERE restaurant_id = ?");
         stmt.bind(0, &restaurantId);
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            Reservation reservation;
-            reservation.setId(result.get<int>("id"));
-            reservation.setUserId(result.get<int>("user_id"));
-            reservation.setTableId(result.get<int>("table_id"));
-            reservation.setRestaurantId(result.get<int>("restaurant_id"));
-            reservation.setDate(result.get<nanodbc::string>("date", ""));
-            reservation.setStartTime(result.get<nanodbc::string>("start_time", ""));
-            reservation.setEndTime(result.get<nanodbc::string>("end_time", ""));
-            reservation.setGuestCount(result.get<int>("guest_count"));
-            reservation.setStatus(result.get<nanodbc::string>("status", ""));
-            reservation.setSpecialRequests(result.get<nanodbc::string>("special_requests", ""));
-            reservation.setPhoneNumber(result.get<nanodbc::string>("phone_number", ""));
-            reservation.setEmail(result.get<nanodbc::string>("email", ""));
-            reservations.push_back(reservation);
-        }
-    } catch (const nanodbc::database_error& e) {
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            reservations.push_back(reservationFromRow(row));
+        });
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getReservationsByRestaurantId: " << e.what() << std::endl;
     }
     return reservations;
@@ -116,29 +160,13 @@ std::vector<Reservation> ReservationData::getReservationsByRestaurantId(int rest
 std::vector<Reservation> ReservationData::getReservationsByTableId(int tableId) {
     std::vector<Reservation> reservations;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, special_requests, phone_number, email FROM reservations WHERE table_id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT " + reservationColumns + " FROM reservations WHERE table_id = ?");
         stmt.bind(0, &tableId);
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            Reservation reservation;
-            reservation.setId(result.get<int>("id"));
-            reservation.setUserId(result.get<int>("user_id"));
-            reservation.setTableId(result.get<int>("table_id"));
-            reservation.setRestaurantId(result.get<int>("restaurant_id"));
-            reservation.setDate(result.get<nanodbc::string>("date", ""));
-            reservation.setStartTime(result.get<nanodbc::string>("start_time", ""));
-            reservation.setEndTime(result.get<nanodbc::string>("end_time", ""));
-            reservation.setGuestCount(result.get<int>("guest_count"));
-            reservation.setStatus(result.get<nanodbc::string>("status", ""));
-            reservation.setSpecialRequests(result.get<nanodbc::string>("special_requests", ""));
-            reservation.setPhoneNumber(result.get<nanodbc::string>("phone_number", ""));
-            reservation.setEmail(result.get<nanodbc::string>("email", ""));
-            reservations.push_back(reservation);
-        }
-    } catch (const nanodbc::database_error& e) {
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            reservations.push_back(reservationFromRow(row));
+        });
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getReservationsByTableId: " << e.what() << std::endl;
     }
     return reservations;
@@ -146,11 +174,10 @@ std::vector<Reservation> ReservationData::getReservationsByTableId(int tableId)
 
 std::optional<Reservation> ReservationData::getReservationById(int id) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, special_requests, phone_number, email FROM reservations WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT id, user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, special_requests, phone_number, email FROM reservations WHERE id = ?");
         stmt.bind(0, &id);
-        nanodbc::result result = nanodbc::execute(stmt);
+        nanodbc::result result = conn.execute(stmt);
         
         if (result.next()) {
             Reservation reservation;
@@ -168,7 +195,7 @@ std::optional<Reservation> ReservationData::getReservationById(int id) {
             reservation.setEmail(result.get<nanodbc::string>("email", ""));
             return reservation;
         }
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getReservationById: " << e.what() << std::endl;
     }
     return std::nullopt;
@@ -176,9 +203,8 @@ std::optional<Reservation> ReservationData::getReservationById(int id) {
 
 std::optional<Reservation> ReservationData::getReservationByIdWithDetails(int id) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, R"(
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare(R"(
             SELECT r.id, r.user_id, r.table_id, r.restaurant_id, r.date, r.start_time, r.end_time, 
                    r.guest_count, r.status, r.special_requests, r.phone_number, r.email,
                    r.total_amount, r.payment_status, r.payment_method,
@@ -190,7 +216,7 @@ std::optional<Reservation> ReservationData::getReservationByIdWithDetails(int id
             WHERE r.id = ?
         )");
         stmt.bind(0, &id);
-        nanodbc::result result = nanodbc::execute(stmt);
+        nanodbc::result result = conn.execute(stmt);
         
         if (result.next()) {
             Reservation reservation;
@@ -213,7 +239,7 @@ std::optional<Reservation> ReservationData::getReservationByIdWithDetails(int id
             reservation.setCustomerName(result.get<nanodbc::string>("customer_name", ""));
             return reservation;
         }
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getReservationByIdWithDetails: " << e.what() << std::endl;
     }
     return std::nullopt;
@@ -221,9 +247,8 @@ std::optional<Reservation> ReservationData::getReservationByIdWithDetails(int id
 
 bool ReservationData::addReservation(const Reservation& reservation) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "INSERT INTO reservations (user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, special_requests, phone_number, email, total_amount, payment_status, payment_method, confirmation_token) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("INSERT INTO reservations (user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, special_requests, phone_number, email, total_amount, payment_status, payment_method, confirmation_token) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
         
         int userId = reservation.getUserId();
         int tableId = reservation.getTableId();
@@ -257,9 +282,9 @@ bool ReservationData::addReservation(const Reservation& reservation) {
         stmt.bind(13, paymentMethod.c_str());
         stmt.bind(14, confirmationToken.c_str());
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in addReservation: " << e.what() << std::endl;
         return false;
     }
@@ -267,9 +292,8 @@ bool ReservationData::addReservation(const Reservation& reservation) {
 
 bool ReservationData::updateReservation(const Reservation& reservation) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE reservations SET user_id = ?, table_id = ?, restaurant_id = ?, date = ?, start_time = ?, end_time = ?, guest_count = ?, status = ?, special_requests = ?, phone_number = ?, email = ?, total_amount = ?, payment_status = ?, payment_method = ? WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE reservations SET user_id = ?, table_id = ?, restaurant_id = ?, date = ?, start_time = ?, end_time = ?, guest_count = ?, status = ?, special_requests = ?, phone_number = ?, email = ?, total_amount = ?, payment_status = ?, payment_method = ? WHERE id = ?");
         
         int userId = reservation.getUserId();
         int tableId = reservation.getTableId();
@@ -303,9 +327,9 @@ bool ReservationData::updateReservation(const Reservation& reservation) {
         stmt.bind(13, paymentMethod.c_str());
         stmt.bind(14, &id);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in updateReservation: " << e.what() << std::endl;
         return false;
     }
@@ -313,15 +337,14 @@ bool ReservationData::updateReservation(const Reservation& reservation) {
 
 bool ReservationData::deleteReservation(int id) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "DELETE FROM reservations WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("DELETE FROM reservations WHERE id = ?");
         
         stmt.bind(0, &id);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in deleteReservation: " << e.what() << std::endl;
         return false;
     }
@@ -329,67 +352,170 @@ bool ReservationData::deleteReservation(int id) {
 
 bool ReservationData::updateReservationStatus(int id, const std::string& status) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE reservations SET status = ? WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE reservations SET status = ? WHERE id = ?");
         
         stmt.bind(0, status.c_str());
         stmt.bind(1, &id);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in updateReservationStatus: " << e.what() << std::endl;
         return false;
     }
 }
 
+int ReservationData::updateReservationStatuses(const std::vector<int>& ids, const std::string& status) {
+    if (ids.empty()) {
+        return 0;
+    }
+    
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::transaction transaction(conn.get());
+        nanodbc::statement& stmt = conn.prepare("UPDATE reservations SET status = ? WHERE id = ?");
+        
+        std::vector<std::string> statuses(ids.size(), status);
+        stmt.bind_strings(0, statuses);
+        stmt.bind(1, ids.data(), ids.size());
+        
+        nanodbc::result result = conn.execute(stmt, static_cast<long>(ids.size()));
+        int changed = static_cast<int>(result.affected_rows());
+        transaction.commit();
+        return changed;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in updateReservationStatuses: " << e.what() << std::endl;
+        return -1;
+    }
+}
+
 bool ReservationData::isTableAvailable(int tableId, const std::string& date, const std::string& startTime, const std::string& endTime, int excludeReservationId) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        
-        std::string query = "SELECT COUNT(*) as conflict_count FROM reservations WHERE table_id = ? AND date = ? AND status != 'cancelled' AND "
-                           "((start_time < ? AND end_time > ?) OR "
-                           " (start_time < ? AND end_time > ?) OR "
-                           " (start_time >= ? AND end_time <= ?))";
-        
-        if (excludeReservationId > 0) {
-            query += " AND id != ?";
-        }
-        
-        nanodbc::prepare(stmt, query);
-        
-        stmt.bind(0, &tableId);
-        stmt.bind(1, date.c_str());
-        stmt.bind(2, startTime.c_str());
-        stmt.bind(3, startTime.c_str());
-        stmt.bind(4, endTime.c_str());
-        stmt.bind(5, endTime.c_str());
-        stmt.bind(6, startTime.c_str());
-        stmt.bind(7, endTime.c_str());
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare(conflictCountQuery(excludeReservationId > 0));
+        bindConflictParams(stmt, tableId, date, startTime, endTime);
         
         if (excludeReservationId > 0) {
             stmt.bind(8, &excludeReservationId);
         }
         
-        nanodbc::result result = nanodbc::execute(stmt);
+        nanodbc::result result = conn.execute(stmt);
         
         if (result.next()) {
             int conflictCount = result.get<int>("conflict_count");
             return conflictCount == 0;
         }
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in isTableAvailable: " << e.what() << std::endl;
     }
     return false;
 }
 
+std::optional<Reservation> ReservationData::addReservationIfAvailable(const Reservation& reservation) {
+    int userId = reservation.getUserId();
+    int tableId = reservation.getTableId();
+    int restaurantId = reservation.getRestaurantId();
+    std::string date = reservation.getDate();
+    std::string startTime = reservation.getStartTime();
+    std::string endTime = reservation.getEndTime();
+    int guestCount = reservation.getGuestCount();
+    std::string status = reservation.getStatus();
+    std::string specialRequests = reservation.getSpecialRequests();
+    std::string phoneNumber = reservation.getPhoneNumber();
+    std::string email = reservation.getEmail();
+    double totalAmount = reservation.getTotalAmount();
+    std::string paymentStatus = reservation.getPaymentStatus();
+    std::string paymentMethod = reservation.getPaymentMethod();
+    std::string confirmationToken = reservation.getConfirmationToken();
+    
+    std::lock_guard<std::mutex> tableLock(bookingLocks.forKey(tableId));
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        // Both round trips in one transaction: if the details read fails, the booking is rolled
+        // back with it instead of holding the slot for a request that was reported as refused
+        nanodbc::transaction transaction(conn.get());
+        
+        // Round trip 1: the insert only produces a row if the table exists in the requested
+        // restaurant and the slot is free.
+        // FOR UPDATE takes the tables row lock, so concurrent bookings for this table from any
+        // server process are serialised, and the NOT EXISTS check is a locking read of the latest rows.
+        nanodbc::statement& stmt = conn.prepare(
+            "INSERT INTO reservations (user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, "
+            "special_requests, phone_number, email, total_amount, payment_status, payment_method, confirmation_token) "
+            "SELECT ?, t.id, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ? FROM tables t "
+            "WHERE t.id = ? AND t.restaurant_id = ? AND NOT EXISTS ("
+            "SELECT 1 FROM reservations r WHERE r.table_id = t.id AND r.date = ? AND r.status != 'cancelled' AND "
+            "((r.start_time < ? AND r.end_time > ?) OR "
+            " (r.start_time < ? AND r.end_time > ?) OR "
+            " (r.start_time >= ? AND r.end_time <= ?))"
+            ") FOR UPDATE");
+        stmt.bind(0, &userId);
+        stmt.bind(1, &restaurantId);
+        stmt.bind(2, date.c_str());
+        stmt.bind(3, startTime.c_str());
+        stmt.bind(4, endTime.c_str());
+        stmt.bind(5, &guestCount);
+        stmt.bind(6, status.c_str());
+        stmt.bind(7, specialRequests.c_str());
+        stmt.bind(8, phoneNumber.c_str());
+        stmt.bind(9, email.c_str());
+        stmt.bind(10, &totalAmount);
+        stmt.bind(11, paymentStatus.c_str());
+        stmt.bind(12, paymentMethod.c_str());
+        stmt.bind(13, confirmationToken.c_str());
+        stmt.bind(14, &tableId);
+        stmt.bind(15, &restaurantId);
+        stmt.bind(16, date.c_str());
+        stmt.bind(17, startTime.c_str());
+        stmt.bind(18, startTime.c_str());
+        stmt.bind(19, endTime.c_str());
+        stmt.bind(20, endTime.c_str());
+        stmt.bind(21, startTime.c_str());
+        stmt.bind(22, endTime.c_str());
+        nanodbc::result insertResult = conn.execute(stmt);
+        if (insertResult.affected_rows() == 0) {
+            return std::nullopt; // Slot taken, or no such table in this restaurant
+        }
+        
+        // Round trip 2: the generated id plus what the confirmation email needs, on the same connection
+        nanodbc::statement& detailsStmt = conn.prepare(
+            "SELECT LAST_INSERT_ID() as reservation_id, u.username, u.first_name, u.last_name, u.email as user_email, "
+            "r.name as restaurant_name "
+            "FROM (SELECT 1) booking "
+            "LEFT JOIN users u ON u.id = ? "
+            "LEFT JOIN restaurants r ON r.id = ?");
+        detailsStmt.bind(0, &userId);
+        detailsStmt.bind(1, &restaurantId);
+        nanodbc::result details = conn.execute(detailsStmt);
+        
+        if (!details.next()) {
+            return std::nullopt; // The transaction rolls the insert back
+        }
+        Reservation booked = reservation;
+        booked.setId(details.get<int>("reservation_id"));
+        booked.setRestaurantName(details.get<nanodbc::string>("restaurant_name", ""));
+        
+        std::string customerName = details.get<nanodbc::string>("first_name", "") + " " + details.get<nanodbc::string>("last_name", "");
+        if (customerName == " ") {
+            customerName = details.get<nanodbc::string>("username", "");
+        }
+        booked.setCustomerName(customerName);
+        if (booked.getEmail().empty()) {
+            booked.setEmail(details.get<nanodbc::string>("user_email", ""));
+        }
+        transaction.commit();
+        return booked;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in addReservationIfAvailable: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
 std::vector<int> ReservationData::getAvailableTableIds(int restaurantId, const std::string& date, const std::string& startTime, const std::string& endTime, int minCapacity) {
     std::vector<int> availableTableIds;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
+        PooledConnection conn = dbConnection.getConnection();
         
         std::string query = "SELECT t.id FROM tables t WHERE t.restaurant_id = ?";
         
@@ -405,7 +531,7 @@ std::vector<int> ReservationData::getAvailableTableIds(int restaurantId, const s
                  " (r.start_time >= ? AND r.end_time <= ?))"   // Reservation is within new time range
                  ")";
         
-        nanodbc::prepare(stmt, query);
+        nanodbc::statement& stmt = conn.prepare(query);
         
         int paramIndex = 0;
         stmt.bind(paramIndex++, &restaurantId);
@@ -422,12 +548,10 @@ std::vector<int> ReservationData::getAvailableTableIds(int restaurantId, const s
         stmt.bind(paramIndex++, startTime.c_str());
         stmt.bind(paramIndex++, endTime.c_str());
         
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            availableTableIds.push_back(result.get<int>("id"));
-        }
-    } catch (const nanodbc::database_error& e) {
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            availableTableIds.push_back(row.get<int>(0));
+        });
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getAvailableTableIds: " << e.what() << std::endl;
     }
     return availableTableIds;
@@ -435,11 +559,10 @@ std::vector<int> ReservationData::getAvailableTableIds(int restaurantId, const s
 
 std::optional<Reservation> ReservationData::getReservationByConfirmationToken(const std::string& token) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, special_requests, phone_number, email, total_amount, payment_status, payment_method, confirmation_token FROM reservations WHERE confirmation_token = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT id, user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, special_requests, phone_number, email, total_amount, payment_status, payment_method, confirmation_token FROM reservations WHERE confirmation_token = ?");
         stmt.bind(0, token.c_str());
-        nanodbc::result result = nanodbc::execute(stmt);
+        nanodbc::result result = conn.execute(stmt);
         
         if (result.next()) {
             Reservation reservation;
@@ -460,7 +583,7 @@ std::optional<Reservation> ReservationData::getReservationByConfirmationToken(co
             reservation.setPaymentMethod(result.get<nanodbc::string>("payment_method", ""));
             return reservation;
         }
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getReservationByConfirmationToken: " << e.what() << std::endl;
     }
     return std::nullopt;
@@ -468,16 +591,15 @@ std::optional<Reservation> ReservationData::getReservationByConfirmationToken(co
 
 bool ReservationData::updateReservationConfirmationToken(int id, const std::string& token) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE reservations SET confirmation_token = ? WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE reservations SET confirmation_token = ? WHERE id = ?");
         
         stmt.bind(0, token.c_str());
         stmt.bind(1, &id);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in updateReservationConfirmationToken: " << e.what() << std::endl;
         return false;
     }
@@ -485,16 +607,37 @@ bool ReservationData::updateReservationConfirmationToken(int id, const std::stri
 
 bool ReservationData::confirmReservation(const std::string& token) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE reservations SET status = 'confirmed', confirmed_at = CURRENT_TIMESTAMP, confirmation_token = NULL WHERE confirmation_token = ? AND status = 'pending'");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE reservations SET status = 'confirmed', confirmed_at = CURRENT_TIMESTAMP, confirmation_token = NULL WHERE confirmation_token = ? AND status = 'pending'");
         
         stmt.bind(0, token.c_str());
         
-        nanodbc::result result = nanodbc::execute(stmt);
+        nanodbc::result result = conn.execute(stmt);
         return result.affected_rows() > 0;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in confirmReservation: " << e.what() << std::endl;
         return false;
     }
 }
+
+int ReservationData::expirePendingReservations(std::chrono::minutes holdFor, int limit) {
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        // Oldest holds first, through idx_reservations_status_created; LIMIT keeps each statement's row locks short.
+        // Paid bookings are left alone: the customer has paid even if the email link was never clicked.
+        nanodbc::statement& stmt = conn.prepare(
+            "UPDATE reservations SET status = 'cancelled', confirmation_token = NULL "
+            "WHERE status = 'pending' AND payment_status != 'paid' AND created_at < NOW() - INTERVAL ? MINUTE "
+            "ORDER BY created_at LIMIT ?");
+        
+        int minutes = static_cast<int>(holdFor.count());
+        stmt.bind(0, &minutes);
+        stmt.bind(1, &limit);
+        
+        nanodbc::result result = conn.execute(stmt);
+        return static_cast<int>(result.affected_rows());
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in expirePendingReservations: " << e.what() << std::endl;
+        return -1;
+    }
+}
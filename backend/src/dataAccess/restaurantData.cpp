@@ -1,77 +1,115 @@
 #include "dataAccess/restaurantData.h"
+#include "dataAccess/reviewData.h"
+#include "dataAccess/tableData.h"
+#include "utils/batchLoader.h"
 #include <nanodbc/nanodbc.h>
 #include <iostream>
 
-RestaurantData::RestaurantData() {}
+namespace {
+
+// Maps a restaurants row by position: r.id, name, address, phone_number, description, table_count,
+// cuisine_type, rating, is_featured, price_range, opening_time, closing_time, image_url,
+// reservation_fee, then the computed actual_table_count
+Restaurant restaurantFromRow(const RowsetRow& row) {
+    Restaurant restaurant;
+    restaurant.setId(row.get<int>(0));
+    restaurant.setName(row.get<nanodbc::string>(1, ""));
+    restaurant.setAddress(row.get<nanodbc::string>(2, ""));
+    restaurant.setPhoneNumber(row.get<nanodbc::string>(3, ""));
+    restaurant.setDescription(row.get<nanodbc::string>(4, ""));
+    restaurant.setTableCount(row.get<int>(14, 0));
+    restaurant.setCuisineType(row.get<nanodbc::string>(6, "Not specified"));
+    restaurant.setRating(row.get<float>(7, 0.0));
+    // Convert int to bool
+    int isFeatured = row.get<int>(8, 0);
+    restaurant.setIsFeatured(isFeatured != 0);
+    restaurant.setPriceRange(row.get<nanodbc::string>(9, ""));
+    restaurant.setOpeningTime(row.get<nanodbc::string>(10, ""));
+    restaurant.setClosingTime(row.get<nanodbc::string>(11, ""));
+    restaurant.setImageUrl(row.get<nanodbc::string>(12, ""));
+    restaurant.setReservationFee(row.get<double>(13, 25.0));
+    return restaurant;
+}
+
+} // namespace
+
+RestaurantData::RestaurantData(DbContext& context) : dbConnection("RestaurantData", context) {}
 
 std::vector<Restaurant> RestaurantData::getAllRestaurants() {
-    std::vector<Restaurant> restaurants;
+    return getAllRestaurants(PageRequest::unbounded()).items;
+}
+
+Page<Restaurant> RestaurantData::getAllRestaurants(const PageRequest& pageRequest) {
+    Page<Restaurant> page;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        // Modified query to include image_url and reservation_fee
-        nanodbc::prepare(stmt, "SELECT id, name, address, phone_number, description, table_count, "
-                             "cuisine_type, rating, is_featured, price_range, opening_time, closing_time, image_url, reservation_fee "
-                             "FROM restaurants");
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            Restaurant restaurant;
-            restaurant.setId(result.get<int>("id"));
-            restaurant.setName(result.get<nanodbc::string>("name", ""));
-            restaurant.setAddress(result.get<nanodbc::string>("address", ""));
-            restaurant.setPhoneNumber(result.get<nanodbc::string>("phone_number", ""));
-            restaurant.setDescription(result.get<nanodbc::string>("description", ""));
-            
-            // Get the actual table count from the tables table instead of using the static value
-            int restaurantId = result.get<int>("id");
-            try {
-                nanodbc::connection tableConn = dbConnection.getConnection();
-                nanodbc::statement tableStmt(tableConn);
-                nanodbc::prepare(tableStmt, "SELECT COUNT(*) FROM tables WHERE restaurant_id = ?");
-                tableStmt.bind(0, &restaurantId);
-                nanodbc::result tableResult = nanodbc::execute(tableStmt);
-                
-                if (tableResult.next()) {
-                    restaurant.setTableCount(tableResult.get<int>(0));
-                } else {
-                    restaurant.setTableCount(0);
-                }
-            } catch (const nanodbc::database_error& e) {
-                std::cerr << "Error counting tables for restaurant " << restaurantId << ": " << e.what() << std::endl;
-                restaurant.setTableCount(result.get<int>("table_count")); // Fallback to stored value
-            }
-            
-            restaurant.setCuisineType(result.get<nanodbc::string>("cuisine_type", "Not specified"));
-            restaurant.setRating(result.get<float>("rating", 0.0));
-            // Convert int to bool
-            int isFeatured = result.get<int>("is_featured", 0);
-            restaurant.setIsFeatured(isFeatured != 0);
-            restaurant.setPriceRange(result.get<nanodbc::string>("price_range", ""));
-            restaurant.setOpeningTime(result.get<nanodbc::string>("opening_time", ""));
-            restaurant.setClosingTime(result.get<nanodbc::string>("closing_time", ""));
-            restaurant.setImageUrl(result.get<nanodbc::string>("image_url", ""));
-            restaurant.setReservationFee(result.get<double>("reservation_fee", 25.0));
-            restaurants.push_back(restaurant);
+        PooledConnection conn = dbConnection.getReadConnection();
+        // Table counts come from one grouped subquery instead of a COUNT(*) per restaurant
+        std::string query = "SELECT r.id, r.name, r.address, r.phone_number, r.description, r.table_count, "
+                            "r.cuisine_type, r.rating, r.is_featured, r.price_range, r.opening_time, r.closing_time, r.image_url, r.reservation_fee, "
+                            "COALESCE(t.actual_table_count, 0) as actual_table_count "
+                            "FROM restaurants r "
+                            "LEFT JOIN (SELECT restaurant_id, COUNT(*) as actual_table_count FROM tables GROUP BY restaurant_id) t "
+                            "ON r.id = t.restaurant_id "
+                            "WHERE r.id > ? ORDER BY r.id";
+        if (pageRequest.isBounded()) {
+            query += " LIMIT ?";
         }
-    } catch (const nanodbc::database_error& e) {
+        nanodbc::statement& stmt = conn.prepare(query);
+        int after = pageRequest.after;
+        int fetchLimit = pageRequest.limit + 1;
+        stmt.bind(0, &after);
+        if (pageRequest.isBounded()) {
+            stmt.bind(1, &fetchLimit);
+        }
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            page.items.push_back(restaurantFromRow(row));
+        });
+        finishPage(page, pageRequest);
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getAllRestaurants: " << e.what() << std::endl;
     }
+    return page;
+}
+
+std::unordered_map<int, Restaurant> RestaurantData::getRestaurantsByIds(const std::vector<int>& ids) {
+    std::unordered_map<int, Restaurant> restaurants;
+    try {
+        PooledConnection conn = dbConnection.getReadConnection();
+        BatchLoader<int, Restaurant> loader([&conn](const std::vector<int>& keys, std::unordered_map<int, Restaurant>& results) {
+            nanodbc::statement& stmt = conn.prepare("SELECT r.id, r.name, r.address, r.phone_number, r.description, r.table_count, "
+                                 "r.cuisine_type, r.rating, r.is_featured, r.price_range, r.opening_time, r.closing_time, r.image_url, r.reservation_fee, "
+                                 "(SELECT COUNT(*) FROM tables t WHERE t.restaurant_id = r.id) as actual_table_count "
+                                 "FROM restaurants r "
+                                 "WHERE r.id IN (" + sqlPlaceholders(keys.size()) + ")");
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                stmt.bind(static_cast<short>(i), &keys[i]);
+            }
+            conn.fetch(stmt, [&](const RowsetRow& row) {
+                Restaurant restaurant = restaurantFromRow(row);
+                results[restaurant.getId()] = restaurant;
+            });
+        });
+        
+        for (int id : ids) {
+            loader.add(id);
+        }
+        restaurants = loader.load();
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in getRestaurantsByIds: " << e.what() << std::endl;
+    }
     return restaurants;
 }
 
 std::optional<Restaurant> RestaurantData::getRestaurantById(int id) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT r.id, r.name, r.address, r.phone_number, r.description, r.table_count, "
+        PooledConnection conn = dbConnection.getReadConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT r.id, r.name, r.address, r.phone_number, r.description, r.table_count, "
                              "r.cuisine_type, r.rating, r.is_featured, r.price_range, r.opening_time, r.closing_time, r.image_url, r.reservation_fee, "
-                             "COALESCE(COUNT(t.id), 0) as actual_table_count "
+                             "(SELECT COUNT(*) FROM tables t WHERE t.restaurant_id = r.id) as actual_table_count "
                              "FROM restaurants r "
-                             "LEFT JOIN tables t ON r.id = t.restaurant_id "
-                             "WHERE r.id = ? GROUP BY r.id");
+                             "WHERE r.id = ?");
         stmt.bind(0, &id);
-        nanodbc::result result = nanodbc::execute(stmt);
+        nanodbc::result result = conn.execute(stmt);
         
         if (result.next()) {
             Restaurant restaurant;
@@ -81,7 +119,7 @@ std::optional<Restaurant> RestaurantData::getRestaurantById(int id) {
             restaurant.setPhoneNumber(result.get<nanodbc::string>("phone_number", ""));
             restaurant.setDescription(result.get<nanodbc::string>("description", ""));
             
-            // Use the actual table count from the JOIN query
+            // Use the actual table count from the subquery
             restaurant.setTableCount(result.get<int>("actual_table_count"));
             
             restaurant.setCuisineType(result.get<nanodbc::string>("cuisine_type", ""));
@@ -96,17 +134,84 @@ std::optional<Restaurant> RestaurantData::getRestaurantById(int id) {
             restaurant.setReservationFee(result.get<double>("reservation_fee", 25.0));
             return restaurant;
         }
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getRestaurantById: " << e.what() << std::endl;
     }
     return std::nullopt;
 }
 
+std::optional<RestaurantDetails> RestaurantData::getRestaurantDetails(int id, const PageRequest& reviewPage) {
+    try {
+        PooledConnection conn = dbConnection.getReadConnection();
+        std::string batch =
+            "SELECT r.id, r.name, r.address, r.phone_number, r.description, r.table_count, "
+            "r.cuisine_type, r.rating, r.is_featured, r.price_range, r.opening_time, r.closing_time, r.image_url, r.reservation_fee, "
+            "(SELECT COUNT(*) FROM tables t WHERE t.restaurant_id = r.id) as actual_table_count "
+            "FROM restaurants r WHERE r.id = ?; "
+            "SELECT id, restaurant_id, seat_count, is_available FROM tables WHERE restaurant_id = ?; "
+            "SELECT r.id, r.table_id, r.date, r.start_time, r.end_time, r.status, r.guest_count "
+            "FROM reservations r JOIN tables t ON t.id = r.table_id "
+            "WHERE t.restaurant_id = ? AND r.status != 'cancelled' AND r.date >= CURDATE() "
+            "ORDER BY r.date, r.start_time; "
+            "SELECT COALESCE(AVG(rating), 0), COUNT(*) FROM reviews WHERE restaurant_id = ?; "
+            "SELECT id, user_id, restaurant_id, rating, comment FROM reviews WHERE restaurant_id = ? AND id > ? ORDER BY id";
+        if (reviewPage.isBounded()) {
+            batch += " LIMIT ?";
+        }
+        nanodbc::statement& stmt = conn.prepare(batch);
+        int after = reviewPage.after;
+        int fetchLimit = reviewPage.limit + 1;
+        for (short i = 0; i < 5; ++i) {
+            stmt.bind(i, &id);
+        }
+        stmt.bind(5, &after);
+        if (reviewPage.isBounded()) {
+            stmt.bind(6, &fetchLimit);
+        }
+
+        bool found = false;
+        RestaurantDetails details;
+        std::unordered_map<int, std::size_t> tableIndex;
+        conn.fetchResults(stmt, {
+            [&](const RowsetRow& row) {
+                details.restaurant = restaurantFromRow(row);
+                found = true;
+            },
+            [&](const RowsetRow& row) {
+                Table table = TableData::tableFromRow(row);
+                // Set all tables as available for booking, as getTablesWithReservationsByRestaurantId does
+                table.setIsAvailable(true);
+                tableIndex[table.getId()] = details.tables.size();
+                details.tables.push_back(table);
+            },
+            [&](const RowsetRow& row) {
+                auto it = tableIndex.find(row.get<int>(1));
+                if (it != tableIndex.end()) {
+                    details.tables[it->second].addReservation(TableData::reservationInfoFromRow(row));
+                }
+            },
+            [&](const RowsetRow& row) {
+                details.averageRating = row.get<float>(0, 0.0f);
+                details.reviewCount = row.get<int>(1, 0);
+            },
+            [&](const RowsetRow& row) {
+                details.reviews.items.push_back(ReviewData::reviewFromRow(row));
+            },
+        });
+        if (found) {
+            finishPage(details.reviews, reviewPage);
+            return details;
+        }
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in getRestaurantDetails: " << e.what() << std::endl;
+    }
+    return std::nullopt;
+}
+
 int RestaurantData::addRestaurant(const Restaurant& restaurant) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "INSERT INTO restaurants (name, address, phone_number, description, table_count, "
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("INSERT INTO restaurants (name, address, phone_number, description, table_count, "
                            "cuisine_type, rating, is_featured, price_range, opening_time, closing_time, image_url, reservation_fee, is_active) "
                            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
         
@@ -143,19 +248,18 @@ int RestaurantData::addRestaurant(const Restaurant& restaurant) {
         stmt.bind(12, &reservationFee);
         stmt.bind(13, &isActive);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         
         // Get the last inserted ID
-        nanodbc::statement idStmt(conn);
-        nanodbc::prepare(idStmt, "SELECT LAST_INSERT_ID()");
-        nanodbc::result idResult = nanodbc::execute(idStmt);
+        nanodbc::statement& idStmt = conn.prepare("SELECT LAST_INSERT_ID()");
+        nanodbc::result idResult = conn.execute(idStmt);
         
         if (idResult.next()) {
             return idResult.get<int>(0);
         } else {
             return 0;
         }
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in addRestaurant: " << e.what() << std::endl;
         return 0;
     }
@@ -163,9 +267,8 @@ int RestaurantData::addRestaurant(const Restaurant& restaurant) {
 
 bool RestaurantData::updateRestaurant(const Restaurant& restaurant) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE restaurants SET name = ?, address = ?, phone_number = ?, description = ?, "
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE restaurants SET name = ?, address = ?, phone_number = ?, description = ?, "
                             "table_count = ?, cuisine_type = ?, rating = ?, is_featured = ?, "
                             "price_range = ?, opening_time = ?, closing_time = ?, image_url = ? WHERE id = ?");
         
@@ -199,9 +302,9 @@ bool RestaurantData::updateRestaurant(const Restaurant& restaurant) {
         stmt.bind(11, imageUrl.c_str());
         stmt.bind(12, &id);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in updateRestaurant: " << e.what() << std::endl;
         return false;
     }
@@ -209,15 +312,14 @@ bool RestaurantData::updateRestaurant(const Restaurant& restaurant) {
 
 bool RestaurantData::deleteRestaurant(int id) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "DELETE FROM restaurants WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("DELETE FROM restaurants WHERE id = ?");
         
         stmt.bind(0, &id);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in deleteRestaurant: " << e.what() << std::endl;
         return false;
     }
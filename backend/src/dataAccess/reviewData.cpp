@@ -1,87 +1,100 @@
 #include "dataAccess/reviewData.h"
+#include "utils/keysetScan.h"
 #include <nanodbc/nanodbc.h>
 #include <iostream>
 
-ReviewData::ReviewData() {}
+ReviewData::ReviewData(DbContext& context) : dbConnection("ReviewData", context) {}
+
+Review ReviewData::reviewFromRow(const RowsetRow& row) {
+    Review review;
+    review.setId(row.get<int>(0));
+    review.setUserId(row.get<int>(1));
+    review.setRestaurantId(row.get<int>(2));
+    review.setRating(row.get<int>(3));
+    review.setComment(row.get<nanodbc::string>(4, ""));
+    return review;
+}
 
 std::vector<Review> ReviewData::getAllReviews() {
     std::vector<Review> reviews;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, user_id, restaurant_id, rating, comment FROM reviews");
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            Review review;
-            review.setId(result.get<int>("id"));
-            review.setUserId(result.get<int>("user_id"));
-            review.setRestaurantId(result.get<int>("restaurant_id"));
-            review.setRating(result.get<int>("rating"));
-            review.setComment(result.get<nanodbc::string>("comment", ""));
-            reviews.push_back(review);
-        }
-    } catch (const nanodbc::database_error& e) {
+        PooledConnection conn = dbConnection.getReadConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT id, user_id, restaurant_id, rating, comment FROM reviews");
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            reviews.push_back(reviewFromRow(row));
+        });
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getAllReviews: " << e.what() << std::endl;
     }
     return reviews;
 }
 
+bool ReviewData::forEachReview(const std::function<void(const Review&)>& visit, int batchSize) {
+    try {
+        keysetScan(dbConnection, "SELECT id, user_id, restaurant_id, rating, comment FROM reviews WHERE id > ? ORDER BY id LIMIT ?",
+                   batchSize, [&](const RowsetRow& row) {
+            Review review = reviewFromRow(row);
+            visit(review);
+            return review.getId();
+        });
+        return true;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in forEachReview: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 std::vector<Review> ReviewData::getReviewsByUserId(int userId) {
     std::vector<Review> reviews;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, user_id, restaurant_id, rating, comment FROM reviews WHERE user_id = ?");
+        PooledConnection conn = dbConnection.getReadConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT id, user_id, restaurant_id, rating, comment FROM reviews WHERE user_id = ?");
         stmt.bind(0, &userId);
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            Review review;
-            review.setId(result.get<int>("id"));
-            review.setUserId(result.get<int>("user_id"));
-            review.setRestaurantId(result.get<int>("restaurant_id"));
-            review.setRating(result.get<int>("rating"));
-            review.setComment(result.get<nanodbc::string>("comment", ""));
-            reviews.push_back(review);
-        }
-    } catch (const nanodbc::database_error& e) {
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            reviews.push_back(reviewFromRow(row));
+        });
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getReviewsByUserId: " << e.what() << std::endl;
     }
     return reviews;
 }
 
 std::vector<Review> ReviewData::getReviewsByRestaurantId(int restaurantId) {
-    std::vector<Review> reviews;
+    return getReviewsByRestaurantId(restaurantId, PageRequest::unbounded()).items;
+}
+
+Page<Review> ReviewData::getReviewsByRestaurantId(int restaurantId, const PageRequest& pageRequest) {
+    Page<Review> page;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, user_id, restaurant_id, rating, comment FROM reviews WHERE restaurant_id = ?");
+        PooledConnection conn = dbConnection.getReadConnection();
+        std::string query = "SELECT id, user_id, restaurant_id, rating, comment FROM reviews WHERE restaurant_id = ? AND id > ? ORDER BY id";
+        if (pageRequest.isBounded()) {
+            query += " LIMIT ?";
+        }
+        nanodbc::statement& stmt = conn.prepare(query);
+        int after = pageRequest.after;
+        int fetchLimit = pageRequest.limit + 1;
         stmt.bind(0, &restaurantId);
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            Review review;
-            review.setId(result.get<int>("id"));
-            review.setUserId(result.get<int>("user_id"));
-            review.setRestaurantId(result.get<int>("restaurant_id"));
-            review.setRating(result.get<int>("rating"));
-            review.setComment(result.get<nanodbc::string>("comment", ""));
-            reviews.push_back(review);
+        stmt.bind(1, &after);
+        if (pageRequest.isBounded()) {
+            stmt.bind(2, &fetchLimit);
         }
-    } catch (const nanodbc::database_error& e) {
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            page.items.push_back(reviewFromRow(row));
+        });
+        finishPage(page, pageRequest);
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getReviewsByRestaurantId: " << e.what() << std::endl;
     }
-    return reviews;
+    return page;
 }
 
 std::optional<Review> ReviewData::getReviewById(int id) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, user_id, restaurant_id, rating, comment FROM reviews WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT id, user_id, restaurant_id, rating, comment FROM reviews WHERE id = ?");
         stmt.bind(0, &id);
-        nanodbc::result result = nanodbc::execute(stmt);
+        nanodbc::result result = conn.execute(stmt);
         
         if (result.next()) {
             Review review;
@@ -92,7 +105,7 @@ std::optional<Review> ReviewData::getReviewById(int id) {
             review.setComment(result.get<nanodbc::string>("comment", ""));
             return review;
         }
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getReviewById: " << e.what() << std::endl;
     }
     return std::nullopt;
@@ -100,12 +113,11 @@ std::optional<Review> ReviewData::getReviewById(int id) {
 
 std::optional<Review> ReviewData::getUserReviewForRestaurant(int userId, int restaurantId) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, user_id, restaurant_id, rating, comment FROM reviews WHERE user_id = ? AND restaurant_id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT id, user_id, restaurant_id, rating, comment FROM reviews WHERE user_id = ? AND restaurant_id = ?");
         stmt.bind(0, &userId);
         stmt.bind(1, &restaurantId);
-        nanodbc::result result = nanodbc::execute(stmt);
+        nanodbc::result result = conn.execute(stmt);
         
         if (result.next()) {
             Review review;
@@ -116,7 +128,7 @@ std::optional<Review> ReviewData::getUserReviewForRestaurant(int userId, int res
             review.setComment(result.get<nanodbc::string>("comment", ""));
             return review;
         }
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getUserReviewForRestaurant: " << e.what() << std::endl;
     }
     return std::nullopt;
@@ -124,9 +136,8 @@ std::optional<Review> ReviewData::getUserReviewForRestaurant(int userId, int res
 
 bool ReviewData::addReview(const Review& review) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "INSERT INTO reviews (user_id, restaurant_id, rating, comment) VALUES (?, ?, ?, ?)");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("INSERT INTO reviews (user_id, restaurant_id, rating, comment) VALUES (?, ?, ?, ?)");
         
         int userId = review.getUserId();
         int restaurantId = review.getRestaurantId();
@@ -138,13 +149,13 @@ bool ReviewData::addReview(const Review& review) {
         stmt.bind(2, &rating);
         stmt.bind(3, comment.c_str());
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         
         // Update restaurant rating
-        updateRestaurantRating(restaurantId);
+        updateRestaurantRating(conn, restaurantId);
         
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in addReview: " << e.what() << std::endl;
         return false;
     }
@@ -152,9 +163,8 @@ bool ReviewData::addReview(const Review& review) {
 
 bool ReviewData::updateReview(const Review& review) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE reviews SET rating = ?, comment = ? WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE reviews SET rating = ?, comment = ? WHERE id = ?");
         
         int rating = review.getRating();
         std::string comment = review.getComment();
@@ -164,14 +174,14 @@ bool ReviewData::updateReview(const Review& review) {
         stmt.bind(1, comment.c_str());
         stmt.bind(2, &id);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         
         // Update restaurant rating
         int restaurantId = review.getRestaurantId();
-        updateRestaurantRating(restaurantId);
+        updateRestaurantRating(conn, restaurantId);
         
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in updateReview: " << e.what() << std::endl;
         return false;
     }
@@ -182,29 +192,27 @@ bool ReviewData::deleteReview(int id) {
         // First, get the restaurant ID to update its rating later
         int restaurantId = 0;
         
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement getStmt(conn);
-        nanodbc::prepare(getStmt, "SELECT restaurant_id FROM reviews WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& getStmt = conn.prepare("SELECT restaurant_id FROM reviews WHERE id = ?");
         getStmt.bind(0, &id);
-        nanodbc::result getResult = nanodbc::execute(getStmt);
+        nanodbc::result getResult = conn.execute(getStmt);
         
         if (getResult.next()) {
             restaurantId = getResult.get<int>("restaurant_id");
         }
         
         // Delete the review
-        nanodbc::statement deleteStmt(conn);
-        nanodbc::prepare(deleteStmt, "DELETE FROM reviews WHERE id = ?");
+        nanodbc::statement& deleteStmt = conn.prepare("DELETE FROM reviews WHERE id = ?");
         deleteStmt.bind(0, &id);
-        nanodbc::execute(deleteStmt);
+        conn.execute(deleteStmt);
         
         // Update restaurant rating if we found a restaurant ID
         if (restaurantId > 0) {
-            updateRestaurantRating(restaurantId);
+            updateRestaurantRating(conn, restaurantId);
         }
         
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in deleteReview: " << e.what() << std::endl;
         return false;
     }
@@ -212,18 +220,17 @@ bool ReviewData::deleteReview(int id) {
 
 float ReviewData::getAverageRatingForRestaurant(int restaurantId) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT AVG(rating) as avg_rating FROM reviews WHERE restaurant_id = ?");
+        PooledConnection conn = dbConnection.getReadConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT AVG(rating) as avg_rating FROM reviews WHERE restaurant_id = ?");
         stmt.bind(0, &restaurantId);
-        nanodbc::result result = nanodbc::execute(stmt);
+        nanodbc::result result = conn.execute(stmt);
         
         if (result.next()) {
             float avgRating = result.get<float>(0, 0.0);
             std::cout << "Calculated average rating for restaurant " << restaurantId << ": " << avgRating << std::endl;
             return avgRating;
         }
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getAverageRatingForRestaurant: " << e.what() << std::endl;
     }
     std::cout << "No reviews found for restaurant " << restaurantId << ", returning 0.0" << std::endl;
@@ -232,16 +239,15 @@ float ReviewData::getAverageRatingForRestaurant(int restaurantId) {
 
 int ReviewData::getReviewCountForRestaurant(int restaurantId) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT COUNT(*) FROM reviews WHERE restaurant_id = ?");
+        PooledConnection conn = dbConnection.getReadConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT COUNT(*) FROM reviews WHERE restaurant_id = ?");
         stmt.bind(0, &restaurantId);
-        nanodbc::result result = nanodbc::execute(stmt);
+        nanodbc::result result = conn.execute(stmt);
         
         if (result.next()) {
             return result.get<int>(0, 0);
         }
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getReviewCountForRestaurant: " << e.what() << std::endl;
     }
     return 0;
@@ -250,21 +256,28 @@ int ReviewData::getReviewCountForRestaurant(int restaurantId) {
 // Helper method to update restaurant rating based on reviews
 void ReviewData::updateRestaurantRating(int restaurantId) {
     try {
-        float avgRating = getAverageRatingForRestaurant(restaurantId);
-        
-        std::cout << "Updating restaurant " << restaurantId << " rating to: " << avgRating << std::endl;
+        PooledConnection conn = dbConnection.getConnection();
+        updateRestaurantRating(conn, restaurantId);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in updateRestaurantRating: " << e.what() << std::endl;
+    }
+}
+
+void ReviewData::updateRestaurantRating(PooledConnection& conn, int restaurantId) {
+    try {
+        std::cout << "Updating restaurant " << restaurantId << " rating" << std::endl;
         
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE restaurants SET rating = ? WHERE id = ?");
+        // Averaged on the primary in the same statement: a replica may not have the review just written
+        nanodbc::statement& stmt = conn.prepare(
+            "UPDATE restaurants SET rating = (SELECT COALESCE(AVG(rating), 0) FROM reviews WHERE restaurant_id = ?) WHERE id = ?");
         
-        stmt.bind(0, &avgRating);
+        stmt.bind(0, &restaurantId);
         stmt.bind(1, &restaurantId);
         
-        nanodbc::result result = nanodbc::execute(stmt);
+        nanodbc::result result = conn.execute(stmt);
         
         std::cout << "Restaurant " << restaurantId << " rating updated successfully" << std::endl;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in updateRestaurantRating: " << e.what() << std::endl;
     }
 }
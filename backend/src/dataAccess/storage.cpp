@@ -0,0 +1,129 @@
+#include "dataAccess/storage.h"
+#include "dataAccess/memoryStorage.h"
+#include "dataAccess/paymentData.h"
+#include "dataAccess/reservationData.h"
+#include "dataAccess/restaurantData.h"
+#include "dataAccess/reviewData.h"
+#include "dataAccess/tableData.h"
+#include "dataAccess/tokenData.h"
+#include "dataAccess/userData.h"
+#include "utils/envLoader.h"
+#ifdef BOOKBITE_MARIADB_NATIVE
+#include "dataAccess/native/nativeStores.h"
+#endif
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <memory>
+
+namespace {
+
+// The DAOs are stateless apart from their DbConnection handle, so one of each serves every caller.
+// They all borrow from the one DbContext, which opens its pool on the first query.
+class MariaDbStorage : public Storage {
+public:
+    explicit MariaDbStorage(DbContext& context)
+        : reservationData(context), tableData(context), userData(context), restaurantData(context),
+          reviewData(context), paymentData(context), tokenData(context) {}
+
+    StorageBackend backend() const override { return StorageBackend::MariaDb; }
+    ReservationStore& reservations() override { return reservationData; }
+    TableStore& tables() override { return tableData; }
+    UserStore& users() override { return userData; }
+    RestaurantStore& restaurants() override { return restaurantData; }
+    ReviewStore& reviews() override { return reviewData; }
+    PaymentStore& payments() override { return paymentData; }
+    TokenStore& tokens() override { return tokenData; }
+
+private:
+    ReservationData reservationData;
+    TableData tableData;
+    UserData userData;
+    RestaurantData restaurantData;
+    ReviewData reviewData;
+    PaymentData paymentData;
+    TokenData tokenData;
+};
+
+#ifdef BOOKBITE_MARIADB_NATIVE
+// Reservation, user and token stores on Connector/C; tables, restaurants, reviews and payments
+// stay on the ODBC DAOs, which share the schema
+class MariaDbNativeStorage : public Storage {
+public:
+    explicit MariaDbNativeStorage(DbContext& context)
+        : reservationStore(context), tableData(context), userStore(context), restaurantData(context),
+          reviewData(context), paymentData(context) {}
+
+    StorageBackend backend() const override { return StorageBackend::MariaDbNative; }
+    ReservationStore& reservations() override { return reservationStore; }
+    TableStore& tables() override { return tableData; }
+    UserStore& users() override { return userStore; }
+    RestaurantStore& restaurants() override { return restaurantData; }
+    ReviewStore& reviews() override { return reviewData; }
+    PaymentStore& payments() override { return paymentData; }
+    TokenStore& tokens() override { return tokenStore; }
+
+private:
+    NativeReservationStore reservationStore;
+    TableData tableData;
+    NativeUserStore userStore;
+    RestaurantData restaurantData;
+    ReviewData reviewData;
+    PaymentData paymentData;
+    NativeTokenStore tokenStore;
+};
+#endif
+
+std::unique_ptr<Storage> createStorage(StorageBackend backend) {
+    if (backend == StorageBackend::Memory) {
+        return MemoryStorage::fromEnvironment();
+    }
+#ifdef BOOKBITE_MARIADB_NATIVE
+    if (backend == StorageBackend::MariaDbNative) {
+        return std::make_unique<MariaDbNativeStorage>(DbContext::instance());
+    }
+#endif
+    return std::make_unique<MariaDbStorage>(DbContext::instance());
+}
+
+} // namespace
+
+Storage& Storage::instance() {
+    static std::unique_ptr<Storage> storage = createStorage(backendFromEnvironment());
+    return *storage;
+}
+
+StorageBackend Storage::backendFromEnvironment() {
+    std::string name = EnvLoader::getEnv("STORAGE_BACKEND", "mariadb");
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (name == "memory") {
+        return StorageBackend::Memory;
+    }
+    if (name == "mariadb-native") {
+#ifdef BOOKBITE_MARIADB_NATIVE
+        return StorageBackend::MariaDbNative;
+#else
+        std::cerr << "STORAGE_BACKEND=mariadb-native needs a build with -DBOOKBITE_MARIADB_NATIVE=ON, using mariadb" << std::endl;
+        return StorageBackend::MariaDb;
+#endif
+    }
+    if (name != "mariadb") {
+        std::cerr << "Unknown STORAGE_BACKEND '" << name << "', using mariadb" << std::endl;
+    }
+    return StorageBackend::MariaDb;
+}
+
+const char* Storage::backendName(StorageBackend backend) {
+    switch (backend) {
+    case StorageBackend::Memory:
+        return "memory";
+    case StorageBackend::MariaDbNative:
+        return "mariadb-native";
+    default:
+        return "mariadb";
+    }
+}
+
+bool Storage::usesDatabase(StorageBackend backend) {
+    return backend != StorageBackend::Memory;
+}
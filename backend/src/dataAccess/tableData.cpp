@@ -1,26 +1,39 @@
 #include "dataAccess/tableData.h"
 #include <nanodbc/nanodbc.h>
 #include <iostream>
+#include <unordered_map>
 
-TableData::TableData() {}
+TableData::TableData(DbContext& context) : dbConnection("TableData", context) {}
+
+Table TableData::tableFromRow(const RowsetRow& row) {
+    Table table;
+    table.setId(row.get<int>(0));
+    table.setRestaurantId(row.get<int>(1));
+    table.setSeatCount(row.get<int>(2));
+    table.setIsAvailable(row.get<int>(3) != 0);  // Convert int to bool
+    return table;
+}
+
+ReservationInfo TableData::reservationInfoFromRow(const RowsetRow& row) {
+    ReservationInfo reservation;
+    reservation.id = row.get<int>(0);
+    reservation.date = row.get<nanodbc::string>(2, "");
+    reservation.startTime = row.get<nanodbc::string>(3, "");
+    reservation.endTime = row.get<nanodbc::string>(4, "");
+    reservation.status = row.get<nanodbc::string>(5, "");
+    reservation.guestCount = row.get<int>(6);
+    return reservation;
+}
 
 std::vector<Table> TableData::getAllTables() {
     std::vector<Table> tables;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, restaurant_id, seat_count, is_available FROM tables");
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            Table table;
-            table.setId(result.get<int>("id"));
-            table.setRestaurantId(result.get<int>("restaurant_id"));
-            table.setSeatCount(result.get<int>("seat_count"));
-            table.setIsAvailable(result.get<int>("is_available") != 0);  // Convert int to bool
-            tables.push_back(table);
-        }
-    } catch (const nanodbc::database_error& e) {
+        PooledConnection conn = dbConnection.getReadConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT id, restaurant_id, seat_count, is_available FROM tables");
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            tables.push_back(tableFromRow(row));
+        });
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getAllTables: " << e.what() << std::endl;
     }
     return tables;
@@ -29,21 +42,13 @@ std::vector<Table> TableData::getAllTables() {
 std::vector<Table> TableData::getTablesByRestaurantId(int restaurantId) {
     std::vector<Table> tables;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, restaurant_id, seat_count, is_available FROM tables WHERE restaurant_id = ?");
+        PooledConnection conn = dbConnection.getReadConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT id, restaurant_id, seat_count, is_available FROM tables WHERE restaurant_id = ?");
         stmt.bind(0, &restaurantId);
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            Table table;
-            table.setId(result.get<int>("id"));
-            table.setRestaurantId(result.get<int>("restaurant_id"));
-            table.setSeatCount(result.get<int>("seat_count"));
-            table.setIsAvailable(result.get<int>("is_available") != 0);  // Convert int to bool
-            tables.push_back(table);
-        }
-    } catch (const nanodbc::database_error& e) {
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            tables.push_back(tableFromRow(row));
+        });
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getTablesByRestaurantId: " << e.what() << std::endl;
     }
     return tables;
@@ -52,23 +57,17 @@ std::vector<Table> TableData::getTablesByRestaurantId(int restaurantId) {
 std::vector<Table> TableData::getAvailableTablesByRestaurantId(int restaurantId) {
     std::vector<Table> tables;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
+        PooledConnection conn = dbConnection.getReadConnection();
         // Return all tables for the restaurant since availability is now time-based
-        nanodbc::prepare(stmt, "SELECT id, restaurant_id, seat_count, is_available FROM tables WHERE restaurant_id = ?");
+        nanodbc::statement& stmt = conn.prepare("SELECT id, restaurant_id, seat_count, is_available FROM tables WHERE restaurant_id = ?");
         stmt.bind(0, &restaurantId);
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            Table table;
-            table.setId(result.get<int>("id"));
-            table.setRestaurantId(result.get<int>("restaurant_id"));
-            table.setSeatCount(result.get<int>("seat_count"));
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            Table table = tableFromRow(row);
             // Set all tables as available since we now use time-based availability checking
             table.setIsAvailable(true);
             tables.push_back(table);
-        }
-    } catch (const nanodbc::database_error& e) {
+        });
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getAvailableTablesByRestaurantId: " << e.what() << std::endl;
     }
     return tables;
@@ -76,11 +75,10 @@ std::vector<Table> TableData::getAvailableTablesByRestaurantId(int restaurantId)
 
 std::optional<Table> TableData::getTableById(int id) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, restaurant_id, seat_count, is_available FROM tables WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT id, restaurant_id, seat_count, is_available FROM tables WHERE id = ?");
         stmt.bind(0, &id);
-        nanodbc::result result = nanodbc::execute(stmt);
+        nanodbc::result result = conn.execute(stmt);
         
         if (result.next()) {
             Table table;
@@ -90,7 +88,7 @@ std::optional<Table> TableData::getTableById(int id) {
             table.setIsAvailable(result.get<int>("is_available") != 0);  // Convert int to bool
             return table;
         }
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getTableById: " << e.what() << std::endl;
     }
     return std::nullopt;
@@ -98,9 +96,8 @@ std::optional<Table> TableData::getTableById(int id) {
 
 int TableData::addTable(const Table& table) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "INSERT INTO tables (restaurant_id, seat_count, is_available) VALUES (?, ?, ?)");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("INSERT INTO tables (restaurant_id, seat_count, is_available) VALUES (?, ?, ?)");
         
         int restaurantId = table.getRestaurantId();
         int seatCount = table.getSeatCount();
@@ -110,12 +107,11 @@ int TableData::addTable(const Table& table) {
         stmt.bind(1, &seatCount);
         stmt.bind(2, &isAvailable);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         
         // Get the last inserted ID
-        nanodbc::statement idStmt(conn);
-        nanodbc::prepare(idStmt, "SELECT LAST_INSERT_ID()");
-        nanodbc::result idResult = nanodbc::execute(idStmt);
+        nanodbc::statement& idStmt = conn.prepare("SELECT LAST_INSERT_ID()");
+        nanodbc::result idResult = conn.execute(idStmt);
         
         int tableId = 0;
         if (idResult.next()) {
@@ -123,32 +119,67 @@ int TableData::addTable(const Table& table) {
         }
         
         // Update the table_count in the restaurants table
-        nanodbc::statement countStmt(conn);
-        nanodbc::prepare(countStmt, "SELECT COUNT(*) FROM tables WHERE restaurant_id = ?");
+        nanodbc::statement& countStmt = conn.prepare("SELECT COUNT(*) FROM tables WHERE restaurant_id = ?");
         countStmt.bind(0, &restaurantId);
-        nanodbc::result countResult = nanodbc::execute(countStmt);
+        nanodbc::result countResult = conn.execute(countStmt);
         
         if (countResult.next()) {
             int tableCount = countResult.get<int>(0);
-            nanodbc::statement updateStmt(conn);
-            nanodbc::prepare(updateStmt, "UPDATE restaurants SET table_count = ? WHERE id = ?");
+            nanodbc::statement& updateStmt = conn.prepare("UPDATE restaurants SET table_count = ? WHERE id = ?");
             updateStmt.bind(0, &tableCount);
             updateStmt.bind(1, &restaurantId);
-            nanodbc::execute(updateStmt);
+            conn.execute(updateStmt);
         }
         
         return tableId;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in addTable: " << e.what() << std::endl;
         return 0;
     }
 }
 
+int TableData::addTables(int restaurantId, const std::vector<Table>& tables) {
+    if (tables.empty()) {
+        return 0;
+    }
+    
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::transaction transaction(conn.get());
+        
+        std::vector<int> restaurantIds(tables.size(), restaurantId);
+        std::vector<int> seatCounts;
+        std::vector<int> availability;
+        seatCounts.reserve(tables.size());
+        availability.reserve(tables.size());
+        for (const auto& table : tables) {
+            seatCounts.push_back(table.getSeatCount());
+            availability.push_back(table.getIsAvailable() ? 1 : 0);
+        }
+        
+        nanodbc::statement& insertStmt = conn.prepare("INSERT INTO tables (restaurant_id, seat_count, is_available) VALUES (?, ?, ?)");
+        insertStmt.bind(0, restaurantIds.data(), tables.size());
+        insertStmt.bind(1, seatCounts.data(), tables.size());
+        insertStmt.bind(2, availability.data(), tables.size());
+        conn.execute(insertStmt, static_cast<long>(tables.size()));
+        
+        nanodbc::statement& countStmt = conn.prepare("UPDATE restaurants SET table_count = (SELECT COUNT(*) FROM tables WHERE restaurant_id = ?) WHERE id = ?");
+        countStmt.bind(0, &restaurantId);
+        countStmt.bind(1, &restaurantId);
+        conn.execute(countStmt);
+        
+        transaction.commit();
+        return static_cast<int>(tables.size());
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in addTables: " << e.what() << std::endl;
+        return 0;
+    }
+}
+
 bool TableData::updateTable(const Table& table) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE tables SET restaurant_id = ?, seat_count = ?, is_available = ? WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE tables SET restaurant_id = ?, seat_count = ?, is_available = ? WHERE id = ?");
         
         int restaurantId = table.getRestaurantId();
         int seatCount = table.getSeatCount();
@@ -160,9 +191,9 @@ bool TableData::updateTable(const Table& table) {
         stmt.bind(2, &isAvailable);
         stmt.bind(3, &id);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in updateTable: " << e.what() << std::endl;
         return false;
     }
@@ -171,11 +202,10 @@ bool TableData::updateTable(const Table& table) {
 bool TableData::deleteTable(int id) {
     try {
         // First, get the restaurant ID for this table
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement getRestaurantIdStmt(conn);
-        nanodbc::prepare(getRestaurantIdStmt, "SELECT restaurant_id FROM tables WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& getRestaurantIdStmt = conn.prepare("SELECT restaurant_id FROM tables WHERE id = ?");
         getRestaurantIdStmt.bind(0, &id);
-        nanodbc::result getRestaurantIdResult = nanodbc::execute(getRestaurantIdStmt);
+        nanodbc::result getRestaurantIdResult = conn.execute(getRestaurantIdStmt);
         
         int restaurantId = 0;
         if (getRestaurantIdResult.next()) {
@@ -183,30 +213,27 @@ bool TableData::deleteTable(int id) {
         }
         
         // Now delete the table
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "DELETE FROM tables WHERE id = ?");
+        nanodbc::statement& stmt = conn.prepare("DELETE FROM tables WHERE id = ?");
         stmt.bind(0, &id);
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         
         // If we have a valid restaurant ID, update the table_count in the restaurants table
         if (restaurantId > 0) {
-            nanodbc::statement countStmt(conn);
-            nanodbc::prepare(countStmt, "SELECT COUNT(*) FROM tables WHERE restaurant_id = ?");
+            nanodbc::statement& countStmt = conn.prepare("SELECT COUNT(*) FROM tables WHERE restaurant_id = ?");
             countStmt.bind(0, &restaurantId);
-            nanodbc::result countResult = nanodbc::execute(countStmt);
+            nanodbc::result countResult = conn.execute(countStmt);
             
             if (countResult.next()) {
                 int tableCount = countResult.get<int>(0);
-                nanodbc::statement updateStmt(conn);
-                nanodbc::prepare(updateStmt, "UPDATE restaurants SET table_count = ? WHERE id = ?");
+                nanodbc::statement& updateStmt = conn.prepare("UPDATE restaurants SET table_count = ? WHERE id = ?");
                 updateStmt.bind(0, &tableCount);
                 updateStmt.bind(1, &restaurantId);
-                nanodbc::execute(updateStmt);
+                conn.execute(updateStmt);
             }
         }
         
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in deleteTable: " << e.what() << std::endl;
         return false;
     }
@@ -214,18 +241,17 @@ bool TableData::deleteTable(int id) {
 
 bool TableData::updateTableAvailability(int id, bool isAvailable) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE tables SET is_available = ? WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE tables SET is_available = ? WHERE id = ?");
         
         int isAvailableInt = isAvailable ? 1 : 0;  // Convert bool to int
         
         stmt.bind(0, &isAvailableInt);
         stmt.bind(1, &id);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in updateTableAvailability: " << e.what() << std::endl;
         return false;
     }
@@ -234,49 +260,37 @@ bool TableData::updateTableAvailability(int id, bool isAvailable) {
 std::vector<Table> TableData::getTablesWithReservationsByRestaurantId(int restaurantId) {
     std::vector<Table> tables;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
+        PooledConnection conn = dbConnection.getReadConnection();
         
-        // First get all tables for the restaurant
-        nanodbc::statement tableStmt(conn);
-        nanodbc::prepare(tableStmt, "SELECT id, restaurant_id, seat_count, is_available FROM tables WHERE restaurant_id = ?");
-        tableStmt.bind(0, &restaurantId);
-        nanodbc::result tableResult = nanodbc::execute(tableStmt);
+        // Tables, then current and upcoming reservations for all of them, in one round trip
+        nanodbc::statement& stmt = conn.prepare(
+            "SELECT id, restaurant_id, seat_count, is_available FROM tables WHERE restaurant_id = ?; "
+            "SELECT r.id, r.table_id, r.date, r.start_time, r.end_time, r.status, r.guest_count "
+            "FROM reservations r JOIN tables t ON t.id = r.table_id "
+            "WHERE t.restaurant_id = ? AND r.status != 'cancelled' AND r.date >= CURDATE() "
+            "ORDER BY r.date, r.start_time");
+        stmt.bind(0, &restaurantId);
+        stmt.bind(1, &restaurantId);
         
-        while (tableResult.next()) {
-            Table table;
-            int tableId = tableResult.get<int>("id");
-            table.setId(tableId);
-            table.setRestaurantId(tableResult.get<int>("restaurant_id"));
-            table.setSeatCount(tableResult.get<int>("seat_count"));
-            // Set all tables as available for booking
-            table.setIsAvailable(true);
-            
-            // Now get current and upcoming reservations for this table
-            nanodbc::statement reservationStmt(conn);
-            nanodbc::prepare(reservationStmt, 
-                "SELECT id, date, start_time, end_time, status, guest_count FROM reservations "
-                "WHERE table_id = ? AND status != 'cancelled' AND date >= CURDATE() "
-                "ORDER BY date, start_time");
-            reservationStmt.bind(0, &tableId);
-            nanodbc::result reservationResult = nanodbc::execute(reservationStmt);
-            
-            std::vector<ReservationInfo> reservations;
-            while (reservationResult.next()) {
-                ReservationInfo reservation;
-                reservation.id = reservationResult.get<int>("id");
-                reservation.date = reservationResult.get<nanodbc::string>("date", "");
-                reservation.startTime = reservationResult.get<nanodbc::string>("start_time", "");
-                reservation.endTime = reservationResult.get<nanodbc::string>("end_time", "");
-                reservation.status = reservationResult.get<nanodbc::string>("status", "");
-                reservation.guestCount = reservationResult.get<int>("guest_count");
-                reservations.push_back(reservation);
-            }
-            
-            table.setReservations(reservations);
-            tables.push_back(table);
-        }
-    } catch (const nanodbc::database_error& e) {
+        std::unordered_map<int, std::size_t> tableIndex;
+        conn.fetchResults(stmt, {
+            [&](const RowsetRow& row) {
+                Table table = tableFromRow(row);
+                // Set all tables as available for booking
+                table.setIsAvailable(true);
+                tableIndex[table.getId()] = tables.size();
+                tables.push_back(table);
+            },
+            [&](const RowsetRow& row) {
+                auto it = tableIndex.find(row.get<int>(1));
+                if (it != tableIndex.end()) {
+                    tables[it->second].addReservation(reservationInfoFromRow(row));
+                }
+            },
+        });
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getTablesWithReservationsByRestaurantId: " << e.what() << std::endl;
+        tables.clear();
     }
     return tables;
 }
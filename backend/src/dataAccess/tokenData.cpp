@@ -0,0 +1,110 @@
+#include "dataAccess/tokenData.h"
+#include <nanodbc/nanodbc.h>
+#include <iostream>
+
+TokenData::TokenData(DbContext& context) : dbConnection("TokenData", context) {}
+
+bool TokenData::storeToken(const std::string& token, int userId, std::chrono::seconds ttl) {
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+
+        nanodbc::statement& stmt = conn.prepare("INSERT INTO user_tokens (token, user_id, expires_at) VALUES (?, ?, DATE_ADD(NOW(), INTERVAL ? SECOND))");
+
+        long long ttlSeconds = ttl.count();
+        stmt.bind(0, token.c_str());
+        stmt.bind(1, &userId);
+        stmt.bind(2, &ttlSeconds);
+
+        conn.execute(stmt);
+        return true;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in storeToken: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool TokenData::isTokenActive(const std::string& token) {
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT COUNT(*) FROM user_tokens WHERE token = ? AND is_active = TRUE AND (expires_at IS NULL OR expires_at > NOW())");
+
+        stmt.bind(0, token.c_str());
+        nanodbc::result result = conn.execute(stmt);
+
+        if (result.next()) {
+            return result.get<int>(0) > 0;
+        }
+        return false;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in isTokenActive: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+int TokenData::getUserIdForToken(const std::string& token) {
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT user_id FROM user_tokens WHERE token = ? AND is_active = TRUE AND (expires_at IS NULL OR expires_at > NOW())");
+
+        stmt.bind(0, token.c_str());
+        nanodbc::result result = conn.execute(stmt);
+
+        if (result.next()) {
+            return result.get<int>("user_id");
+        }
+        return -1;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in getUserIdForToken: " << e.what() << std::endl;
+        return -1;
+    }
+}
+
+std::optional<ActiveToken> TokenData::getActiveToken(const std::string& token) {
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT user_id, TIMESTAMPDIFF(SECOND, NOW(), expires_at) FROM user_tokens WHERE token = ? AND is_active = TRUE AND (expires_at IS NULL OR expires_at > NOW())");
+
+        stmt.bind(0, token.c_str());
+        nanodbc::result result = conn.execute(stmt);
+
+        if (result.next()) {
+            ActiveToken active;
+            active.userId = result.get<int>(0);
+            if (!result.is_null(1)) {
+                active.expiresIn = std::chrono::seconds(result.get<long long>(1));
+            }
+            return active;
+        }
+        return std::nullopt;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in getActiveToken: " << e.what() << std::endl;
+        return std::nullopt;
+    }
+}
+
+void TokenData::revokeToken(const std::string& token) {
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE user_tokens SET is_active = FALSE WHERE token = ?");
+
+        stmt.bind(0, token.c_str());
+        conn.execute(stmt);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in revokeToken: " << e.what() << std::endl;
+    }
+}
+
+int TokenData::deleteExpiredTokens(int limit) {
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare(
+            "DELETE FROM user_tokens WHERE expires_at IS NOT NULL AND expires_at < NOW() ORDER BY expires_at LIMIT ?");
+
+        stmt.bind(0, &limit);
+        nanodbc::result result = conn.execute(stmt);
+        return static_cast<int>(result.affected_rows());
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in deleteExpiredTokens: " << e.what() << std::endl;
+        return -1;
+    }
+}
@@ -1,125 +1,197 @@
 #include "dataAccess/userData.h"
+#include "utils/batchLoader.h"
+#include "utils/keysetScan.h"
 #include <nanodbc/nanodbc.h>
 #include <iostream>
-#include <openssl/sha.h>
-#include <iomanip>
-#include <sstream>
 
-UserData::UserData() {}
+namespace {
 
-// Use this function for password hashing
-std::string hashPassword(const std::string& password) {
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256_CTX sha256;
-    SHA256_Init(&sha256);
-    SHA256_Update(&sha256, password.c_str(), password.size());
-    SHA256_Final(hash, &sha256);
+// How long the cached user_roles table is used before it is read again
+const std::chrono::minutes roleCacheRefresh(5);
+
+// Maps a users row by position: u.id, username, email, password_hash, role_id, first_name,
+// last_name, phone_number, is_active, created_at. The role is filled in by UserData::applyRole.
+User userFromRow(const RowsetRow& row) {
+    User user;
+    user.setId(row.get<int>(0));
+    user.setUsername(row.get<nanodbc::string>(1, ""));
+    user.setEmail(row.get<nanodbc::string>(2, ""));
+    user.setPasswordHash(row.get<nanodbc::string>(3, ""));
+    user.setRoleId(row.get<int>(4, 1));
+    user.setFirstName(row.get<nanodbc::string>(5, ""));
+    user.setLastName(row.get<nanodbc::string>(6, ""));
+    user.setPhoneNumber(row.get<nanodbc::string>(7, ""));
+    user.setActive(row.get<int>(8, 1) == 1);
+    user.setCreatedAt(row.get<nanodbc::string>(9, ""));
+    return user;
+}
+
+} // namespace
+
+UserData::UserData(DbContext& context) : dbConnection("UserData", context) {}
+
+void UserData::ensureRolesLoaded() {
+    {
+        std::shared_lock<std::shared_mutex> lock(roleMutex);
+        if (rolesLoaded && std::chrono::steady_clock::now() - rolesLoadedAt < roleCacheRefresh) {
+            return;
+        }
+    }
+    
+    std::map<int, UserRole> loaded;
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("SELECT id, name, description, permissions FROM user_roles ORDER BY id");
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            UserRole role;
+            role.setId(row.get<int>(0));
+            role.setName(row.get<nanodbc::string>(1, ""));
+            role.setDescription(row.get<nanodbc::string>(2, ""));
+            role.setPermissions(parsePermissionSet(row.get<nanodbc::string>(3, "[]")));
+            loaded[role.getId()] = role;
+        });
+    } catch (const std::runtime_error& e) {
+        // Keep serving the previous table; the next call tries again
+        std::cerr << "Database error in ensureRolesLoaded: " << e.what() << std::endl;
+        return;
+    }
     
-    std::stringstream ss;
-    for(int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << (int)hash[i];
+    std::unique_lock<std::shared_mutex> lock(roleMutex);
+    roles = std::move(loaded);
+    rolesLoadedAt = std::chrono::steady_clock::now();
+    rolesLoaded = true;
+}
+
+void UserData::applyRole(User& user) const {
+    std::shared_lock<std::shared_mutex> lock(roleMutex);
+    auto role = roles.find(user.getRoleId());
+    if (role != roles.end()) {
+        user.setRoleName(role->second.getName());
+        user.setPermissions(role->second.getPermissions());
+    } else {
+        user.setRoleName("user");
+        user.setPermissions(PermissionSet());
     }
-    return ss.str();
 }
 
 std::vector<User> UserData::getAllUsers() {
-    std::vector<User> users;
+    return getAllUsers(PageRequest::unbounded()).items;
+}
+
+Page<User> UserData::getAllUsers(const PageRequest& pageRequest) {
+    Page<User> page;
+    ensureRolesLoaded();
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, R"(
+        PooledConnection conn = dbConnection.getConnection();
+        std::string query = R"(
             SELECT u.id, u.username, u.email, u.password_hash, u.role_id, u.first_name, u.last_name, 
-                   u.phone_number, u.is_active, u.created_at, ur.name as role_name, ur.permissions
+                   u.phone_number, u.is_active, u.created_at
             FROM users u 
-            LEFT JOIN user_roles ur ON u.role_id = ur.id
-        )");
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        while (result.next()) {
-            User user;
-            user.setId(result.get<int>("id"));
-            user.setUsername(result.get<nanodbc::string>("username", ""));
-            user.setEmail(result.get<nanodbc::string>("email", ""));
-            user.setPasswordHash(result.get<nanodbc::string>("password_hash", ""));
-            user.setRoleId(result.get<int>("role_id", 1));
-            user.setFirstName(result.get<nanodbc::string>("first_name", ""));
-            user.setLastName(result.get<nanodbc::string>("last_name", ""));
-            user.setPhoneNumber(result.get<nanodbc::string>("phone_number", ""));
-            user.setActive(result.get<int>("is_active", 1) == 1);
-            user.setCreatedAt(result.get<nanodbc::string>("created_at", ""));
-            user.setRoleName(result.get<nanodbc::string>("role_name", "user"));
-            
-            std::string permissionsJson = result.get<nanodbc::string>("permissions", "[]");
-            std::vector<std::string> permissions;
-            if (permissionsJson.find("make_reservation") != std::string::npos) permissions.push_back("make_reservation");
-            if (permissionsJson.find("view_reservations") != std::string::npos) permissions.push_back("view_reservations");
-            if (permissionsJson.find("cancel_reservation") != std::string::npos) permissions.push_back("cancel_reservation");
-            if (permissionsJson.find("write_review") != std::string::npos) permissions.push_back("write_review");
-            if (permissionsJson.find("manage_restaurants") != std::string::npos) permissions.push_back("manage_restaurants");
-            if (permissionsJson.find("manage_users") != std::string::npos) permissions.push_back("manage_users");
-            if (permissionsJson.find("view_admin_panel") != std::string::npos) permissions.push_back("view_admin_panel");
-            if (permissionsJson.find("promote_users") != std::string::npos) permissions.push_back("promote_users");
-            user.setPermissions(permissions);
-            
-            users.push_back(user);
+            WHERE u.id > ?
+            ORDER BY u.id
+        )";
+        if (pageRequest.isBounded()) {
+            query += " LIMIT ?";
         }
-    } catch (const nanodbc::database_error& e) {
+        nanodbc::statement& stmt = conn.prepare(query);
+        int after = pageRequest.after;
+        int fetchLimit = pageRequest.limit + 1;
+        stmt.bind(0, &after);
+        if (pageRequest.isBounded()) {
+            stmt.bind(1, &fetchLimit);
+        }
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            page.items.push_back(userFromRow(row));
+            applyRole(page.items.back());
+        });
+        finishPage(page, pageRequest);
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getAllUsers: " << e.what() << std::endl;
     }
-    return users;
+    return page;
+}
+
+bool UserData::forEachUser(const std::function<void(const User&)>& visit, int batchSize) {
+    ensureRolesLoaded();
+    try {
+        keysetScan(dbConnection, R"(
+            SELECT u.id, u.username, u.email, u.password_hash, u.role_id, u.first_name, u.last_name, 
+                   u.phone_number, u.is_active, u.created_at
+            FROM users u 
+            WHERE u.id > ?
+            ORDER BY u.id
+            LIMIT ?
+        )", batchSize, [&](const RowsetRow& row) {
+            User user = userFromRow(row);
+            applyRole(user);
+            visit(user);
+            return user.getId();
+        });
+        return true;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in forEachUser: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool UserData::forEachAuditLogEntry(const std::function<void(const AuditLogEntry&)>& visit, int batchSize) {
+    try {
+        keysetScan(dbConnection, R"(
+            SELECT l.id, l.admin_user_id, u.username as admin_username, l.action, l.target_type, 
+                   l.target_id, l.details, l.ip_address, l.created_at
+            FROM admin_audit_log l
+            LEFT JOIN users u ON l.admin_user_id = u.id
+            WHERE l.id > ?
+            ORDER BY l.id
+            LIMIT ?
+        )", batchSize, [&](const RowsetRow& row) {
+            AuditLogEntry entry;
+            entry.setId(row.get<int>(0));
+            entry.setAdminUserId(row.get<int>(1));
+            entry.setAdminUsername(row.get<nanodbc::string>(2, ""));
+            entry.setAction(row.get<nanodbc::string>(3, ""));
+            entry.setTargetType(row.get<nanodbc::string>(4, ""));
+            entry.setTargetId(row.get<int>(5, 0));
+            entry.setDetails(row.get<nanodbc::string>(6, ""));
+            entry.setIpAddress(row.get<nanodbc::string>(7, ""));
+            entry.setCreatedAt(row.get<nanodbc::string>(8, ""));
+            visit(entry);
+            return entry.getId();
+        });
+        return true;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in forEachAuditLogEntry: " << e.what() << std::endl;
+        return false;
+    }
 }
 
 std::optional<User> UserData::getUserById(int id) {
     try {
         std::cout << "DEBUG: getUserById called with id: " << id << std::endl;
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, R"(
+        ensureRolesLoaded();
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare(R"(
             SELECT u.id, u.username, u.email, u.password_hash, u.role_id, u.first_name, u.last_name, 
-                   u.phone_number, u.is_active, u.created_at, ur.name as role_name, ur.permissions
+                   u.phone_number, u.is_active, u.created_at
             FROM users u 
-            LEFT JOIN user_roles ur ON u.role_id = ur.id
             WHERE u.id = ?
         )");
         stmt.bind(0, &id);
-        nanodbc::result result = nanodbc::execute(stmt);
+        std::optional<User> user;
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            user = userFromRow(row);
+            applyRole(*user);
+        });
         
         std::cout << "DEBUG: Query executed successfully" << std::endl;
         
-        if (result.next()) {
+        if (user) {
             std::cout << "DEBUG: Found user record" << std::endl;
-            User user;
-            user.setId(result.get<int>("id"));
-            user.setUsername(result.get<nanodbc::string>("username", ""));
-            user.setEmail(result.get<nanodbc::string>("email", ""));
-            user.setPasswordHash(result.get<nanodbc::string>("password_hash", ""));
-            user.setRoleId(result.get<int>("role_id", 1));
-            user.setFirstName(result.get<nanodbc::string>("first_name", ""));
-            user.setLastName(result.get<nanodbc::string>("last_name", ""));
-            user.setPhoneNumber(result.get<nanodbc::string>("phone_number", ""));
-            user.setActive(result.get<int>("is_active", 1) == 1);
-            user.setCreatedAt(result.get<nanodbc::string>("created_at", ""));
-            user.setRoleName(result.get<nanodbc::string>("role_name", "user"));
-            
-            // Parse permissions JSON (simplified)
-            std::string permissionsJson = result.get<nanodbc::string>("permissions", "[]");
-            std::vector<std::string> permissions;
-            if (permissionsJson.find("make_reservation") != std::string::npos) permissions.push_back("make_reservation");
-            if (permissionsJson.find("view_reservations") != std::string::npos) permissions.push_back("view_reservations");
-            if (permissionsJson.find("cancel_reservation") != std::string::npos) permissions.push_back("cancel_reservation");
-            if (permissionsJson.find("write_review") != std::string::npos) permissions.push_back("write_review");
-            if (permissionsJson.find("manage_restaurants") != std::string::npos) permissions.push_back("manage_restaurants");
-            if (permissionsJson.find("manage_users") != std::string::npos) permissions.push_back("manage_users");
-            if (permissionsJson.find("view_admin_panel") != std::string::npos) permissions.push_back("view_admin_panel");
-            if (permissionsJson.find("promote_users") != std::string::npos) permissions.push_back("promote_users");
-            user.setPermissions(permissions);
-            
-            std::cout << "DEBUG: User object created successfully" << std::endl;
             return user;
         } else {
             std::cout << "DEBUG: No user found with id: " << id << std::endl;
         }
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in getUserById: " << e.what() << std::endl;
     } catch (const std::exception& e) {
         std::cerr << "General error in getUserById: " << e.what() << std::endl;
@@ -127,63 +199,73 @@ std::optional<User> UserData::getUserById(int id) {
     return std::nullopt;
 }
 
-std::optional<User> UserData::getUserByUsername(const std::string& username) {
+std::unordered_map<int, User> UserData::getUsersByIds(const std::vector<int>& ids) {
+    std::unordered_map<int, User> users;
+    ensureRolesLoaded();
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, username, email, password_hash, is_active, email_verified, email_verification_token, email_verification_expires FROM users WHERE username = ?");
-        stmt.bind(0, username.c_str());
-        nanodbc::result result = nanodbc::execute(stmt);
+        PooledConnection conn = dbConnection.getConnection();
+        BatchLoader<int, User> loader([this, &conn](const std::vector<int>& keys, std::unordered_map<int, User>& results) {
+            nanodbc::statement& stmt = conn.prepare(
+                "SELECT u.id, u.username, u.email, u.password_hash, u.role_id, u.first_name, u.last_name, "
+                "u.phone_number, u.is_active, u.created_at "
+                "FROM users u "
+                "WHERE u.id IN (" + sqlPlaceholders(keys.size()) + ")");
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                stmt.bind(static_cast<short>(i), &keys[i]);
+            }
+            conn.fetch(stmt, [&](const RowsetRow& row) {
+                User user = userFromRow(row);
+                applyRole(user);
+                results[user.getId()] = user;
+            });
+        });
         
-        if (result.next()) {
-            User user;
-            user.setId(result.get<int>("id"));
-            user.setUsername(result.get<nanodbc::string>("username", ""));
-            user.setEmail(result.get<nanodbc::string>("email", ""));
-            user.setPasswordHash(result.get<nanodbc::string>("password_hash", ""));
-            user.setActive(result.get<int>("is_active", 1) == 1);
-            user.setEmailVerified(result.get<int>("email_verified", 0) == 1);
-            user.setEmailVerificationToken(result.get<nanodbc::string>("email_verification_token", ""));
-            user.setEmailVerificationExpires(result.get<nanodbc::string>("email_verification_expires", ""));
-            return user;
+        for (int id : ids) {
+            loader.add(id);
         }
-    } catch (const nanodbc::database_error& e) {
-        std::cerr << "Database error in getUserByUsername: " << e.what() << std::endl;
+        users = loader.load();
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in getUsersByIds: " << e.what() << std::endl;
     }
-    return std::nullopt;
+    return users;
+}
+
+std::optional<User> UserData::getUserByUsername(const std::string& username) {
+    return getUserByKey("username", username);
 }
 
 std::optional<User> UserData::getUserByEmail(const std::string& email) {
+    return getUserByKey("email", email);
+}
+
+std::optional<User> UserData::getUserByKey(const std::string& column, const std::string& value) {
+    ensureRolesLoaded();
+    std::optional<User> user;
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, username, email, password_hash, email_verified, email_verification_token, email_verification_expires FROM users WHERE email = ?");
-        stmt.bind(0, email.c_str());
-        nanodbc::result result = nanodbc::execute(stmt);
-        
-        if (result.next()) {
-            User user;
-            user.setId(result.get<int>("id"));
-            user.setUsername(result.get<nanodbc::string>("username", ""));
-            user.setEmail(result.get<nanodbc::string>("email", ""));
-            user.setPasswordHash(result.get<nanodbc::string>("password_hash", ""));
-            user.setEmailVerified(result.get<int>("email_verified", 0) == 1);
-            user.setEmailVerificationToken(result.get<nanodbc::string>("email_verification_token", ""));
-            user.setEmailVerificationExpires(result.get<nanodbc::string>("email_verification_expires", ""));
-            return user;
-        }
-    } catch (const nanodbc::database_error& e) {
-        std::cerr << "Database error in getUserByEmail: " << e.what() << std::endl;
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare(
+            "SELECT u.id, u.username, u.email, u.password_hash, u.role_id, u.first_name, u.last_name, u.phone_number, "
+            "u.is_active, u.created_at, u.email_verified, u.email_verification_token, u.email_verification_expires "
+            "FROM users u WHERE u." + column + " = ?");
+        stmt.bind(0, value.c_str());
+        conn.fetch(stmt, [&](const RowsetRow& row) {
+            User found = userFromRow(row);
+            found.setEmailVerified(row.get<int>(10, 0) == 1);
+            found.setEmailVerificationToken(row.get<nanodbc::string>(11, ""));
+            found.setEmailVerificationExpires(row.get<nanodbc::string>(12, ""));
+            applyRole(found);
+            user = found;
+        });
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in getUserBy" << (column == "email" ? "Email" : "Username") << ": " << e.what() << std::endl;
     }
-    return std::nullopt;
+    return user;
 }
 
 bool UserData::addUser(const User& user) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, 
-            "INSERT INTO users (username, email, password_hash, first_name, last_name, email_verified, email_verification_token, email_verification_expires) VALUES (?, ?, ?, ?, ?, ?, ?, FROM_UNIXTIME(?))");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("INSERT INTO users (username, email, password_hash, first_name, last_name, email_verified, email_verification_token, email_verification_expires) VALUES (?, ?, ?, ?, ?, ?, ?, FROM_UNIXTIME(?))");
         
         std::string username = user.getUsername();
         std::string email = user.getEmail();
@@ -205,9 +287,16 @@ bool UserData::addUser(const User& user) {
         stmt.bind(6, verificationToken.c_str());
         stmt.bind(7, &expires);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
     } catch (const nanodbc::database_error& e) {
+        // ER_DUP_ENTRY: the username or email unique key; an expected outcome of registration, not an
+        // error. The rest of SQLSTATE 23000 (NOT NULL, foreign keys) is a real failure and is logged.
+        if (e.native() != 1062) {
+            std::cerr << "Database error in addUser: " << e.what() << std::endl;
+        }
+        return false;
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in addUser: " << e.what() << std::endl;
         return false;
     }
@@ -215,9 +304,8 @@ bool UserData::addUser(const User& user) {
 
 bool UserData::updateUser(const User& user) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE users SET username = ?, email = ?, password_hash = ? WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE users SET username = ?, email = ?, password_hash = ? WHERE id = ?");
         
         std::string username = user.getUsername();
         std::string email = user.getEmail();
@@ -229,9 +317,9 @@ bool UserData::updateUser(const User& user) {
         stmt.bind(2, passwordHash.c_str());
         stmt.bind(3, &id);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in updateUser: " << e.what() << std::endl;
         return false;
     }
@@ -239,121 +327,111 @@ bool UserData::updateUser(const User& user) {
 
 bool UserData::deleteUser(int id) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "DELETE FROM users WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("DELETE FROM users WHERE id = ?");
         
         stmt.bind(0, &id);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in deleteUser: " << e.what() << std::endl;
         return false;
     }
 }
 
-bool UserData::validateUser(const std::string& username, const std::string& password) {
+bool UserData::updatePasswordHash(int userId, const std::string& passwordHash) {
     try {
-        auto user = getUserByUsername(username);
-        if (!user) {
-            return false;
-        }
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE users SET password_hash = ?, updated_at = CURRENT_TIMESTAMP WHERE id = ?");
         
-        if (!user->isActive()) {
-            std::cerr << "Login attempt for inactive user: " << username << std::endl;
-            return false;
-        }
+        stmt.bind(0, passwordHash.c_str());
+        stmt.bind(1, &userId);
         
-        return password == user->getPasswordHash();
-    } catch (const std::exception& e) {
-        std::cerr << "Error in validateUser: " << e.what() << std::endl;
+        conn.execute(stmt);
+        return true;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in updatePasswordHash: " << e.what() << std::endl;
         return false;
     }
 }
 
-std::vector<UserRole> UserData::getAllRoles() {
-    std::vector<UserRole> roles;
+bool UserData::verifyEmailToken(const std::string& token) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, name, description, permissions FROM user_roles ORDER BY id");
-        nanodbc::result result = nanodbc::execute(stmt);
+        PooledConnection conn = dbConnection.getConnection();
+
+        nanodbc::statement& stmt = conn.prepare("SELECT id FROM users WHERE email_verification_token = ? AND email_verification_expires > NOW() AND email_verified = 0");
         
-        while (result.next()) {
-            UserRole role;
-            role.setId(result.get<int>("id"));
-            role.setName(result.get<nanodbc::string>("name", ""));
-            role.setDescription(result.get<nanodbc::string>("description", ""));
+        stmt.bind(0, token.c_str());
+        auto result = conn.execute(stmt);
+
+        if (result.next()) {
+            int userId = result.get<int>(0);
+            
+            nanodbc::statement& updateStmt = conn.prepare("UPDATE users SET email_verified = 1, email_verification_token = NULL, email_verification_expires = NULL WHERE id = ?");
             
-            // Parse permissions JSON (simplified)
-            std::string permissionsJson = result.get<nanodbc::string>("permissions", "[]");
-            std::vector<std::string> permissions;
-            if (permissionsJson.find("make_reservation") != std::string::npos) permissions.push_back("make_reservation");
-            if (permissionsJson.find("view_reservations") != std::string::npos) permissions.push_back("view_reservations");
-            if (permissionsJson.find("cancel_reservation") != std::string::npos) permissions.push_back("cancel_reservation");
-            if (permissionsJson.find("write_review") != std::string::npos) permissions.push_back("write_review");
-            if (permissionsJson.find("manage_restaurants") != std::string::npos) permissions.push_back("manage_restaurants");
-            if (permissionsJson.find("manage_users") != std::string::npos) permissions.push_back("manage_users");
-            if (permissionsJson.find("view_admin_panel") != std::string::npos) permissions.push_back("view_admin_panel");
-            if (permissionsJson.find("promote_users") != std::string::npos) permissions.push_back("promote_users");
-            role.setPermissions(permissions);
+            updateStmt.bind(0, &userId);
+            conn.execute(updateStmt);
             
-            roles.push_back(role);
+            return true;
         }
-    } catch (const nanodbc::database_error& e) {
-        std::cerr << "Database error in getAllRoles: " << e.what() << std::endl;
+        
+        return false;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in verifyEmailToken: " << e.what() << std::endl;
+        return false;
     }
-    return roles;
 }
 
-std::optional<UserRole> UserData::getRoleById(int id) {
+int UserData::clearExpiredVerificationTokens(int limit) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "SELECT id, name, description, permissions FROM user_roles WHERE id = ?");
-        stmt.bind(0, &id);
-        nanodbc::result result = nanodbc::execute(stmt);
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare(
+            "UPDATE users SET email_verification_token = NULL, email_verification_expires = NULL "
+            "WHERE email_verification_expires < NOW() AND email_verification_token IS NOT NULL "
+            "ORDER BY email_verification_expires LIMIT ?");
         
-        if (result.next()) {
-            UserRole role;
-            role.setId(result.get<int>("id"));
-            role.setName(result.get<nanodbc::string>("name", ""));
-            role.setDescription(result.get<nanodbc::string>("description", ""));
-            
-            // Parse permissions JSON (simplified)
-            std::string permissionsJson = result.get<nanodbc::string>("permissions", "[]");
-            std::vector<std::string> permissions;
-            if (permissionsJson.find("make_reservation") != std::string::npos) permissions.push_back("make_reservation");
-            if (permissionsJson.find("view_reservations") != std::string::npos) permissions.push_back("view_reservations");
-            if (permissionsJson.find("cancel_reservation") != std::string::npos) permissions.push_back("cancel_reservation");
-            if (permissionsJson.find("write_review") != std::string::npos) permissions.push_back("write_review");
-            if (permissionsJson.find("manage_restaurants") != std::string::npos) permissions.push_back("manage_restaurants");
-            if (permissionsJson.find("manage_users") != std::string::npos) permissions.push_back("manage_users");
-            if (permissionsJson.find("view_admin_panel") != std::string::npos) permissions.push_back("view_admin_panel");
-            if (permissionsJson.find("promote_users") != std::string::npos) permissions.push_back("promote_users");
-            role.setPermissions(permissions);
-            
-            return role;
-        }
-    } catch (const nanodbc::database_error& e) {
-        std::cerr << "Database error in getRoleById: " << e.what() << std::endl;
+        stmt.bind(0, &limit);
+        
+        nanodbc::result result = conn.execute(stmt);
+        return static_cast<int>(result.affected_rows());
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in clearExpiredVerificationTokens: " << e.what() << std::endl;
+        return -1;
     }
-    return std::nullopt;
+}
+
+std::vector<UserRole> UserData::getAllRoles() {
+    ensureRolesLoaded();
+    std::shared_lock<std::shared_mutex> lock(roleMutex);
+    std::vector<UserRole> roleList;
+    for (const auto& entry : roles) {
+        roleList.push_back(entry.second);
+    }
+    return roleList;
+}
+
+std::optional<UserRole> UserData::getRoleById(int id) {
+    ensureRolesLoaded();
+    std::shared_lock<std::shared_mutex> lock(roleMutex);
+    auto role = roles.find(id);
+    if (role == roles.end()) {
+        return std::nullopt;
+    }
+    return role->second;
 }
 
 bool UserData::updateUserRole(int userId, int roleId) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE users SET role_id = ?, updated_at = CURRENT_TIMESTAMP WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE users SET role_id = ?, updated_at = CURRENT_TIMESTAMP WHERE id = ?");
         
         stmt.bind(0, &roleId);
         stmt.bind(1, &userId);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in updateUserRole: " << e.what() << std::endl;
         return false;
     }
@@ -361,28 +439,50 @@ bool UserData::updateUserRole(int userId, int roleId) {
 
 bool UserData::updateUserStatus(int userId, bool isActive) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, "UPDATE users SET is_active = ?, updated_at = CURRENT_TIMESTAMP WHERE id = ?");
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare("UPDATE users SET is_active = ?, updated_at = CURRENT_TIMESTAMP WHERE id = ?");
         
         int activeStatus = isActive ? 1 : 0;
         stmt.bind(0, &activeStatus);
         stmt.bind(1, &userId);
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in updateUserStatus: " << e.what() << std::endl;
         return false;
     }
 }
 
+int UserData::updateUserStatuses(const std::vector<int>& userIds, bool isActive) {
+    if (userIds.empty()) {
+        return 0;
+    }
+    
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::transaction transaction(conn.get());
+        nanodbc::statement& stmt = conn.prepare("UPDATE users SET is_active = ?, updated_at = CURRENT_TIMESTAMP WHERE id = ?");
+        
+        std::vector<int> activeStatuses(userIds.size(), isActive ? 1 : 0);
+        stmt.bind(0, activeStatuses.data(), activeStatuses.size());
+        stmt.bind(1, userIds.data(), userIds.size());
+        
+        nanodbc::result result = conn.execute(stmt, static_cast<long>(userIds.size()));
+        int changed = static_cast<int>(result.affected_rows());
+        transaction.commit();
+        return changed;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in updateUserStatuses: " << e.what() << std::endl;
+        return -1;
+    }
+}
+
 bool UserData::logAdminAction(int adminUserId, const std::string& action, const std::string& targetType, 
                              int targetId, const std::string& details, const std::string& ipAddress) {
     try {
-        nanodbc::connection conn = dbConnection.getConnection();
-        nanodbc::statement stmt(conn);
-        nanodbc::prepare(stmt, R"(
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare(R"(
             INSERT INTO admin_audit_log (admin_user_id, action, target_type, target_id, details, ip_address) 
             VALUES (?, ?, ?, ?, ?, ?)
         )");
@@ -405,10 +505,45 @@ bool UserData::logAdminAction(int adminUserId, const std::string& action, const
         stmt.bind(4, detailsStr.c_str());
         stmt.bind(5, ipStr.c_str());
         
-        nanodbc::execute(stmt);
+        conn.execute(stmt);
         return true;
-    } catch (const nanodbc::database_error& e) {
+    } catch (const std::runtime_error& e) {
         std::cerr << "Database error in logAdminAction: " << e.what() << std::endl;
         return false;
     }
 }
+
+bool UserData::logAdminActions(int adminUserId, const std::string& action, const std::string& targetType,
+                               const std::vector<int>& targetIds, const std::string& details, const std::string& ipAddress) {
+    if (targetIds.empty()) {
+        return true;
+    }
+    
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        nanodbc::statement& stmt = conn.prepare(R"(
+            INSERT INTO admin_audit_log (admin_user_id, action, target_type, target_id, details, ip_address) 
+            VALUES (?, ?, ?, ?, ?, ?)
+        )");
+        
+        std::size_t count = targetIds.size();
+        std::vector<int> adminUserIds(count, adminUserId);
+        std::vector<std::string> actions(count, action);
+        std::vector<std::string> targetTypes(count, targetType);
+        std::vector<std::string> detailsValues(count, details);
+        std::vector<std::string> ipAddresses(count, ipAddress);
+        
+        stmt.bind(0, adminUserIds.data(), count);
+        stmt.bind_strings(1, actions);
+        stmt.bind_strings(2, targetTypes);
+        stmt.bind(3, targetIds.data(), count);
+        stmt.bind_strings(4, detailsValues);
+        stmt.bind_strings(5, ipAddresses);
+        
+        conn.execute(stmt, static_cast<long>(count));
+        return true;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in logAdminActions: " << e.what() << std::endl;
+        return false;
+    }
+}
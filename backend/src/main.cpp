@@ -1,27 +1,114 @@
 #include <iostream>
+#include <string>
+#include <vector>
 #include "crow.h"
+#include "businessLogic/maintenanceService.h"
 #include "presentation/apiController.h"
+#include "dataAccess/storage.h"
 #include "utils/dbConnection.h"
 #include "utils/envLoader.h"
+#include "utils/maintenanceScheduler.h"
+#include "utils/migrationRunner.h"
 
-int main() {
+namespace {
+
+int runMigrations() {
+    MigrationRunner runner;
+    if (!runner.migrate()) {
+        std::cerr << "Schema migration failed." << std::endl;
+        return 1;
+    }
+    for (const auto& migration : runner.appliedMigrations()) {
+        std::cout << "  v" << migration.version << " " << migration.description
+                  << " (applied " << migration.appliedAt << ", " << migration.executionMs << " ms)" << std::endl;
+    }
+    return 0;
+}
+
+int checkIndexes() {
+    MigrationRunner runner;
+    std::vector<IndexCheck> checks = runner.checkIndexes();
+    if (checks.empty()) {
+        std::cerr << "Could not EXPLAIN the checked queries." << std::endl;
+        return 1;
+    }
+    int missing = 0;
+    for (const auto& check : checks) {
+        const char* verdict = check.usesIndex() ? "OK" : (check.indexAvailable() ? "AVAILABLE" : "MISSING");
+        std::cout << verdict << "  " << check.query << ": " << check.table
+                  << " expected " << check.expectedIndex
+                  << ", key=" << (check.chosenIndex.empty() ? "NULL" : check.chosenIndex)
+                  << ", type=" << check.accessType;
+        if (!check.extra.empty()) {
+            std::cout << ", extra=" << check.extra;
+        }
+        std::cout << std::endl;
+        if (!check.indexAvailable()) {
+            ++missing;
+        }
+    }
+    return missing == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
     EnvLoader::loadFromFile(".env");
+
+    std::string command = argc > 1 ? argv[1] : "";
+    if (command == "--migrate" || command == "--check-indexes") {
+        if (!Storage::usesDatabase(Storage::instance().backend())) {
+            std::cerr << command << " needs a MariaDB STORAGE_BACKEND." << std::endl;
+            return 1;
+        }
+        return command == "--migrate" ? runMigrations() : checkIndexes();
+    }
     
-    DbConnection dbConn;
-    if (!dbConn.isConnected()) {
-        std::cerr << "Failed to connect to the database. Please check your configuration." << std::endl;
-        return 1;
+    if (Storage::usesDatabase(Storage::instance().backend())) {
+        DbConnection dbConn;
+        if (!dbConn.isConnected()) {
+            std::cerr << "Failed to connect to the database. Please check your configuration." << std::endl;
+            return 1;
+        }
+
+        MigrationRunner migrations;
+        if (EnvLoader::getEnv("DB_AUTO_MIGRATE", "false") == "true") {
+            if (!migrations.migrate()) {
+                std::cerr << "Schema migration failed." << std::endl;
+                return 1;
+            }
+        } else {
+            bool requiredPending = false;
+            for (const auto& migration : migrations.pendingMigrations()) {
+                std::cerr << "Pending schema migration " << migration.version << ": " << migration.description
+                          << " (run with --migrate or set DB_AUTO_MIGRATE=true)" << std::endl;
+                requiredPending = requiredPending || migration.required;
+            }
+            if (requiredPending) {
+                // e.g. without migration 2 every new scrypt hash is too long for users.password_hash
+                std::cerr << "Refusing to start until the required migrations above are applied." << std::endl;
+                return 1;
+            }
+        }
+    } else {
+        std::cout << "Using in-memory storage; data is lost when the server stops." << std::endl;
     }
     
-    crow::App<> app;
+    crow::App<AuthMiddleware> app;
     
     app.loglevel(crow::LogLevel::Info);
     
     ApiController apiController;
     apiController.setupRoutes(app);
     
+    MaintenanceService maintenance;
+    MaintenanceScheduler& scheduler = MaintenanceScheduler::instance();
+    maintenance.registerJobs(scheduler);
+    scheduler.start();
+    
     std::cout << "Starting BookBite server on port 8080..." << std::endl;
     app.port(8080).multithreaded().run();
     
+    scheduler.stop();
     return 0;
 }
@@ -0,0 +1,75 @@
+#include "models/auditLogEntry.h"
+
+AuditLogEntry::AuditLogEntry() : id(0), adminUserId(0), targetId(0) {}
+
+int AuditLogEntry::getId() const {
+    return id;
+}
+
+int AuditLogEntry::getAdminUserId() const {
+    return adminUserId;
+}
+
+std::string AuditLogEntry::getAdminUsername() const {
+    return adminUsername;
+}
+
+std::string AuditLogEntry::getAction() const {
+    return action;
+}
+
+std::string AuditLogEntry::getTargetType() const {
+    return targetType;
+}
+
+int AuditLogEntry::getTargetId() const {
+    return targetId;
+}
+
+std::string AuditLogEntry::getDetails() const {
+    return details;
+}
+
+std::string AuditLogEntry::getIpAddress() const {
+    return ipAddress;
+}
+
+std::string AuditLogEntry::getCreatedAt() const {
+    return createdAt;
+}
+
+void AuditLogEntry::setId(int id) {
+    this->id = id;
+}
+
+void AuditLogEntry::setAdminUserId(int adminUserId) {
+    this->adminUserId = adminUserId;
+}
+
+void AuditLogEntry::setAdminUsername(const std::string& adminUsername) {
+    this->adminUsername = adminUsername;
+}
+
+void AuditLogEntry::setAction(const std::string& action) {
+    this->action = action;
+}
+
+void AuditLogEntry::setTargetType(const std::string& targetType) {
+    this->targetType = targetType;
+}
+
+void AuditLogEntry::setTargetId(int targetId) {
+    this->targetId = targetId;
+}
+
+void AuditLogEntry::setDetails(const std::string& details) {
+    this->details = details;
+}
+
+void AuditLogEntry::setIpAddress(const std::string& ipAddress) {
+    this->ipAddress = ipAddress;
+}
+
+void AuditLogEntry::setCreatedAt(const std::string& createdAt) {
+    this->createdAt = createdAt;
+}
@@ -0,0 +1,30 @@
+#include "models/permission.h"
+
+static_assert(permissionFromName("manage_users") == Permission::ManageUsers, "names and enum out of step");
+static_assert(permissionName(Permission::PromoteUsers) == "promote_users", "names and enum out of step");
+
+PermissionSet parsePermissionSet(std::string_view permissionsJson) {
+    PermissionSet permissions;
+    std::size_t pos = 0;
+    while ((pos = permissionsJson.find('"', pos)) != std::string_view::npos) {
+        std::size_t end = permissionsJson.find('"', pos + 1);
+        if (end == std::string_view::npos) {
+            break;
+        }
+        if (auto permission = permissionFromName(permissionsJson.substr(pos + 1, end - pos - 1))) {
+            permissions.set(static_cast<std::size_t>(*permission));
+        }
+        pos = end + 1;
+    }
+    return permissions;
+}
+
+std::vector<std::string> permissionNameList(const PermissionSet& permissions) {
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < permissionCount; ++i) {
+        if (permissions.test(i)) {
+            names.emplace_back(permissionNames[i]);
+        }
+    }
+    return names;
+}
@@ -1,5 +1,4 @@
 #include "models/user.h"
-#include <algorithm>
 
 User::User() : id(0), roleId(1), active(true), emailVerified(false) {}
 
@@ -7,7 +6,7 @@ User::User(int id, const std::string& username, const std::string& email, const
     : id(id), username(username), email(email), passwordHash(passwordHash), roleId(1), active(true), emailVerified(false) {}
 
 User::User(int id, const std::string& username, const std::string& email, const std::string& passwordHash, 
-           int roleId, const std::string& roleName, const std::vector<std::string>& permissions)
+           int roleId, const std::string& roleName, const PermissionSet& permissions)
     : id(id), username(username), email(email), passwordHash(passwordHash), 
       roleId(roleId), roleName(roleName), permissions(permissions), active(true), emailVerified(false) {}
 
@@ -35,7 +34,7 @@ std::string User::getRoleName() const {
     return roleName;
 }
 
-std::vector<std::string> User::getPermissions() const {
+PermissionSet User::getPermissions() const {
     return permissions;
 }
 
@@ -95,7 +94,7 @@ void User::setRoleName(const std::string& roleName) {
     this->roleName = roleName;
 }
 
-void User::setPermissions(const std::vector<std::string>& permissions) {
+void User::setPermissions(const PermissionSet& permissions) {
     this->permissions = permissions;
 }
 
@@ -131,10 +130,10 @@ void User::setCreatedAt(const std::string& createdAt) {
     this->createdAt = createdAt;
 }
 
-bool User::hasPermission(const std::string& permission) const {
-    return std::find(permissions.begin(), permissions.end(), permission) != permissions.end();
+bool User::hasPermission(Permission permission) const {
+    return permissions.test(static_cast<std::size_t>(permission));
 }
 
 bool User::isAdmin() const {
-    return roleName == "admin" || hasPermission("manage_restaurants");
+    return roleName == "admin" || hasPermission(Permission::ManageRestaurants);
 }
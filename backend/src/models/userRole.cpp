@@ -1,10 +1,9 @@
 #include "models/userRole.h"
-#include <algorithm>
 
 UserRole::UserRole() : id(0) {}
 
 UserRole::UserRole(int id, const std::string& name, const std::string& description, 
-                   const std::vector<std::string>& permissions)
+                   const PermissionSet& permissions)
     : id(id), name(name), description(description), permissions(permissions) {}
 
 int UserRole::getId() const {
@@ -19,7 +18,7 @@ std::string UserRole::getDescription() const {
     return description;
 }
 
-std::vector<std::string> UserRole::getPermissions() const {
+PermissionSet UserRole::getPermissions() const {
     return permissions;
 }
 
@@ -35,10 +34,10 @@ void UserRole::setDescription(const std::string& description) {
     this->description = description;
 }
 
-void UserRole::setPermissions(const std::vector<std::string>& permissions) {
+void UserRole::setPermissions(const PermissionSet& permissions) {
     this->permissions = permissions;
 }
 
-bool UserRole::hasPermission(const std::string& permission) const {
-    return std::find(permissions.begin(), permissions.end(), permission) != permissions.end();
+bool UserRole::hasPermission(Permission permission) const {
+    return permissions.test(static_cast<std::size_t>(permission));
 }
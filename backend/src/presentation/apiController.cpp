@@ -1,14 +1,95 @@
 #include "presentation/apiController.h"
-#include "dataAccess/restaurantData.h"
+#include "utils/dbConnection.h"
+#include "utils/ioExecutor.h"
+#include "utils/maintenanceScheduler.h"
+#include "utils/queryStats.h"
 #include <string>
 #include <iostream>
+#include <algorithm>
+#include <cctype>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
-ApiController::ApiController() {}
+namespace {
 
-void ApiController::setupRoutes(crow::App<>& app) {
+// Upper bound on items in one bulk admin request
+constexpr std::size_t maxBulkItems = 1000;
+
+// data[key] if data is an object holding a string there, else ""
+std::string stringField(const json& data, const char* key) {
+    if (!data.is_object()) {
+        return "";
+    }
+    auto it = data.find(key);
+    return it != data.end() && it->is_string() ? it->get<std::string>() : "";
+}
+
+json restaurantToJson(const Restaurant& restaurant) {
+    json restaurantJson;
+    restaurantJson["id"] = restaurant.getId();
+    restaurantJson["name"] = restaurant.getName();
+    restaurantJson["address"] = restaurant.getAddress();
+    restaurantJson["phoneNumber"] = restaurant.getPhoneNumber();
+    restaurantJson["description"] = restaurant.getDescription();
+    restaurantJson["tableCount"] = restaurant.getTableCount();
+    restaurantJson["cuisineType"] = restaurant.getCuisineType();
+    restaurantJson["rating"] = restaurant.getRating();
+    restaurantJson["isFeatured"] = restaurant.getIsFeatured();
+    restaurantJson["priceRange"] = restaurant.getPriceRange();
+    restaurantJson["imageUrl"] = restaurant.getImageUrl();
+    restaurantJson["openingTime"] = restaurant.getOpeningTime();
+    restaurantJson["closingTime"] = restaurant.getClosingTime();
+    restaurantJson["reservation_fee"] = restaurant.getReservationFee();
+    return restaurantJson;
+}
+
+// A table with its current and upcoming reservations
+json tableWithReservationsToJson(const Table& table) {
+    json tableJson;
+    tableJson["id"] = table.getId();
+    tableJson["restaurantId"] = table.getRestaurantId();
+    tableJson["seatCount"] = table.getSeatCount();
+    tableJson["isAvailable"] = table.getIsAvailable();
+
+    json reservationsJson = json::array();
+    for (const auto& reservation : table.getReservations()) {
+        json reservationJson;
+        reservationJson["id"] = reservation.id;
+        reservationJson["date"] = reservation.date;
+        reservationJson["startTime"] = reservation.startTime;
+        reservationJson["endTime"] = reservation.endTime;
+        reservationJson["status"] = reservation.status;
+        reservationJson["guestCount"] = reservation.guestCount;
+        reservationsJson.push_back(reservationJson);
+    }
+    tableJson["reservations"] = reservationsJson;
+    return tableJson;
+}
+
+json reviewToJson(const Review& review) {
+    json reviewJson;
+    reviewJson["id"] = review.getId();
+    reviewJson["userId"] = review.getUserId();
+    reviewJson["restaurantId"] = review.getRestaurantId();
+    reviewJson["rating"] = review.getRating();
+    reviewJson["comment"] = review.getComment();
+    return reviewJson;
+}
+
+} // namespace
+
+ApiController::ApiController()
+    : userData(Storage::instance().users()),
+      restaurantData(Storage::instance().restaurants()),
+      reservationData(Storage::instance().reservations()),
+      rateLimits(RateLimitConfig::fromEnvironment()),
+      rateLimiter(rateLimits.maxBuckets) {}
+
+void ApiController::setupRoutes(crow::App<AuthMiddleware>& app) {
+    crowApp = &app;
+    app.get_middleware<AuthMiddleware>().setAuthService(authService);
+    
     app.route_dynamic("/api/(.*)")
     .methods("OPTIONS"_method)
     ([](const crow::request& req) {
@@ -35,34 +116,106 @@ void ApiController::setupRoutes(crow::App<>& app) {
     });
 }
 
+const AuthMiddleware::context& ApiController::authContext(const crow::request& req) {
+    return crowApp->get_context<AuthMiddleware>(req);
+}
+
 bool ApiController::isAuthenticated(const crow::request& req) {
-    auto authHeader = req.get_header_value("Authorization");
-    if (authHeader.empty()) {
-        return false;
+    return authContext(req).isAuthenticated();
+}
+
+int ApiController::getUserIdFromRequest(const crow::request& req) {
+    return authContext(req).userId();
+}
+
+std::string ApiController::clientIp(const crow::request& req) {
+    if (rateLimits.trustForwardedFor) {
+        const std::string& forwarded = req.get_header_value("X-Forwarded-For");
+        std::string first = forwarded.substr(0, forwarded.find(','));
+        first.erase(0, first.find_first_not_of(' '));
+        first.erase(first.find_last_not_of(' ') + 1);
+        if (!first.empty()) {
+            return first;
+        }
     }
-    
-    if (authHeader.substr(0, 7) != "Bearer ") {
-        return false;
+    return req.remote_ip_address;
+}
+
+std::optional<crow::response> ApiController::rateLimited(const crow::request& req, const std::string& route,
+                                                         const RouteRateLimits& limits, const std::string& account) {
+    if (!rateLimits.enabled) {
+        return std::nullopt;
     }
-    
-    std::string token = authHeader.substr(7);
-    
-    return authService.validateToken(token);
+    RateLimitDecision decision = rateLimiter.acquire(route + "|ip|" + clientIp(req), limits.perIp);
+    if (decision.allowed && !account.empty()) {
+        std::string key = account;
+        std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return std::tolower(c); });
+        decision = rateLimiter.acquire(route + "|account|" + key, limits.perAccount);
+    }
+    if (decision.allowed) {
+        return std::nullopt;
+    }
+    json response;
+    response["success"] = false;
+    response["message"] = "Too many requests, please try again later";
+    response["retryAfter"] = decision.retryAfter.count();
+    crow::response limited = createResponse(429, response.dump());
+    limited.set_header("Retry-After", std::to_string(decision.retryAfter.count()));
+    return limited;
 }
 
-int ApiController::getUserIdFromRequest(const crow::request& req) {
-    auto authHeader = req.get_header_value("Authorization");
-    if (authHeader.empty()) {
-        return -1;
+void ApiController::respondOn(crow::response& res, std::function<crow::response()> work, IoExecutor& executor) {
+    std::future<crow::response> pending;
+    try {
+        pending = executor.submit(std::move(work));
+    } catch (const IoExecutorRejected&) {
+        json response;
+        response["error"] = "Server busy, please retry";
+        res = createResponse(503, response.dump());
+        res.set_header("Retry-After", "1");
+        res.end();
+        return;
     }
     
-    if (authHeader.substr(0, 7) != "Bearer ") {
-        return -1;
+    try {
+        res = pending.get();
+    } catch (const std::exception& e) {
+        std::cerr << "Error in executor handler: " << e.what() << std::endl;
+        json response;
+        response["error"] = "Internal server error";
+        res = createResponse(500, response.dump());
+    }
+    res.end();
+}
+
+PageRequest ApiController::getPageRequest(const crow::request& req) {
+    const char* all = req.url_params.get("all");
+    if (all && std::string(all) == "true") {
+        return PageRequest::unbounded();
     }
     
-    std::string token = authHeader.substr(7);
-    
-    return authService.getUserIdFromToken(token);
+    PageRequest page;
+    try {
+        if (const char* limit = req.url_params.get("limit")) {
+            page.limit = std::stoi(limit);
+        }
+        if (const char* after = req.url_params.get("after")) {
+            page.after = std::max(0, std::stoi(after));
+        }
+    } catch (const std::exception&) {
+        // Malformed values fall back to the first page with the default size
+        page = PageRequest();
+    }
+    page.limit = std::clamp(page.limit, 1, PageRequest::maxLimit);
+    return page;
+}
+
+crow::response ApiController::withNextCursor(crow::response res, const std::optional<int>& nextCursor) {
+    if (nextCursor) {
+        res.add_header("X-Next-Cursor", std::to_string(*nextCursor));
+        res.add_header("Access-Control-Expose-Headers", "X-Next-Cursor");
+    }
+    return res;
 }
 
 crow::response ApiController::createResponse(int code, const std::string& body) {
@@ -73,51 +226,57 @@ crow::response ApiController::createResponse(int code, const std::string& body)
     return res;
 }
 
-void ApiController::setupAuthRoutes(crow::App<>& app) {
+void ApiController::setupAuthRoutes(crow::App<AuthMiddleware>& app) {
     // Register route
     app.route_dynamic("/api/auth/register")
     .methods("POST"_method)
-    ([this](const crow::request& req) {
-        try {
-            auto data = json::parse(req.body);
-            std::string username = data["username"];
-            std::string email = data["email"];
-            std::string password = data["password"];
-            std::string firstName = data.contains("firstName") ? data["firstName"] : "";
-            std::string lastName = data.contains("lastName") ? data["lastName"] : "";
-            
-            if (!authService.isPasswordStrong(password)) {
-                json response;
-                response["success"] = false;
-                response["message"] = authService.getPasswordRequirements();
-                return createResponse(400, response.dump());
-            }
+    ([this](const crow::request& req, crow::response& res) {
+        json data = json::parse(req.body, nullptr, false);
+        if (auto limited = rateLimited(req, "register", rateLimits.registration, stringField(data, "email"))) {
+            res = std::move(*limited);
+            res.end();
+            return;
+        }
+        
+        // Password hashing runs on its own bounded pool; 503 with Retry-After when it is saturated
+        respondOn(res, [this, data = std::move(data)]() mutable -> crow::response {
+            try {
+                std::string username = data["username"];
+                std::string email = data["email"];
+                std::string password = data["password"];
+                std::string firstName = data.contains("firstName") ? data["firstName"] : "";
+                std::string lastName = data.contains("lastName") ? data["lastName"] : "";
+            
+                if (!authService.isPasswordStrong(password)) {
+                    json response;
+                    response["success"] = false;
+                    response["message"] = authService.getPasswordRequirements();
+                    return createResponse(400, response.dump());
+                }
             
-            bool success = authService.registerUser(username, email, password, firstName, lastName);
-            if (success) {
-                auto userData = UserData();
-                auto user = userData.getUserByEmail(email);
+                auto verificationToken = authService.registerUser(username, email, password, firstName, lastName);
+                if (verificationToken) {
+                    emailService.sendInBackground([email, username, token = *verificationToken](EmailService& mailer) {
+                        return mailer.sendEmailVerification(email, username, token);
+                    }, "verification email to " + email);
                 
-                if (user && !user->getEmailVerificationToken().empty()) {
-                    emailService.sendEmailVerification(email, username, user->getEmailVerificationToken());
+                    json response;
+                    response["success"] = true;
+                    response["message"] = "User registered successfully! Please check your email to verify your account.";
+                    return createResponse(201, response.dump());
+                } else {
+                    json response;
+                    response["success"] = false;
+                    response["message"] = "Username or email already exists, or password doesn't meet requirements";
+                    return createResponse(400, response.dump());
                 }
-                
-                json response;
-                response["success"] = true;
-                response["message"] = "User registered successfully! Please check your email to verify your account.";
-                return createResponse(201, response.dump());
-            } else {
+            } catch (const std::exception& e) {
                 json response;
                 response["success"] = false;
-                response["message"] = "Username or email already exists, or password doesn't meet requirements";
+                response["message"] = "Invalid request data";
                 return createResponse(400, response.dump());
             }
-        } catch (const std::exception& e) {
-            json response;
-            response["success"] = false;
-            response["message"] = "Invalid request data";
-            return createResponse(400, response.dump());
-        }
+        }, IoExecutor::hashing());
     });
     
     app.route_dynamic("/api/auth/verify-email")
@@ -166,58 +325,62 @@ void ApiController::setupAuthRoutes(crow::App<>& app) {
     // Login route
     app.route_dynamic("/api/auth/login")
     .methods("POST"_method)
-    ([this](const crow::request& req) {
-        try {
-            auto data = json::parse(req.body);
-            std::string username = data["username"];
-            std::string password = data["password"];
-            
-            std::string token = authService.loginUser(username, password);
-            if (!token.empty() && token != "EMAIL_NOT_VERIFIED") {
-                // Get user information with role data
-                int userId = authService.getUserIdFromToken(token);
-                auto user = userData.getUserById(userId);
-                
-                if (user) {
+    ([this](const crow::request& req, crow::response& res) {
+        json data = json::parse(req.body, nullptr, false);
+        if (auto limited = rateLimited(req, "login", rateLimits.login, stringField(data, "username"))) {
+            res = std::move(*limited);
+            res.end();
+            return;
+        }
+        
+        // Password hashing runs on its own bounded pool; 503 with Retry-After when it is saturated
+        respondOn(res, [this, data = std::move(data)]() mutable -> crow::response {
+            try {
+                std::string username = data["username"];
+                std::string password = data["password"];
+            
+                LoginResult login = authService.loginUser(username, password);
+                if (login.status == LoginStatus::Success) {
+                    const User& user = *login.user;
                     json response;
                     response["success"] = true;
-                    response["token"] = token;
-                    response["user"]["id"] = user->getId();
-                    response["user"]["username"] = user->getUsername();
-                    response["user"]["email"] = user->getEmail();
-                    response["user"]["firstName"] = user->getFirstName();
-                    response["user"]["lastName"] = user->getLastName();
-                    response["user"]["phoneNumber"] = user->getPhoneNumber();
-                    response["user"]["roleId"] = user->getRoleId();
-                    response["user"]["roleName"] = user->getRoleName();
-                    response["user"]["permissions"] = user->getPermissions();
-                    response["user"]["isActive"] = user->isActive();
+                    response["token"] = login.token;
+                    response["user"]["id"] = user.getId();
+                    response["user"]["username"] = user.getUsername();
+                    response["user"]["email"] = user.getEmail();
+                    response["user"]["firstName"] = user.getFirstName();
+                    response["user"]["lastName"] = user.getLastName();
+                    response["user"]["phoneNumber"] = user.getPhoneNumber();
+                    response["user"]["roleId"] = user.getRoleId();
+                    response["user"]["roleName"] = user.getRoleName();
+                    response["user"]["permissions"] = permissionNameList(user.getPermissions());
+                    response["user"]["isActive"] = user.isActive();
                     response["message"] = "Login successful";
                     return createResponse(200, response.dump());
+                } else if (login.status == LoginStatus::EmailNotVerified) {
+                    json response;
+                    response["success"] = false;
+                    response["message"] = "Please verify your email address before logging in. Check your email for the verification link.";
+                    response["error_type"] = "email_not_verified";
+                    return createResponse(401, response.dump());
+                } else if (login.status == LoginStatus::Failed) {
+                    json response;
+                    response["success"] = false;
+                    response["message"] = "Login failed, please try again";
+                    return createResponse(500, response.dump());
                 } else {
                     json response;
                     response["success"] = false;
-                    response["message"] = "User data not found";
+                    response["message"] = "Invalid credentials";
                     return createResponse(401, response.dump());
                 }
-            } else if (token == "EMAIL_NOT_VERIFIED") {
+            } catch (const std::exception& e) {
                 json response;
                 response["success"] = false;
-                response["message"] = "Please verify your email address before logging in. Check your email for the verification link.";
-                response["error_type"] = "email_not_verified";
-                return createResponse(401, response.dump());
-            } else {
-                json response;
-                response["success"] = false;
-                response["message"] = "Invalid credentials";
-                return createResponse(401, response.dump());
+                response["message"] = "Invalid request data";
+                return createResponse(400, response.dump());
             }
-        } catch (const std::exception& e) {
-            json response;
-            response["success"] = false;
-            response["message"] = "Invalid request data";
-            return createResponse(400, response.dump());
-        }
+        }, IoExecutor::hashing());
     });
     
     // Logout route
@@ -231,10 +394,7 @@ void ApiController::setupAuthRoutes(crow::App<>& app) {
             return createResponse(401, response.dump());
         }
         
-        auto authHeader = req.get_header_value("Authorization");
-        std::string token = authHeader.substr(7); // Remove "Bearer "
-        
-        authService.logoutUser(token);
+        authService.logoutUser(authContext(req).token);
         
         json response;
         response["success"] = true;
@@ -243,34 +403,36 @@ void ApiController::setupAuthRoutes(crow::App<>& app) {
     });
 }
 
-void ApiController::setupRestaurantRoutes(crow::App<>& app) {
+void ApiController::setupRestaurantRoutes(crow::App<AuthMiddleware>& app) {
     // Get all restaurants
     app.route_dynamic("/api/restaurants")
     .methods("GET"_method)
-    ([this](const crow::request& req) {
-        auto restaurants = restaurantService.getAllRestaurants();
+    ([this](const crow::request& req, crow::response& res) {
+        respondOn(res, [this]() -> crow::response {
+            auto restaurants = restaurantService.getAllRestaurants();
         
-        json response = json::array();
-        for (const auto& restaurant : restaurants) {
-            json restaurantJson;
-            restaurantJson["id"] = restaurant.getId();
-            restaurantJson["name"] = restaurant.getName();
-            restaurantJson["address"] = restaurant.getAddress();
-            restaurantJson["phoneNumber"] = restaurant.getPhoneNumber();
-            restaurantJson["description"] = restaurant.getDescription();
-            restaurantJson["tableCount"] = restaurant.getTableCount();
-            restaurantJson["cuisineType"] = restaurant.getCuisineType();
-            restaurantJson["rating"] = restaurant.getRating();
-            restaurantJson["isFeatured"] = restaurant.getIsFeatured();
-            restaurantJson["priceRange"] = restaurant.getPriceRange();
-            restaurantJson["openingTime"] = restaurant.getOpeningTime();
-            restaurantJson["closingTime"] = restaurant.getClosingTime();
-            restaurantJson["imageUrl"] = restaurant.getImageUrl();
-            restaurantJson["reservation_fee"] = restaurant.getReservationFee();
-            response.push_back(restaurantJson);
-        }
+            json response = json::array();
+            for (const auto& restaurant : restaurants) {
+                json restaurantJson;
+                restaurantJson["id"] = restaurant.getId();
+                restaurantJson["name"] = restaurant.getName();
+                restaurantJson["address"] = restaurant.getAddress();
+                restaurantJson["phoneNumber"] = restaurant.getPhoneNumber();
+                restaurantJson["description"] = restaurant.getDescription();
+                restaurantJson["tableCount"] = restaurant.getTableCount();
+                restaurantJson["cuisineType"] = restaurant.getCuisineType();
+                restaurantJson["rating"] = restaurant.getRating();
+                restaurantJson["isFeatured"] = restaurant.getIsFeatured();
+                restaurantJson["priceRange"] = restaurant.getPriceRange();
+                restaurantJson["openingTime"] = restaurant.getOpeningTime();
+                restaurantJson["closingTime"] = restaurant.getClosingTime();
+                restaurantJson["imageUrl"] = restaurant.getImageUrl();
+                restaurantJson["reservation_fee"] = restaurant.getReservationFee();
+                response.push_back(restaurantJson);
+            }
         
-        return createResponse(200, response.dump());
+            return createResponse(200, response.dump());
+        });
     });
     
     // Get restaurant by ID
@@ -279,22 +441,7 @@ void ApiController::setupRestaurantRoutes(crow::App<>& app) {
     ([this](const crow::request& req, int id) {
         auto restaurant = restaurantService.getRestaurantById(id);
         if (restaurant) {
-            json response;
-            response["id"] = restaurant->getId();
-            response["name"] = restaurant->getName();
-            response["address"] = restaurant->getAddress();
-            response["phoneNumber"] = restaurant->getPhoneNumber();
-            response["description"] = restaurant->getDescription();
-            response["tableCount"] = restaurant->getTableCount();
-            response["cuisineType"] = restaurant->getCuisineType();
-            response["rating"] = restaurant->getRating();
-            response["isFeatured"] = restaurant->getIsFeatured();
-            response["priceRange"] = restaurant->getPriceRange();
-            response["imageUrl"] = restaurant->getImageUrl();
-            response["openingTime"] = restaurant->getOpeningTime();
-            response["closingTime"] = restaurant->getClosingTime();
-            response["reservation_fee"] = restaurant->getReservationFee();
-            return createResponse(200, response.dump());
+            return createResponse(200, restaurantToJson(*restaurant).dump());
         } else {
             json response;
             response["message"] = "Restaurant not found";
@@ -302,6 +449,35 @@ void ApiController::setupRestaurantRoutes(crow::App<>& app) {
         }
     });
     
+    // Restaurant page in one call: the restaurant, its tables with current and upcoming
+    // reservations, the first page of reviews (?limit=&after=, X-Next-Cursor) and rating stats
+    app.route_dynamic("/api/restaurants/<int>/details")
+    .methods("GET"_method)
+    ([this](const crow::request& req, crow::response& res, int id) {
+        PageRequest reviewPage = getPageRequest(req);
+        respondOn(res, [this, id, reviewPage]() -> crow::response {
+            auto details = restaurantService.getRestaurantDetails(id, reviewPage);
+            if (!details) {
+                json response;
+                response["message"] = "Restaurant not found";
+                return createResponse(404, response.dump());
+            }
+            
+            json response = restaurantToJson(details->restaurant);
+            response["tables"] = json::array();
+            for (const auto& table : details->tables) {
+                response["tables"].push_back(tableWithReservationsToJson(table));
+            }
+            response["reviews"] = json::array();
+            for (const auto& review : details->reviews.items) {
+                response["reviews"].push_back(reviewToJson(review));
+            }
+            response["reviewStats"]["averageRating"] = details->averageRating;
+            response["reviewStats"]["count"] = details->reviewCount;
+            return withNextCursor(createResponse(200, response.dump()), details->reviews.nextCursor);
+        });
+    });
+    
     // Create restaurant (admin only, but we'll skip the admin check for simplicity)
     app.route_dynamic("/api/restaurants")
     .methods("POST"_method)
@@ -487,39 +663,21 @@ void ApiController::setupRestaurantRoutes(crow::App<>& app) {
     // Get tables with reservations by restaurant ID
     app.route_dynamic("/api/restaurants/<int>/tableswithreservations")
     .methods("GET"_method)
-    ([this](const crow::request& req, int restaurantId) {
-        auto tables = restaurantService.getTablesWithReservationsByRestaurantId(restaurantId);
+    ([this](const crow::request& req, crow::response& res, int restaurantId) {
+        respondOn(res, [this, restaurantId]() -> crow::response {
+            auto tables = restaurantService.getTablesWithReservationsByRestaurantId(restaurantId);
         
-        json response = json::array();
-        for (const auto& table : tables) {
-            json tableJson;
-            tableJson["id"] = table.getId();
-            tableJson["restaurantId"] = table.getRestaurantId();
-            tableJson["seatCount"] = table.getSeatCount();
-            tableJson["isAvailable"] = table.getIsAvailable();
-            
-            // Add reservation information
-            json reservationsJson = json::array();
-            for (const auto& reservation : table.getReservations()) {
-                json reservationJson;
-                reservationJson["id"] = reservation.id;
-                reservationJson["date"] = reservation.date;
-                reservationJson["startTime"] = reservation.startTime;
-                reservationJson["endTime"] = reservation.endTime;
-                reservationJson["status"] = reservation.status;
-                reservationJson["guestCount"] = reservation.guestCount;
-                reservationsJson.push_back(reservationJson);
+            json response = json::array();
+            for (const auto& table : tables) {
+                response.push_back(tableWithReservationsToJson(table));
             }
-            tableJson["reservations"] = reservationsJson;
-            
-            response.push_back(tableJson);
-        }
         
-        return crow::response(200, response.dump());
+            return crow::response(200, response.dump());
+        });
     });
 }
 
-void ApiController::setupReservationRoutes(crow::App<>& app) {
+void ApiController::setupReservationRoutes(crow::App<AuthMiddleware>& app) {
     // Get all reservations (admin only, but we'll skip the admin check for simplicity)
     app.route_dynamic("/api/reservations")
     .methods("GET"_method)
@@ -531,10 +689,10 @@ void ApiController::setupReservationRoutes(crow::App<>& app) {
             return crow::response(401, response.dump());
         }
         
-        auto reservations = reservationService.getAllReservations();
+        auto page = reservationService.getAllReservations(getPageRequest(req));
         
         json response = json::array();
-        for (const auto& reservation : reservations) {
+        for (const auto& reservation : page.items) {
             json reservationJson;
             reservationJson["id"] = reservation.getId();
             reservationJson["userId"] = reservation.getUserId();
@@ -554,52 +712,67 @@ void ApiController::setupReservationRoutes(crow::App<>& app) {
             response.push_back(reservationJson);
         }
         
-        return crow::response(200, response.dump());
+        return withNextCursor(crow::response(200, response.dump()), page.nextCursor);
     });
     
     // Get user reservations
     app.route_dynamic("/api/user/reservations")
     .methods("GET"_method)
-    ([this](const crow::request& req) {
-        if (!isAuthenticated(req)) {
-            json response;
-            response["success"] = false;
-            response["message"] = "Unauthorized";
-            return crow::response(401, response.dump());
-        }
+    ([this](const crow::request& req, crow::response& res) {
+        bool authenticated = isAuthenticated(req);
+        int userId = authenticated ? getUserIdFromRequest(req) : -1;
+        respondOn(res, [this, authenticated, userId]() -> crow::response {
+            if (!authenticated) {
+                json response;
+                response["success"] = false;
+                response["message"] = "Unauthorized";
+                return crow::response(401, response.dump());
+            }
         
-        int userId = getUserIdFromRequest(req);
-        if (userId < 0) {
-            json response;
-            response["success"] = false;
-            response["message"] = "Invalid authentication token";
-            return crow::response(401, response.dump());
-        }
+            if (userId < 0) {
+                json response;
+                response["success"] = false;
+                response["message"] = "Invalid authentication token";
+                return crow::response(401, response.dump());
+            }
         
-        auto reservations = reservationService.getReservationsByUserId(userId);
+            auto reservations = reservationService.getReservationsByUserId(userId);
+            auto restaurants = reservationService.getRestaurantsForReservations(reservations);
         
-        json response = json::array();
-        for (const auto& reservation : reservations) {
-            json reservationJson;
-            reservationJson["id"] = reservation.getId();
-            reservationJson["userId"] = reservation.getUserId();
-            reservationJson["tableId"] = reservation.getTableId();
-            reservationJson["restaurantId"] = reservation.getRestaurantId();
-            reservationJson["date"] = reservation.getDate();
-            reservationJson["startTime"] = reservation.getStartTime();
-            reservationJson["endTime"] = reservation.getEndTime();
-            reservationJson["guestCount"] = reservation.getGuestCount();
-            reservationJson["status"] = reservation.getStatus();
-            reservationJson["specialRequests"] = reservation.getSpecialRequests();
-            reservationJson["phoneNumber"] = reservation.getPhoneNumber();
-            reservationJson["email"] = reservation.getEmail();
-            reservationJson["totalAmount"] = reservation.getTotalAmount();
-            reservationJson["paymentStatus"] = reservation.getPaymentStatus();
-            reservationJson["paymentMethod"] = reservation.getPaymentMethod();
-            response.push_back(reservationJson);
-        }
+            json response = json::array();
+            for (const auto& reservation : reservations) {
+                json reservationJson;
+                reservationJson["id"] = reservation.getId();
+                reservationJson["userId"] = reservation.getUserId();
+                reservationJson["tableId"] = reservation.getTableId();
+                reservationJson["restaurantId"] = reservation.getRestaurantId();
+                reservationJson["date"] = reservation.getDate();
+                reservationJson["startTime"] = reservation.getStartTime();
+                reservationJson["endTime"] = reservation.getEndTime();
+                reservationJson["guestCount"] = reservation.getGuestCount();
+                reservationJson["status"] = reservation.getStatus();
+                reservationJson["specialRequests"] = reservation.getSpecialRequests();
+                reservationJson["phoneNumber"] = reservation.getPhoneNumber();
+                reservationJson["email"] = reservation.getEmail();
+                reservationJson["totalAmount"] = reservation.getTotalAmount();
+                reservationJson["paymentStatus"] = reservation.getPaymentStatus();
+                reservationJson["paymentMethod"] = reservation.getPaymentMethod();
+            
+                auto restaurant = restaurants.find(reservation.getRestaurantId());
+                if (restaurant != restaurants.end()) {
+                    json restaurantJson;
+                    restaurantJson["id"] = restaurant->second.getId();
+                    restaurantJson["name"] = restaurant->second.getName();
+                    restaurantJson["address"] = restaurant->second.getAddress();
+                    restaurantJson["phoneNumber"] = restaurant->second.getPhoneNumber();
+                    restaurantJson["imageUrl"] = restaurant->second.getImageUrl();
+                    reservationJson["restaurant"] = restaurantJson;
+                }
+                response.push_back(reservationJson);
+            }
         
-        return crow::response(200, response.dump());
+            return crow::response(200, response.dump());
+        });
     });
     
     // Get restaurant reservations (admin only, but we'll skip the admin check for simplicity)
@@ -614,6 +787,7 @@ void ApiController::setupReservationRoutes(crow::App<>& app) {
         }
         
         auto reservations = reservationService.getReservationsByRestaurantId(restaurantId);
+        auto users = reservationService.getUsersForReservations(reservations);
         
         json response = json::array();
         for (const auto& reservation : reservations) {
@@ -633,6 +807,12 @@ void ApiController::setupReservationRoutes(crow::App<>& app) {
             reservationJson["totalAmount"] = reservation.getTotalAmount();
             reservationJson["paymentStatus"] = reservation.getPaymentStatus();
             reservationJson["paymentMethod"] = reservation.getPaymentMethod();
+            
+            auto user = users.find(reservation.getUserId());
+            if (user != users.end()) {
+                std::string customerName = user->second.getFirstName() + " " + user->second.getLastName();
+                reservationJson["customerName"] = customerName == " " ? user->second.getUsername() : customerName;
+            }
             response.push_back(reservationJson);
         }
         
@@ -643,18 +823,12 @@ void ApiController::setupReservationRoutes(crow::App<>& app) {
     app.route_dynamic("/api/reservations")
     .methods("POST"_method)
     ([this](const crow::request& req) {
-        if (!isAuthenticated(req)) {
-            json response;
-            response["success"] = false;
-            response["message"] = "Unauthorized";
-            return crow::response(401, response.dump());
-        }
-        
+        // getUserIdFromRequest validates the token, so a separate isAuthenticated lookup is not needed
         int userId = getUserIdFromRequest(req);
         if (userId < 0) {
             json response;
             response["success"] = false;
-            response["message"] = "Invalid authentication token";
+            response["message"] = "Unauthorized";
             return crow::response(401, response.dump());
         }
         
@@ -700,8 +874,8 @@ void ApiController::setupReservationRoutes(crow::App<>& app) {
                 reservation.setEmail(data["email"]);
             }
             
-            bool success = reservationService.createReservation(reservation);
-            if (success) {
+            auto reservationId = reservationService.createReservation(reservation);
+            if (reservationId) {
                 // If payment data is provided and it's a card payment, create payment record
                 if (data.contains("paymentData") && data["paymentMethod"] == "card") {
                     // TODO: Create payment record and process payment
@@ -712,6 +886,7 @@ void ApiController::setupReservationRoutes(crow::App<>& app) {
                 response["success"] = true;
                 response["message"] = "Reservation created successfully. Please check your email for confirmation instructions.";
                 response["status"] = "pending";
+                response["reservationId"] = *reservationId;
                 return crow::response(201, response.dump());
             } else {
                 json response;
@@ -838,6 +1013,11 @@ void ApiController::setupReservationRoutes(crow::App<>& app) {
             return createResponse(401, response.dump());
         }
 
+        // Each resend is an SMTP send
+        if (auto limited = rateLimited(req, "resend", rateLimits.resendConfirmation, std::to_string(userId))) {
+            return std::move(*limited);
+        }
+
         // Verify that the reservation belongs to the authenticated user
         auto reservation = reservationService.getReservationById(reservationId);
         if (!reservation) {
@@ -876,25 +1056,19 @@ void ApiController::setupReservationRoutes(crow::App<>& app) {
     });
 }
 
-void ApiController::setupReviewRoutes(crow::App<>& app) {
+void ApiController::setupReviewRoutes(crow::App<AuthMiddleware>& app) {
     // Get reviews for a restaurant
     app.route_dynamic("/api/restaurants/<int>/reviews")
     .methods("GET"_method)
     ([this](const crow::request& req, int restaurantId) {
-        auto reviews = reviewService.getReviewsByRestaurantId(restaurantId);
+        auto page = reviewService.getReviewsByRestaurantId(restaurantId, getPageRequest(req));
         
         json response = json::array();
-        for (const auto& review : reviews) {
-            json reviewJson;
-            reviewJson["id"] = review.getId();
-            reviewJson["userId"] = review.getUserId();
-            reviewJson["restaurantId"] = review.getRestaurantId();
-            reviewJson["rating"] = review.getRating();
-            reviewJson["comment"] = review.getComment();
-            response.push_back(reviewJson);
+        for (const auto& review : page.items) {
+            response.push_back(reviewToJson(review));
         }
         
-        return createResponse(200, response.dump());
+        return withNextCursor(createResponse(200, response.dump()), page.nextCursor);
     });
     
     // Add a new review for a restaurant
@@ -1099,24 +1273,10 @@ void ApiController::setupReviewRoutes(crow::App<>& app) {
 
 // Helper function to check if user is admin
 bool ApiController::isAdmin(const crow::request& req) {
-    if (!isAuthenticated(req)) {
-        return false;
-    }
-    
-    int userId = getUserIdFromRequest(req);
-    if (userId == -1) {
-        return false;
-    }
-    
-    auto user = userData.getUserById(userId);
-    if (!user) {
-        return false;
-    }
-    
-    return user->isAdmin();
+    return authContext(req).isAdmin();
 }
 
-void ApiController::setupAdminRoutes(crow::App<>& app) {
+void ApiController::setupAdminRoutes(crow::App<AuthMiddleware>& app) {
     // Get all users (admin only)
     app.route_dynamic("/api/admin/users")
     .methods("GET"_method)
@@ -1126,10 +1286,10 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
         }
         
         try {
-            auto users = userData.getAllUsers();
+            auto page = userData.getAllUsers(getPageRequest(req));
             json userArray = json::array();
             
-            for (const auto& user : users) {
+            for (const auto& user : page.items) {
                 json userJson;
                 userJson["id"] = user.getId();
                 userJson["username"] = user.getUsername();
@@ -1141,15 +1301,16 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
                 userJson["phoneNumber"] = user.getPhoneNumber();
                 userJson["isActive"] = user.isActive();
                 userJson["createdAt"] = user.getCreatedAt();
-                userJson["permissions"] = user.getPermissions();
+                userJson["permissions"] = permissionNameList(user.getPermissions());
                 userArray.push_back(userJson);
             }
             
             json response;
             response["success"] = true;
             response["data"] = userArray;
+            response["next"] = page.nextCursor ? json(*page.nextCursor) : json(nullptr);
             
-            return createResponse(200, response.dump());
+            return withNextCursor(createResponse(200, response.dump()), page.nextCursor);
         } catch (const std::exception& e) {
             json error;
             error["success"] = false;
@@ -1158,6 +1319,53 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
         }
     });
     
+    // Export a full dataset as NDJSON or CSV (admin only). The file is spooled row by row and sent
+    // from disk rather than built up as one JSON document.
+    app.route_dynamic("/api/admin/export/<string>")
+    .methods("GET"_method)
+    ([this](const crow::request& req, crow::response& res, std::string dataset) {
+        bool admin = isAdmin(req);
+        int adminUserId = getUserIdFromRequest(req);
+        const char* formatParam = req.url_params.get("format");
+        std::string formatName = formatParam ? formatParam : "ndjson";
+        std::string ipAddress = req.remote_ip_address;
+        respondOn(res, [this, admin, adminUserId, formatName, ipAddress, dataset]() -> crow::response {
+            if (!admin) {
+                return createResponse(403, "{\"error\": \"Access denied\"}");
+            }
+            
+            json error;
+            if (!ExportService::isKnownDataset(dataset)) {
+                error["error"] = "Unknown export. Use reservations, users, reviews or audit-log";
+                return createResponse(404, error.dump());
+            }
+            auto format = parseExportFormat(formatName);
+            if (!format) {
+                error["error"] = "Unsupported format. Use ndjson or csv";
+                return createResponse(400, error.dump());
+            }
+            
+            auto file = exportService.exportDataset(dataset, *format);
+            if (!file) {
+                error["error"] = "Export failed";
+                return createResponse(500, error.dump());
+            }
+            
+            json details;
+            details["dataset"] = dataset;
+            details["format"] = exportFormatExtension(*format);
+            details["rows"] = file->rows;
+            userData.logAdminAction(adminUserId, "EXPORT_DATA", dataset, 0, details.dump(), ipAddress);
+            
+            crow::response response = createResponse(200, "");
+            // The path is generated server-side, so Crow's filename sanitising is not needed
+            response.set_static_file_info_unsafe(file->path);
+            response.set_header("Content-Type", file->contentType);
+            response.set_header("Content-Disposition", "attachment; filename=\"" + file->fileName + "\"");
+            return response;
+        });
+    });
+    
     // Get all roles (admin only)
     app.route_dynamic("/api/admin/roles")
     .methods("GET"_method)
@@ -1175,7 +1383,7 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
                 roleJson["id"] = role.getId();
                 roleJson["name"] = role.getName();
                 roleJson["description"] = role.getDescription();
-                roleJson["permissions"] = role.getPermissions();
+                roleJson["permissions"] = permissionNameList(role.getPermissions());
                 response.push_back(roleJson);
             }
             
@@ -1203,6 +1411,7 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
             bool success = userData.updateUserRole(userId, roleId);
             
             if (success) {
+                authService.invalidateUser(userId);
                 // Log admin action
                 userData.logAdminAction(adminUserId, "UPDATE_USER_ROLE", "user", userId, 
                                       "Changed role to " + std::to_string(roleId));
@@ -1239,6 +1448,7 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
             bool success = userData.updateUserStatus(userId, isActive);
             
             if (success) {
+                authService.invalidateUser(userId);
                 // Log admin action
                 std::string action = isActive ? "ACTIVATE_USER" : "DEACTIVATE_USER";
                 userData.logAdminAction(adminUserId, action, "user", userId, 
@@ -1260,6 +1470,49 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
         }
     });
     
+    // Activate or deactivate many users at once (admin only)
+    app.route_dynamic("/api/admin/users/status")
+    .methods("PUT"_method)
+    ([this](const crow::request& req) {
+        if (!isAdmin(req)) {
+            return createResponse(403, "{\"error\": \"Access denied\"}");
+        }
+        
+        try {
+            auto data = json::parse(req.body);
+            std::vector<int> userIds = data.at("userIds").get<std::vector<int>>();
+            bool isActive = data.at("isActive").get<bool>();
+            if (userIds.empty() || userIds.size() > maxBulkItems) {
+                json error;
+                error["error"] = "userIds must contain 1 to " + std::to_string(maxBulkItems) + " ids";
+                return createResponse(400, error.dump());
+            }
+            
+            int updated = userData.updateUserStatuses(userIds, isActive);
+            if (updated < 0) {
+                json error;
+                error["error"] = "Failed to update user status";
+                return createResponse(500, error.dump());
+            }
+            for (int userId : userIds) {
+                authService.invalidateUser(userId);
+            }
+            
+            std::string action = isActive ? "ACTIVATE_USER" : "DEACTIVATE_USER";
+            userData.logAdminActions(getUserIdFromRequest(req), action, "user", userIds,
+                                     isActive ? "Activated user (bulk)" : "Deactivated user (bulk)");
+            
+            json response;
+            response["success"] = true;
+            response["updated"] = updated;
+            return createResponse(200, response.dump());
+        } catch (const std::exception& e) {
+            json error;
+            error["error"] = "Invalid request data";
+            return createResponse(400, error.dump());
+        }
+    });
+    
     // Delete user (admin only)
     app.route_dynamic("/api/admin/users/<int>")
     .methods("DELETE"_method)
@@ -1282,6 +1535,7 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
             bool success = userData.deleteUser(userId);
             
             if (success) {
+                authService.invalidateUser(userId);
                 int adminUserId = getUserIdFromRequest(req);
                 userData.logAdminAction(adminUserId, "DELETE_USER", "user", userId, 
                                       "Deleted user: " + user->getUsername());
@@ -1305,43 +1559,47 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
     // Get all reservations for admin (admin only)
     app.route_dynamic("/api/admin/reservations")
     .methods("GET"_method)
-    ([this](const crow::request& req) {
-        if (!isAdmin(req)) {
-            return createResponse(403, "{\"error\": \"Access denied\"}");
-        }
+    ([this](const crow::request& req, crow::response& res) {
+        bool admin = isAdmin(req);
+        PageRequest pageRequest = getPageRequest(req);
+        respondOn(res, [this, admin, pageRequest]() -> crow::response {
+            if (!admin) {
+                return createResponse(403, "{\"error\": \"Access denied\"}");
+            }
         
-        try {
-            auto reservations = reservationData.getAllReservations();
-            json response = json::array();
+            try {
+                auto page = reservationData.getAllReservations(pageRequest);
+                json response = json::array();
+            
+                for (const auto& reservation : page.items) {
+                    json reservationJson;
+                    reservationJson["id"] = reservation.getId();
+                    reservationJson["userId"] = reservation.getUserId();
+                    reservationJson["tableId"] = reservation.getTableId();
+                    reservationJson["restaurantId"] = reservation.getRestaurantId();
+                    reservationJson["date"] = reservation.getDate();
+                    reservationJson["startTime"] = reservation.getStartTime();
+                    reservationJson["endTime"] = reservation.getEndTime();
+                    reservationJson["guestCount"] = reservation.getGuestCount();
+                    reservationJson["status"] = reservation.getStatus();
+                    reservationJson["phoneNumber"] = reservation.getPhoneNumber();
+                    reservationJson["email"] = reservation.getEmail();
+                    reservationJson["specialRequests"] = reservation.getSpecialRequests();
+                    reservationJson["totalAmount"] = reservation.getTotalAmount();
+                    reservationJson["paymentStatus"] = reservation.getPaymentStatus();
+                    reservationJson["paymentMethod"] = reservation.getPaymentMethod();
+                    reservationJson["restaurantName"] = reservation.getRestaurantName();
+                    reservationJson["customerName"] = reservation.getCustomerName();
+                    response.push_back(reservationJson);
+                }
             
-            for (const auto& reservation : reservations) {
-                json reservationJson;
-                reservationJson["id"] = reservation.getId();
-                reservationJson["userId"] = reservation.getUserId();
-                reservationJson["tableId"] = reservation.getTableId();
-                reservationJson["restaurantId"] = reservation.getRestaurantId();
-                reservationJson["date"] = reservation.getDate();
-                reservationJson["startTime"] = reservation.getStartTime();
-                reservationJson["endTime"] = reservation.getEndTime();
-                reservationJson["guestCount"] = reservation.getGuestCount();
-                reservationJson["status"] = reservation.getStatus();
-                reservationJson["phoneNumber"] = reservation.getPhoneNumber();
-                reservationJson["email"] = reservation.getEmail();
-                reservationJson["specialRequests"] = reservation.getSpecialRequests();
-                reservationJson["totalAmount"] = reservation.getTotalAmount();
-                reservationJson["paymentStatus"] = reservation.getPaymentStatus();
-                reservationJson["paymentMethod"] = reservation.getPaymentMethod();
-                reservationJson["restaurantName"] = reservation.getRestaurantName();
-                reservationJson["customerName"] = reservation.getCustomerName();
-                response.push_back(reservationJson);
+                return withNextCursor(createResponse(200, response.dump()), page.nextCursor);
+            } catch (const std::exception& e) {
+                json error;
+                error["error"] = "Failed to fetch reservations";
+                return createResponse(500, error.dump());
             }
-            
-            return createResponse(200, response.dump());
-        } catch (const std::exception& e) {
-            json error;
-            error["error"] = "Failed to fetch reservations";
-            return createResponse(500, error.dump());
-        }
+        });
     });
 
     // Get single reservation for admin (admin only)
@@ -1387,6 +1645,48 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
         }
     });
 
+    // Set the status of many reservations at once (admin only)
+    app.route_dynamic("/api/admin/reservations/status")
+    .methods("PUT"_method)
+    ([this](const crow::request& req) {
+        if (!isAdmin(req)) {
+            return createResponse(403, "{\"error\": \"Access denied\"}");
+        }
+        
+        try {
+            auto data = json::parse(req.body);
+            std::vector<int> ids = data.at("ids").get<std::vector<int>>();
+            std::string status = data.at("status").get<std::string>();
+            json error;
+            if (ids.empty() || ids.size() > maxBulkItems) {
+                error["error"] = "ids must contain 1 to " + std::to_string(maxBulkItems) + " ids";
+                return createResponse(400, error.dump());
+            }
+            if (!ReservationService::isValidStatus(status)) {
+                error["error"] = "Invalid status";
+                return createResponse(400, error.dump());
+            }
+            
+            int updated = reservationService.updateReservationStatuses(ids, status);
+            if (updated < 0) {
+                error["error"] = "Failed to update reservations";
+                return createResponse(500, error.dump());
+            }
+            
+            userData.logAdminActions(getUserIdFromRequest(req), "UPDATE_RESERVATION", "reservation", ids,
+                                     "Set status to " + status + " (bulk)");
+            
+            json response;
+            response["success"] = true;
+            response["updated"] = updated;
+            return createResponse(200, response.dump());
+        } catch (const std::exception& e) {
+            json error;
+            error["error"] = "Invalid request data";
+            return createResponse(400, error.dump());
+        }
+    });
+
     // Update reservation (admin only)
     app.route_dynamic("/api/admin/reservations/<int>")
     .methods("PUT"_method)
@@ -1481,11 +1781,10 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
         }
         
         try {
-            RestaurantData restaurantData;
-            auto restaurants = restaurantData.getAllRestaurants();
+            auto page = restaurantData.getAllRestaurants(getPageRequest(req));
             
             json restaurantsArray = json::array();
-            for (const auto& restaurant : restaurants) {
+            for (const auto& restaurant : page.items) {
                 json restaurantJson;
                 restaurantJson["id"] = restaurant.getId();
                 restaurantJson["name"] = restaurant.getName();
@@ -1506,7 +1805,7 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
                 restaurantsArray.push_back(restaurantJson);
             }
             
-            return createResponse(200, restaurantsArray.dump());
+            return withNextCursor(createResponse(200, restaurantsArray.dump()), page.nextCursor);
             
         } catch (const std::exception& e) {
             json error;
@@ -1536,8 +1835,6 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
                 return createResponse(400, error.dump());
             }
             
-            RestaurantData restaurantData;
-            
             // Create new restaurant object
             Restaurant restaurant;
             restaurant.setName(data["name"]);
@@ -1560,28 +1857,19 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
             if (restaurantId > 0) {
                 // Handle initial tables if provided
                 if (data.contains("initialTables") && data["initialTables"].is_array()) {
-                    TableData tableData;
-                    int tableCount = 0;
-                    
+                    std::vector<Table> tables;
                     for (const auto& tableJson : data["initialTables"]) {
                         if (tableJson.contains("capacity")) {
                             Table table;
                             table.setRestaurantId(restaurantId);
                             table.setSeatCount(tableJson["capacity"]);
                             table.setIsAvailable(tableJson.value("isAvailable", true));
-                            
-                            if (tableData.addTable(table) > 0) {
-                                tableCount++;
-                            }
+                            tables.push_back(table);
                         }
                     }
                     
-                    // Update restaurant with actual table count
-                    if (tableCount > 0) {
-                        restaurant.setId(restaurantId);
-                        restaurant.setTableCount(tableCount);
-                        restaurantData.updateRestaurant(restaurant);
-                    }
+                    // One batch insert; also sets the restaurant's table_count
+                    restaurantService.addTables(restaurantId, tables);
                 }
                 
                 int adminUserId = getUserIdFromRequest(req);
@@ -1621,7 +1909,6 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
         }
         
         try {
-            RestaurantData restaurantData;
             auto restaurant = restaurantData.getRestaurantById(restaurantId);
             
             if (!restaurant) {
@@ -1677,7 +1964,6 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
                 return createResponse(400, error.dump());
             }
             
-            RestaurantData restaurantData;
             auto existingRestaurant = restaurantData.getRestaurantById(restaurantId);
             
             if (!existingRestaurant) {
@@ -1708,7 +1994,7 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
             
             // Handle table updates if provided
             if (success && data.contains("tableOperations")) {
-                TableData tableData;
+                TableStore& tableData = Storage::instance().tables();
                 const auto& operations = data["tableOperations"];
                 
                 // Handle existing table updates
@@ -1727,15 +2013,17 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
                 
                 // Handle new tables
                 if (operations.contains("new") && operations["new"].is_array()) {
+                    std::vector<Table> newTables;
                     for (const auto& tableJson : operations["new"]) {
                         if (tableJson.contains("capacity")) {
                             Table table;
                             table.setRestaurantId(restaurantId);
                             table.setSeatCount(tableJson["capacity"]);
                             table.setIsAvailable(true);
-                            tableData.addTable(table);
+                            newTables.push_back(table);
                         }
                     }
+                    tableData.addTables(restaurantId, newTables);
                 }
                 
                 // Handle table deletions
@@ -1790,7 +2078,6 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
         }
         
         try {
-            RestaurantData restaurantData;
             auto restaurant = restaurantData.getRestaurantById(restaurantId);
             
             if (!restaurant) {
@@ -1821,4 +2108,287 @@ void ApiController::setupAdminRoutes(crow::App<>& app) {
             return createResponse(500, error.dump());
         }
     });
+    
+    // POST /api/admin/restaurants/:id/tables/bulk - Add many tables in one batch (admin only)
+    app.route_dynamic("/api/admin/restaurants/<int>/tables/bulk")
+    .methods("POST"_method)
+    ([this](const crow::request& req, int restaurantId) {
+        if (!isAdmin(req)) {
+            return createResponse(403, "{\"error\": \"Access denied\"}");
+        }
+        
+        try {
+            auto data = json::parse(req.body);
+            const json& tablesJson = data.at("tables");
+            json error;
+            if (!tablesJson.is_array() || tablesJson.empty() || tablesJson.size() > maxBulkItems) {
+                error["error"] = "tables must contain 1 to " + std::to_string(maxBulkItems) + " entries";
+                return createResponse(400, error.dump());
+            }
+            if (!restaurantService.getRestaurantById(restaurantId)) {
+                error["error"] = "Restaurant not found";
+                return createResponse(404, error.dump());
+            }
+            
+            std::vector<Table> tables;
+            tables.reserve(tablesJson.size());
+            for (const auto& tableJson : tablesJson) {
+                Table table;
+                table.setRestaurantId(restaurantId);
+                table.setSeatCount(tableJson.at("capacity").get<int>());
+                table.setIsAvailable(tableJson.value("isAvailable", true));
+                tables.push_back(table);
+            }
+            
+            int created = restaurantService.addTables(restaurantId, tables);
+            if (created == 0) {
+                error["error"] = "Failed to add tables";
+                return createResponse(500, error.dump());
+            }
+            
+            userData.logAdminAction(getUserIdFromRequest(req), "ADD_TABLES", "restaurant", restaurantId,
+                                    "Added " + std::to_string(created) + " tables");
+            
+            json response;
+            response["success"] = true;
+            response["created"] = created;
+            return createResponse(201, response.dump());
+        } catch (const std::exception& e) {
+            json error;
+            error["error"] = "Invalid request data";
+            return createResponse(400, error.dump());
+        }
+    });
+    
+    // GET /api/admin/metrics - Runtime metrics (admin only)
+    app.route_dynamic("/api/admin/metrics")
+    .methods("GET"_method)
+    ([this](const crow::request& req) {
+        if (!isAdmin(req)) {
+            json error;
+            error["error"] = "Admin access required";
+            return createResponse(403, error.dump());
+        }
+        
+        json executors = json::object();
+        for (IoExecutor* executor : {&IoExecutor::database(), &IoExecutor::mail(), &IoExecutor::hashing()}) {
+            IoExecutorStats stats = executor->getStats();
+            json executorJson;
+            executorJson["threads"] = stats.threads;
+            executorJson["active"] = stats.active;
+            executorJson["queueDepth"] = stats.queueDepth;
+            executorJson["maxQueueDepth"] = stats.maxQueueDepth;
+            executorJson["queueCapacity"] = stats.queueCapacity;
+            executorJson["submitted"] = stats.submitted;
+            executorJson["completed"] = stats.completed;
+            executorJson["failed"] = stats.failed;
+            executorJson["rejected"] = stats.rejected;
+            executorJson["avgQueueWaitMs"] = stats.completed > 0 ? stats.totalQueueWaitMs / stats.completed : 0.0;
+            executorJson["maxQueueWaitMs"] = stats.maxQueueWaitMs;
+            executors[stats.name] = executorJson;
+        }
+        
+        json response;
+        StorageBackend backend = Storage::instance().backend();
+        response["storage"]["backend"] = Storage::backendName(backend);
+        // The memory backend never opens the connection pool
+        if (Storage::usesDatabase(backend)) {
+            auto poolToJson = [](const ConnectionPoolStats& stats) {
+                json pool;
+                pool["total"] = stats.totalConnections;
+                pool["idle"] = stats.idleConnections;
+                pool["inUse"] = stats.inUse;
+                pool["waiters"] = stats.waiters;
+                pool["borrows"] = stats.borrows;
+                pool["timeouts"] = stats.timeouts;
+                pool["created"] = stats.created;
+                pool["evicted"] = stats.evicted;
+                pool["validationFailures"] = stats.validationFailures;
+                pool["avgWaitMs"] = stats.borrows > 0 ? stats.totalWaitMs / stats.borrows : 0.0;
+                pool["maxWaitMs"] = stats.maxWaitMs;
+                return pool;
+            };
+            ConnectionPoolStats poolStats = DbConnection::getPoolStats();
+            
+            ReplicaStats replicaStats = DbConnection::getReplicaStats();
+            json replica;
+            replica["configured"] = replicaStats.configured;
+            if (replicaStats.configured) {
+                replica["healthy"] = replicaStats.healthy;
+                replica["lagSeconds"] = replicaStats.lagSeconds ? json(*replicaStats.lagSeconds) : json(nullptr);
+                replica["reads"] = replicaStats.replicaReads;
+                replica["primaryFallbacks"] = replicaStats.primaryFallbacks;
+                replica["checks"] = replicaStats.checks;
+                replica["checkFailures"] = replicaStats.checkFailures;
+                replica["pool"] = poolToJson(replicaStats.pool);
+            }
+            
+            json statementCache;
+            uint64_t lookups = poolStats.statementCacheHits + poolStats.statementCacheMisses;
+            statementCache["hits"] = poolStats.statementCacheHits;
+            statementCache["misses"] = poolStats.statementCacheMisses;
+            statementCache["evictions"] = poolStats.statementCacheEvictions;
+            statementCache["hitRate"] = lookups > 0 ? static_cast<double>(poolStats.statementCacheHits) / lookups : 0.0;
+            
+            response["database"]["pool"] = poolToJson(poolStats);
+            response["database"]["replica"] = replica;
+            response["database"]["statementCache"] = statementCache;
+        }
+        
+        TokenCacheStats sessionStats = authService.getSessionCacheStats();
+        uint64_t sessionLookups = sessionStats.hits + sessionStats.misses;
+        json authCache;
+        authCache["entries"] = sessionStats.entries;
+        authCache["hits"] = sessionStats.hits;
+        authCache["misses"] = sessionStats.misses;
+        authCache["hitRate"] = sessionLookups > 0 ? static_cast<double>(sessionStats.hits) / sessionLookups : 0.0;
+        // Each miss resolves the session with a token lookup and a user lookup
+        authCache["storeLookupsAvoided"] = sessionStats.hits * 2;
+        authCache["expirations"] = sessionStats.expirations;
+        authCache["invalidations"] = sessionStats.invalidations;
+        authCache["evictions"] = sessionStats.evictions;
+        response["authCache"] = authCache;
+        
+        SignedTokenStats signedStats = authService.getSignedTokenStats();
+        response["authTokens"]["format"] = signedStats.enabled ? "signed" : "opaque";
+        if (signedStats.enabled) {
+            response["authTokens"]["activeKeyId"] = signedStats.activeKeyId;
+            response["authTokens"]["revocations"] = signedStats.revocations;
+        }
+        response["executors"] = executors;
+        
+        json maintenance = json::object();
+        for (const auto& job : MaintenanceScheduler::instance().getJobStats()) {
+            json jobJson;
+            jobJson["intervalSeconds"] = job.interval.count();
+            jobJson["runs"] = job.runs;
+            jobJson["failures"] = job.failures;
+            jobJson["truncatedRuns"] = job.truncatedRuns;
+            jobJson["batches"] = job.batches;
+            jobJson["rowsAffected"] = job.rowsAffected;
+            jobJson["lastRows"] = job.lastRows;
+            jobJson["lastDurationMs"] = job.lastDurationMs;
+            jobJson["maxDurationMs"] = job.maxDurationMs;
+            jobJson["lastRunAt"] = job.lastRunAt;
+            maintenance[job.name] = jobJson;
+        }
+        RateLimiterStats limiterStats = rateLimiter.getStats();
+        response["rateLimit"]["enabled"] = rateLimits.enabled;
+        response["rateLimit"]["buckets"] = limiterStats.buckets;
+        response["rateLimit"]["allowed"] = limiterStats.allowed;
+        response["rateLimit"]["limited"] = limiterStats.limited;
+        response["rateLimit"]["evictions"] = limiterStats.evictions;
+        response["rateLimit"]["untracked"] = limiterStats.untracked;
+        
+        response["maintenance"]["running"] = MaintenanceScheduler::instance().isRunning();
+        response["maintenance"]["jobs"] = maintenance;
+        return createResponse(200, response.dump());
+    });
+    
+    // GET /api/admin/metrics/queries - Per-statement latency, row counts and the slow-query log (admin only).
+    // ?sort=total|max|calls|p95 (default total) and ?limit= (default 50) select the hottest statements.
+    app.route_dynamic("/api/admin/metrics/queries")
+    .methods("GET"_method)
+    ([this](const crow::request& req) {
+        if (!isAdmin(req)) {
+            json error;
+            error["error"] = "Admin access required";
+            return createResponse(403, error.dump());
+        }
+        
+        QueryStats& queryStats = QueryStats::instance();
+        std::vector<StatementStats> statements = queryStats.getStatementStats();
+        
+        std::string sort = req.url_params.get("sort") ? req.url_params.get("sort") : "total";
+        auto sortKey = [&sort](const StatementStats& stats) {
+            if (sort == "max") return stats.maxMs;
+            if (sort == "calls") return static_cast<double>(stats.calls);
+            if (sort == "p95") return stats.approximatePercentileMs(0.95);
+            return stats.totalMs;
+        };
+        std::sort(statements.begin(), statements.end(), [&sortKey](const StatementStats& a, const StatementStats& b) {
+            return sortKey(a) > sortKey(b);
+        });
+        std::size_t limit = 50;
+        try {
+            if (const char* limitParam = req.url_params.get("limit")) {
+                limit = static_cast<std::size_t>(std::max(1, std::stoi(limitParam)));
+            }
+        } catch (const std::exception&) {
+            // Keep the default
+        }
+        if (statements.size() > limit) {
+            statements.resize(limit);
+        }
+        
+        json statementsJson = json::array();
+        for (const auto& stats : statements) {
+            json entry;
+            entry["caller"] = stats.caller;
+            entry["sql"] = stats.fingerprint;
+            entry["calls"] = stats.calls;
+            entry["errors"] = stats.errors;
+            entry["rows"] = stats.rows;
+            entry["totalMs"] = stats.totalMs;
+            entry["avgMs"] = stats.calls > 0 ? stats.totalMs / stats.calls : 0.0;
+            entry["p50Ms"] = stats.approximatePercentileMs(0.50);
+            entry["p95Ms"] = stats.approximatePercentileMs(0.95);
+            entry["p99Ms"] = stats.approximatePercentileMs(0.99);
+            entry["maxMs"] = stats.maxMs;
+            entry["histogram"] = stats.histogram;
+            statementsJson.push_back(entry);
+        }
+        
+        std::vector<ConnectionAcquireStats> acquisitions = queryStats.getAcquireStats();
+        std::sort(acquisitions.begin(), acquisitions.end(), [](const ConnectionAcquireStats& a, const ConnectionAcquireStats& b) {
+            return a.totalMs > b.totalMs;
+        });
+        json acquireJson = json::array();
+        for (const auto& stats : acquisitions) {
+            json entry;
+            entry["caller"] = stats.caller;
+            entry["borrows"] = stats.borrows;
+            entry["totalMs"] = stats.totalMs;
+            entry["avgMs"] = stats.borrows > 0 ? stats.totalMs / stats.borrows : 0.0;
+            entry["maxMs"] = stats.maxMs;
+            acquireJson.push_back(entry);
+        }
+        
+        json slowJson = json::array();
+        for (const auto& slow : queryStats.getSlowQueries()) {
+            json entry;
+            entry["caller"] = slow.caller;
+            entry["sql"] = slow.fingerprint;
+            entry["parameters"] = slow.parameterShape;
+            entry["durationMs"] = slow.durationMs;
+            entry["rows"] = slow.rows;
+            entry["failed"] = slow.failed;
+            entry["at"] = slow.recordedAt;
+            slowJson.push_back(entry);
+        }
+        
+        json response;
+        response["histogramBucketsMs"] = queryLatencyBucketsMs;
+        response["slowQueryThresholdMs"] = queryStats.getSlowThreshold().count();
+        response["statements"] = statementsJson;
+        response["connectionAcquire"] = acquireJson;
+        response["slowQueries"] = slowJson;
+        return createResponse(200, response.dump());
+    });
+    
+    // DELETE /api/admin/metrics/queries - Clear query statistics and the slow-query log (admin only)
+    app.route_dynamic("/api/admin/metrics/queries")
+    .methods("DELETE"_method)
+    ([this](const crow::request& req) {
+        if (!isAdmin(req)) {
+            json error;
+            error["error"] = "Admin access required";
+            return createResponse(403, error.dump());
+        }
+        
+        QueryStats::instance().reset();
+        json response;
+        response["success"] = true;
+        return createResponse(200, response.dump());
+    });
 }
@@ -0,0 +1,18 @@
+#include "presentation/authMiddleware.h"
+
+void AuthMiddleware::setAuthService(AuthService& service) {
+    authService = &service;
+}
+
+void AuthMiddleware::before_handle(crow::request& req, crow::response& res, context& ctx) {
+    const std::string& authHeader = req.get_header_value("Authorization");
+    if (authHeader.size() <= 7 || authHeader.compare(0, 7, "Bearer ") != 0) {
+        return;
+    }
+    ctx.token = authHeader.substr(7);
+    if (authService) {
+        ctx.session = authService->authenticate(ctx.token);
+    }
+}
+
+void AuthMiddleware::after_handle(crow::request& req, crow::response& res, context& ctx) {}
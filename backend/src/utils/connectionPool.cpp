@@ -0,0 +1,384 @@
+#include "utils/connectionPool.h"
+#include "utils/envLoader.h"
+#include "utils/queryStats.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+std::chrono::milliseconds envMillis(const std::string& key, std::chrono::milliseconds defaultValue) {
+    return std::chrono::milliseconds(EnvLoader::getEnvSize(key, static_cast<std::size_t>(defaultValue.count())));
+}
+
+// DB_REPLICA_<suffix>, falling back to DB_<suffix> and then defaultValue
+std::string replicaEnv(const std::string& suffix, const std::string& defaultValue) {
+    std::string value = EnvLoader::getEnv("DB_REPLICA_" + suffix);
+    return value.empty() ? EnvLoader::getEnv("DB_" + suffix, defaultValue) : value;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+ConnectionPoolConfig ConnectionPoolConfig::fromEnvironment() {
+    ConnectionPoolConfig config;
+
+    config.connectionString = EnvLoader::getEnv("DB_CONNECTION_STRING");
+    if (config.connectionString.empty()) {
+        config.connectionString =
+            "Driver={" + EnvLoader::getEnv("DB_DRIVER", "MariaDB") + "};"
+            "Server=" + EnvLoader::getEnv("DB_HOST", "localhost") + ";"
+            "Port=" + EnvLoader::getEnv("DB_PORT", "3306") + ";"
+            "Database=" + EnvLoader::getEnv("DB_NAME", "bookbite") + ";"
+            "User=" + EnvLoader::getEnv("DB_USER", "root") + ";"
+            "Password=" + EnvLoader::getEnv("DB_PASSWORD", "") + ";"
+            "MULTI_STATEMENTS=1;";
+    }
+
+    config.minSize = EnvLoader::getEnvSize("DB_POOL_MIN_SIZE", config.minSize);
+    config.maxSize = std::max<std::size_t>(1, EnvLoader::getEnvSize("DB_POOL_MAX_SIZE", config.maxSize));
+    config.minSize = std::min(config.minSize, config.maxSize);
+    config.borrowTimeout = envMillis("DB_POOL_BORROW_TIMEOUT_MS", config.borrowTimeout);
+    config.idleTimeout = envMillis("DB_POOL_IDLE_TIMEOUT_MS", config.idleTimeout);
+    config.validationInterval = envMillis("DB_POOL_VALIDATION_INTERVAL_MS", config.validationInterval);
+    config.statementCacheSize = EnvLoader::getEnvSize("DB_STATEMENT_CACHE_SIZE", config.statementCacheSize);
+    config.fetchRowsetSize = std::max<std::size_t>(1, EnvLoader::getEnvSize("DB_FETCH_ROWSET_SIZE", config.fetchRowsetSize));
+    config.fetchLongColumnBytes = EnvLoader::getEnvSize("DB_FETCH_LONG_COLUMN_BYTES", config.fetchLongColumnBytes);
+    return config;
+}
+
+std::optional<ConnectionPoolConfig> ConnectionPoolConfig::replicaFromEnvironment() {
+    std::string connectionString = EnvLoader::getEnv("DB_REPLICA_CONNECTION_STRING");
+    std::string host = EnvLoader::getEnv("DB_REPLICA_HOST");
+    if (connectionString.empty() && host.empty()) {
+        return std::nullopt;
+    }
+
+    ConnectionPoolConfig primary = fromEnvironment();
+    ConnectionPoolConfig config;
+    config.name = "replica";
+    config.connectionString = connectionString;
+    if (config.connectionString.empty()) {
+        config.connectionString =
+            "Driver={" + replicaEnv("DRIVER", "MariaDB") + "};"
+            "Server=" + host + ";"
+            "Port=" + replicaEnv("PORT", "3306") + ";"
+            "Database=" + replicaEnv("NAME", "bookbite") + ";"
+            "User=" + replicaEnv("USER", "root") + ";"
+            "Password=" + replicaEnv("PASSWORD", "") + ";"
+            "MULTI_STATEMENTS=1;";
+    }
+
+    config.minSize = EnvLoader::getEnvSize("DB_REPLICA_POOL_MIN_SIZE", primary.minSize);
+    config.maxSize = std::max<std::size_t>(1, EnvLoader::getEnvSize("DB_REPLICA_POOL_MAX_SIZE", primary.maxSize));
+    config.minSize = std::min(config.minSize, config.maxSize);
+    config.borrowTimeout = envMillis("DB_REPLICA_POOL_BORROW_TIMEOUT_MS", primary.borrowTimeout);
+    config.idleTimeout = primary.idleTimeout;
+    config.validationInterval = primary.validationInterval;
+    config.statementCacheSize = primary.statementCacheSize;
+    config.fetchRowsetSize = primary.fetchRowsetSize;
+    config.fetchLongColumnBytes = primary.fetchLongColumnBytes;
+    return config;
+}
+
+ConnectionPoolError::ConnectionPoolError(const std::string& message) : std::runtime_error(message) {}
+
+PooledConnection::PooledConnection(ConnectionPool* pool, std::unique_ptr<PooledConnectionSlot> slot)
+    : pool(pool), slot(std::move(slot)), broken(false) {}
+
+PooledConnection::PooledConnection(PooledConnection&& other) noexcept
+    : pool(other.pool), slot(std::move(other.slot)), broken(other.broken), caller(std::move(other.caller)) {
+    other.pool = nullptr;
+}
+
+PooledConnection& PooledConnection::operator=(PooledConnection&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool = other.pool;
+        slot = std::move(other.slot);
+        broken = other.broken;
+        caller = std::move(other.caller);
+        other.pool = nullptr;
+    }
+    return *this;
+}
+
+PooledConnection::~PooledConnection() {
+    release();
+}
+
+nanodbc::connection& PooledConnection::get() {
+    return slot->connection;
+}
+
+PooledConnection::operator nanodbc::connection&() {
+    return slot->connection;
+}
+
+nanodbc::statement& PooledConnection::prepare(const std::string& sql) {
+    return slot->statements.prepare(slot->connection, sql);
+}
+
+nanodbc::result PooledConnection::execute(nanodbc::statement& stmt, long batchOperations) {
+    const std::string* fingerprint = slot->statements.fingerprintOf(stmt);
+    std::string shape = std::to_string(stmt.parameters()) + " params";
+    if (batchOperations > 1) {
+        shape += " x " + std::to_string(batchOperations) + " rows";
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    try {
+        nanodbc::result result = nanodbc::execute(stmt, batchOperations);
+        // MariaDB buffers result sets client-side, so SQLRowCount is the row count for SELECTs too
+        QueryStats::instance().recordStatement(caller, fingerprint ? *fingerprint : "(unprepared)", shape,
+                                               elapsedMs(start), result.affected_rows(), false);
+        return result;
+    } catch (const nanodbc::database_error&) {
+        QueryStats::instance().recordStatement(caller, fingerprint ? *fingerprint : "(unprepared)", shape,
+                                               elapsedMs(start), 0, true);
+        throw;
+    }
+}
+
+long PooledConnection::fetch(nanodbc::statement& stmt, const std::function<void(const RowsetRow&)>& visit) {
+    return fetchResults(stmt, {visit});
+}
+
+long PooledConnection::fetchResults(nanodbc::statement& stmt,
+                                    const std::vector<std::function<void(const RowsetRow&)>>& visitors) {
+    const ConnectionPoolConfig& config = pool->getConfig();
+    const std::string* fingerprint = slot->statements.fingerprintOf(stmt);
+    std::string shape = std::to_string(stmt.parameters()) + " params, rowsets of " + std::to_string(config.fetchRowsetSize);
+    if (visitors.size() > 1) {
+        shape += ", " + std::to_string(visitors.size()) + " result sets";
+    }
+
+    // visit time is excluded so QueryStats reflects the database, not the caller's mapping
+    auto start = std::chrono::steady_clock::now();
+    double visitMs = 0.0;
+    std::vector<std::function<void(const RowsetRow&)>> timed;
+    timed.reserve(visitors.size());
+    for (const auto& visit : visitors) {
+        timed.push_back([&visit, &visitMs](const RowsetRow& row) {
+            auto visitStart = std::chrono::steady_clock::now();
+            visit(row);
+            visitMs += elapsedMs(visitStart);
+        });
+    }
+    try {
+        long rows = fetchResultSets(stmt, config.fetchRowsetSize, config.fetchLongColumnBytes, timed);
+        QueryStats::instance().recordStatement(caller, fingerprint ? *fingerprint : "(unprepared)", shape,
+                                               elapsedMs(start) - visitMs, rows, false);
+        return rows;
+    } catch (const nanodbc::database_error&) {
+        QueryStats::instance().recordStatement(caller, fingerprint ? *fingerprint : "(unprepared)", shape,
+                                               elapsedMs(start) - visitMs, 0, true);
+        throw;
+    }
+}
+
+void PooledConnection::setCaller(std::string caller) {
+    this->caller = std::move(caller);
+}
+
+void PooledConnection::discard() {
+    broken = true;
+}
+
+void PooledConnection::release() {
+    if (pool && slot) {
+        slot->statements.unpinAll();
+        pool->release(std::move(slot), broken);
+    }
+    pool = nullptr;
+}
+
+ConnectionPool::ConnectionPool(const ConnectionPoolConfig& config)
+    : config(config), total(0), inUse(0), waiters(0) {
+    warmUp();
+}
+
+ConnectionPool::~ConnectionPool() {
+    std::lock_guard<std::mutex> lock(mutex);
+    idle.clear();
+}
+
+void ConnectionPool::warmUp() {
+    for (std::size_t i = 0; i < config.minSize; ++i) {
+        try {
+            auto slot = openSlot();
+            std::lock_guard<std::mutex> lock(mutex);
+            idle.push_back(std::move(slot));
+            ++total;
+        } catch (const nanodbc::database_error& e) {
+            std::cerr << "Database connection pool (" << config.name << ") warm-up failed: " << e.what() << std::endl;
+            break;
+        }
+    }
+    std::cout << "Database connection pool (" << config.name << ") ready (" << idle.size() << " open, max "
+              << config.maxSize << ")" << std::endl;
+}
+
+std::unique_ptr<PooledConnectionSlot> ConnectionPool::openSlot() {
+    auto slot = std::make_unique<PooledConnectionSlot>(config.statementCacheSize, &statementCounters);
+    slot->connection = nanodbc::connection(config.connectionString);
+    slot->lastUsed = std::chrono::steady_clock::now();
+    slot->lastValidated = slot->lastUsed;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ++counters.created;
+    return slot;
+}
+
+bool ConnectionPool::validate(PooledConnectionSlot& slot) {
+    auto now = std::chrono::steady_clock::now();
+    if (now - slot.lastValidated < config.validationInterval) {
+        return slot.connection.connected();
+    }
+
+    try {
+        if (!slot.connection.connected()) {
+            return false;
+        }
+        nanodbc::execute(slot.connection, "SELECT 1");
+        slot.lastValidated = now;
+        return true;
+    } catch (const nanodbc::database_error& e) {
+        std::cerr << "Discarding stale pooled connection: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+PooledConnection ConnectionPool::acquire() {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + config.borrowTimeout;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        if (!idle.empty()) {
+            std::unique_ptr<PooledConnectionSlot> slot = std::move(idle.back());
+            idle.pop_back();
+            ++inUse;
+            lock.unlock();
+
+            if (validate(*slot)) {
+                recordWait(start);
+                return PooledConnection(this, std::move(slot));
+            }
+
+            slot.reset();
+            lock.lock();
+            --inUse;
+            --total;
+            ++counters.validationFailures;
+            continue;
+        }
+
+        if (total < config.maxSize) {
+            ++total;
+            ++inUse;
+            lock.unlock();
+
+            try {
+                auto slot = openSlot();
+                recordWait(start);
+                return PooledConnection(this, std::move(slot));
+            } catch (...) {
+                lock.lock();
+                --total;
+                --inUse;
+                available.notify_one();
+                throw;
+            }
+        }
+
+        ++waiters;
+        bool ready = available.wait_until(lock, deadline, [this] {
+            return !idle.empty() || total < config.maxSize;
+        });
+        --waiters;
+
+        if (!ready) {
+            ++counters.timeouts;
+            throw ConnectionPoolError("Timed out after " + std::to_string(config.borrowTimeout.count()) +
+                                      "ms waiting for a database connection (" + std::to_string(inUse) +
+                                      " in use, max " + std::to_string(config.maxSize) + ")");
+        }
+    }
+}
+
+void ConnectionPool::release(std::unique_ptr<PooledConnectionSlot> slot, bool broken) {
+    // Disconnecting can block on the network, so dropped connections are destroyed after the lock is released
+    std::vector<std::unique_ptr<PooledConnectionSlot>> expired;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        --inUse;
+        if (broken || !slot->connection.connected()) {
+            --total;
+            expired.push_back(std::move(slot));
+        } else {
+            slot->lastUsed = std::chrono::steady_clock::now();
+            idle.push_back(std::move(slot));
+        }
+        collectExpiredLocked(expired);
+    }
+    available.notify_one();
+}
+
+void ConnectionPool::collectExpiredLocked(std::vector<std::unique_ptr<PooledConnectionSlot>>& expired) {
+    auto now = std::chrono::steady_clock::now();
+    // idle is ordered by last use, so expired connections sit at the front
+    std::size_t count = 0;
+    while (count < idle.size() && total > config.minSize &&
+           now - idle[count]->lastUsed >= config.idleTimeout) {
+        ++count;
+        --total;
+    }
+    if (count == 0) {
+        return;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        expired.push_back(std::move(idle[i]));
+    }
+    idle.erase(idle.begin(), idle.begin() + static_cast<std::ptrdiff_t>(count));
+    counters.evicted += count;
+}
+
+std::size_t ConnectionPool::evictIdle() {
+    std::vector<std::unique_ptr<PooledConnectionSlot>> expired;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        collectExpiredLocked(expired);
+    }
+    if (!expired.empty()) {
+        available.notify_all();
+    }
+    return expired.size();
+}
+
+void ConnectionPool::recordWait(std::chrono::steady_clock::time_point start) {
+    double waitedMs = elapsedMs(start);
+    std::lock_guard<std::mutex> lock(mutex);
+    ++counters.borrows;
+    counters.totalWaitMs += waitedMs;
+    counters.maxWaitMs = std::max(counters.maxWaitMs, waitedMs);
+}
+
+ConnectionPoolStats ConnectionPool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    ConnectionPoolStats stats = counters;
+    stats.totalConnections = total;
+    stats.idleConnections = idle.size();
+    stats.inUse = inUse;
+    stats.waiters = waiters;
+    stats.statementCacheHits = statementCounters.hits.load(std::memory_order_relaxed);
+    stats.statementCacheMisses = statementCounters.misses.load(std::memory_order_relaxed);
+    stats.statementCacheEvictions = statementCounters.evictions.load(std::memory_order_relaxed);
+    return stats;
+}
+
+const ConnectionPoolConfig& ConnectionPool::getConfig() const {
+    return config;
+}
@@ -1,43 +1,46 @@
 #include "utils/dbConnection.h"
+#include "utils/queryStats.h"
 #include <iostream>
-#include <thread>
-#include <chrono>
 
-DbConnection::DbConnection() {
-    connectionString = "Driver={MariaDB};Server=localhost;Port=3306;Database=bookbite;User=root;Password=;";
-    setupConnection();
+DbConnection::DbConnection(std::string owner, DbContext& context)
+    : owner(std::move(owner)), context(context) {}
+
+PooledConnection DbConnection::getConnection(const char* method) {
+    auto start = std::chrono::steady_clock::now();
+    return labelled(context.primary().acquire(), callerName(method), start);
 }
 
-DbConnection::~DbConnection() {
-    if (connection.connected()) {
-        connection.disconnect();
-    }
+PooledConnection DbConnection::getReadConnection(const char* method) {
+    auto start = std::chrono::steady_clock::now();
+    return labelled(context.reads().acquireRead(), callerName(method), start);
 }
 
-void DbConnection::setupConnection() {
-    try {
-        connection = nanodbc::connection(connectionString);
-        std::cout << "Database connection established successfully." << std::endl;
-    } catch (const nanodbc::database_error& e) {
-        std::cerr << "Database connection error: " << e.what() << std::endl;
-    }
+PooledConnection DbConnection::labelled(PooledConnection conn, const std::string& caller,
+                                        std::chrono::steady_clock::time_point start) {
+    double waitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    QueryStats::instance().recordAcquire(caller, waitMs);
+    conn.setCaller(caller);
+    return conn;
 }
 
-nanodbc::connection DbConnection::getConnection() {
-    return createConnection();
+std::string DbConnection::callerName(const char* method) const {
+    return owner.empty() ? std::string(method) : owner + "::" + method;
 }
 
-nanodbc::connection DbConnection::createConnection() {
-    std::string connStr = "Driver={MariaDB};Server=localhost;Port=3306;Database=bookbite;User=root;Password=;";
+bool DbConnection::isConnected() {
     try {
-        nanodbc::connection conn(connStr);
-        return conn;
-    } catch (const nanodbc::database_error& e) {
-        std::cerr << "Failed to create database connection: " << e.what() << std::endl;
-        throw;
+        PooledConnection conn = context.primary().acquire();
+        return conn.get().connected();
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database connection error: " << e.what() << std::endl;
+        return false;
     }
 }
 
-bool DbConnection::isConnected() {
-    return connection.connected();
+ConnectionPoolStats DbConnection::getPoolStats() {
+    return DbContext::instance().primary().getStats();
+}
+
+ReplicaStats DbConnection::getReplicaStats() {
+    return DbContext::instance().reads().getStats();
 }
@@ -0,0 +1,30 @@
+#include "utils/dbContext.h"
+
+DbContext& DbContext::instance() {
+    static DbContext context;
+    return context;
+}
+
+ConnectionPool& DbContext::primary() {
+    std::call_once(opened, [this]() { open(); });
+    return *primaryPool;
+}
+
+ReplicaRouter& DbContext::reads() {
+    std::call_once(opened, [this]() { open(); });
+    return *readRouter;
+}
+
+std::size_t DbContext::evictIdleConnections() {
+    if (!isOpen.load()) {
+        return 0;
+    }
+    return primaryPool->evictIdle() + readRouter->evictIdle();
+}
+
+void DbContext::open() {
+    primaryPool = std::make_unique<ConnectionPool>(ConnectionPoolConfig::fromEnvironment());
+    readRouter = std::make_unique<ReplicaRouter>(*primaryPool, ConnectionPoolConfig::replicaFromEnvironment(),
+                                                 ReplicaPolicy::fromEnvironment());
+    isOpen = true;
+}
@@ -1,5 +1,6 @@
 #include "utils/emailService.h"
 #include "utils/envLoader.h"
+#include "utils/ioExecutor.h"
 #include <iostream>
 #include <random>
 #include <sstream>
@@ -36,6 +37,19 @@ std::string EmailService::generateConfirmationToken() {
     return ss.str();
 }
 
+bool EmailService::sendInBackground(std::function<bool(EmailService&)> send, const std::string& description) {
+    EmailService mailer = *this;
+    bool queued = IoExecutor::mail().execute([mailer, send = std::move(send), description]() mutable {
+        if (!send(mailer)) {
+            std::cerr << "❌ Failed to send " << description << std::endl;
+        }
+    });
+    if (!queued) {
+        std::cerr << "❌ Mail queue full, dropped " << description << std::endl;
+    }
+    return queued;
+}
+
 bool EmailService::sendReservationConfirmation(
     const std::string& toEmail,
     const std::string& customerName,
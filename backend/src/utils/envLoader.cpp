@@ -56,6 +56,19 @@ std::string EnvLoader::getEnv(const std::string& key, const std::string& default
     return defaultValue;
 }
 
+std::size_t EnvLoader::getEnvSize(const std::string& key, std::size_t defaultValue) {
+    std::string value = getEnv(key);
+    if (value.empty()) {
+        return defaultValue;
+    }
+    try {
+        return static_cast<std::size_t>(std::stoul(value));
+    } catch (const std::exception&) {
+        std::cerr << "Invalid value for " << key << ": " << value << ", using " << defaultValue << std::endl;
+        return defaultValue;
+    }
+}
+
 void EnvLoader::setEnv(const std::string& key, const std::string& value) {
     setenv(key.c_str(), value.c_str(), 1);
 }
@@ -0,0 +1,81 @@
+#include "utils/exportWriter.h"
+
+std::optional<ExportFormat> parseExportFormat(const std::string& name) {
+    if (name == "ndjson") {
+        return ExportFormat::Ndjson;
+    }
+    if (name == "csv") {
+        return ExportFormat::Csv;
+    }
+    return std::nullopt;
+}
+
+std::string exportFormatExtension(ExportFormat format) {
+    return format == ExportFormat::Csv ? "csv" : "ndjson";
+}
+
+std::string exportFormatContentType(ExportFormat format) {
+    return format == ExportFormat::Csv ? "text/csv; charset=utf-8" : "application/x-ndjson";
+}
+
+ExportWriter::ExportWriter(std::ostream& out, ExportFormat format, std::vector<std::string> columns)
+    : out(out), format(format), columns(std::move(columns)), rowCount(0) {
+    if (format == ExportFormat::Csv) {
+        for (std::size_t i = 0; i < this->columns.size(); ++i) {
+            if (i > 0) {
+                out << ',';
+            }
+            writeCsvField(this->columns[i]);
+        }
+        out << "\r\n";
+    }
+}
+
+void ExportWriter::writeRow(const nlohmann::json& row) {
+    if (format == ExportFormat::Ndjson) {
+        // Replace invalid UTF-8 instead of throwing halfway through an export
+        out << row.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace) << '\n';
+    } else {
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            if (i > 0) {
+                out << ',';
+            }
+            auto field = row.find(columns[i]);
+            writeCsvField(field != row.end() ? *field : nlohmann::json());
+        }
+        out << "\r\n";
+    }
+    ++rowCount;
+}
+
+std::size_t ExportWriter::getRowCount() const {
+    return rowCount;
+}
+
+void ExportWriter::writeCsvField(const nlohmann::json& value) {
+    if (value.is_null()) {
+        return;
+    }
+    if (!value.is_string()) {
+        out << value.dump();
+        return;
+    }
+
+    std::string text = value.get<std::string>();
+    // Spreadsheets evaluate cells starting with these as formulas
+    if (!text.empty() && (text[0] == '=' || text[0] == '+' || text[0] == '-' || text[0] == '@')) {
+        text.insert(0, "'");
+    }
+    if (text.find_first_of(",\"\r\n") == std::string::npos) {
+        out << text;
+        return;
+    }
+    out << '"';
+    for (char c : text) {
+        if (c == '"') {
+            out << '"';
+        }
+        out << c;
+    }
+    out << '"';
+}
@@ -0,0 +1,123 @@
+#include "utils/ioExecutor.h"
+#include "utils/connectionPool.h"
+#include "utils/envLoader.h"
+#include <algorithm>
+#include <iostream>
+
+IoExecutor::IoExecutor(std::string name, std::size_t threads, std::size_t queueCapacity)
+    : name(std::move(name)), queueCapacity(std::max<std::size_t>(1, queueCapacity)), stopping(false) {
+    threads = std::max<std::size_t>(1, threads);
+    counters.name = this->name;
+    counters.threads = threads;
+    counters.queueCapacity = this->queueCapacity;
+
+    workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+IoExecutor::~IoExecutor() {
+    shutdown();
+}
+
+IoExecutor& IoExecutor::database() {
+    // More DB threads than pooled connections would only queue inside the pool instead of here.
+    // Sized from the pool settings without opening the pool, which the memory backend never uses.
+    static IoExecutor executor("db",
+        EnvLoader::getEnvSize("IO_DB_THREADS", ConnectionPoolConfig::fromEnvironment().maxSize),
+        EnvLoader::getEnvSize("IO_DB_QUEUE_CAPACITY", 1024));
+    return executor;
+}
+
+IoExecutor& IoExecutor::mail() {
+    static IoExecutor executor("mail",
+        EnvLoader::getEnvSize("IO_MAIL_THREADS", 2),
+        EnvLoader::getEnvSize("IO_MAIL_QUEUE_CAPACITY", 256));
+    return executor;
+}
+
+IoExecutor& IoExecutor::hashing() {
+    // CPU-bound: half the cores, so a login burst cannot starve the HTTP and DB threads
+    static IoExecutor executor("hash",
+        EnvLoader::getEnvSize("IO_HASH_THREADS", std::max(1u, std::thread::hardware_concurrency() / 2)),
+        EnvLoader::getEnvSize("IO_HASH_QUEUE_CAPACITY", 64));
+    return executor;
+}
+
+bool IoExecutor::execute(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping || queue.size() >= queueCapacity) {
+            ++counters.rejected;
+            return false;
+        }
+        queue.push_back({std::move(task), std::chrono::steady_clock::now()});
+        ++counters.submitted;
+        counters.maxQueueDepth = std::max(counters.maxQueueDepth, queue.size());
+    }
+    ready.notify_one();
+    return true;
+}
+
+void IoExecutor::workerLoop() {
+    while (true) {
+        QueuedTask task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return; // stopping and drained
+            }
+            task = std::move(queue.front());
+            queue.pop_front();
+            ++counters.active;
+
+            double waitedMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - task.enqueuedAt).count();
+            counters.totalQueueWaitMs += waitedMs;
+            counters.maxQueueWaitMs = std::max(counters.maxQueueWaitMs, waitedMs);
+        }
+
+        bool ok = true;
+        try {
+            task.run();
+        } catch (const std::exception& e) {
+            ok = false;
+            std::cerr << "Unhandled error in " << name << " executor task: " << e.what() << std::endl;
+        } catch (...) {
+            ok = false;
+            std::cerr << "Unhandled error in " << name << " executor task" << std::endl;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        --counters.active;
+        ++counters.completed;
+        if (!ok) {
+            ++counters.failed;
+        }
+    }
+}
+
+IoExecutorStats IoExecutor::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    IoExecutorStats stats = counters;
+    stats.queueDepth = queue.size();
+    return stats;
+}
+
+void IoExecutor::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            return;
+        }
+        stopping = true;
+    }
+    ready.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
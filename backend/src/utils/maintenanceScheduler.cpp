@@ -0,0 +1,177 @@
+#include "utils/maintenanceScheduler.h"
+#include "utils/envLoader.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+MaintenanceConfig MaintenanceConfig::fromEnvironment() {
+    MaintenanceConfig config;
+    config.enabled = EnvLoader::getEnv("MAINTENANCE_ENABLED", "true") != "false";
+    config.batchSize = static_cast<int>(std::max<std::size_t>(1,
+        EnvLoader::getEnvSize("MAINTENANCE_BATCH_SIZE", static_cast<std::size_t>(config.batchSize))));
+    config.maxBatchesPerRun = static_cast<int>(std::max<std::size_t>(1,
+        EnvLoader::getEnvSize("MAINTENANCE_MAX_BATCHES_PER_RUN", static_cast<std::size_t>(config.maxBatchesPerRun))));
+    config.batchPause = std::chrono::milliseconds(
+        EnvLoader::getEnvSize("MAINTENANCE_BATCH_PAUSE_MS", static_cast<std::size_t>(config.batchPause.count())));
+    return config;
+}
+
+MaintenanceScheduler::MaintenanceScheduler(const MaintenanceConfig& config, std::chrono::milliseconds tick,
+                                           std::size_t wheelSlots)
+    : config(config), tick(std::max(tick, std::chrono::milliseconds(1))), wheel(std::max<std::size_t>(1, wheelSlots)) {}
+
+MaintenanceScheduler::~MaintenanceScheduler() {
+    stop();
+}
+
+MaintenanceScheduler& MaintenanceScheduler::instance() {
+    static MaintenanceScheduler scheduler(MaintenanceConfig::fromEnvironment());
+    return scheduler;
+}
+
+void MaintenanceScheduler::addJob(const std::string& name, std::chrono::seconds interval, BatchJob job) {
+    if (interval.count() <= 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    Job added;
+    added.run = std::move(job);
+    added.intervalTicks = std::max<std::uint64_t>(1,
+        std::chrono::duration_cast<std::chrono::milliseconds>(interval).count() / tick.count());
+    added.stats.name = name;
+    added.stats.interval = interval;
+    jobs.push_back(std::move(added));
+}
+
+void MaintenanceScheduler::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!config.enabled || worker.joinable() || jobs.empty()) {
+        return;
+    }
+    stopping = false;
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        schedule(i, 1);
+    }
+    worker = std::thread([this] { workerLoop(); });
+}
+
+void MaintenanceScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+bool MaintenanceScheduler::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return worker.joinable() && !stopping;
+}
+
+std::vector<MaintenanceJobStats> MaintenanceScheduler::getJobStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<MaintenanceJobStats> stats;
+    stats.reserve(jobs.size());
+    for (const auto& job : jobs) {
+        stats.push_back(job.stats);
+    }
+    return stats;
+}
+
+void MaintenanceScheduler::schedule(std::size_t job, std::uint64_t ticks) {
+    ticks = std::max<std::uint64_t>(1, ticks);
+    std::size_t slot = (cursor + ticks) % wheel.size();
+    wheel[slot].push_back({job, (ticks - 1) / wheel.size()});
+}
+
+void MaintenanceScheduler::workerLoop() {
+    auto nextTick = std::chrono::steady_clock::now() + tick;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        if (wake.wait_until(lock, nextTick, [this] { return stopping.load(); })) {
+            break;
+        }
+        nextTick += tick;
+        cursor = (cursor + 1) % wheel.size();
+
+        std::vector<std::size_t> due;
+        std::vector<WheelEntry>& slot = wheel[cursor];
+        for (auto it = slot.begin(); it != slot.end();) {
+            if (it->rounds == 0) {
+                due.push_back(it->job);
+                it = slot.erase(it);
+            } else {
+                --it->rounds;
+                ++it;
+            }
+        }
+        // Rescheduled from the tick they were due on, so a slow run does not push the next one back
+        for (std::size_t job : due) {
+            schedule(job, jobs[job].intervalTicks);
+        }
+
+        lock.unlock();
+        for (std::size_t job : due) {
+            if (stopping) {
+                break;
+            }
+            runJob(job);
+        }
+        lock.lock();
+    }
+}
+
+void MaintenanceScheduler::runJob(std::size_t index) {
+    // jobs is not resized once the worker runs, so the job can be used without the lock
+    Job& job = jobs[index];
+    auto start = std::chrono::steady_clock::now();
+    int rows = 0;
+    int batches = 0;
+    bool failed = false;
+    bool truncated = false;
+
+    while (!stopping) {
+        int changed = -1;
+        try {
+            changed = job.run(config.batchSize);
+        } catch (const std::exception& e) {
+            std::cerr << "Maintenance job " << job.stats.name << " failed: " << e.what() << std::endl;
+        }
+        ++batches;
+        if (changed < 0) {
+            failed = true;
+            break;
+        }
+        rows += changed;
+        if (changed < config.batchSize) {
+            break;
+        }
+        if (batches >= config.maxBatchesPerRun) {
+            truncated = true;
+            break;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait_for(lock, config.batchPause, [this] { return stopping.load(); });
+    }
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (rows > 0 || failed) {
+        std::cout << "Maintenance job " << job.stats.name << ": " << rows << " rows in " << batches << " batches, "
+                  << elapsedMs << " ms" << (failed ? " (failed)" : truncated ? " (more pending)" : "") << std::endl;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    MaintenanceJobStats& stats = job.stats;
+    ++stats.runs;
+    stats.failures += failed ? 1 : 0;
+    stats.truncatedRuns += truncated ? 1 : 0;
+    stats.batches += batches;
+    stats.rowsAffected += rows;
+    stats.lastRows = rows;
+    stats.lastDurationMs = elapsedMs;
+    stats.maxDurationMs = std::max(stats.maxDurationMs, elapsedMs);
+    stats.lastRunAt = std::time(nullptr);
+}
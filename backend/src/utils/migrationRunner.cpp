@@ -0,0 +1,251 @@
+#include "utils/migrationRunner.h"
+#include <nanodbc/nanodbc.h>
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+namespace {
+
+const char* const migrationLock = "bookbite_schema_migrations";
+const int migrationLockTimeoutSeconds = 60;
+
+struct IndexCheckQuery {
+    const char* query;
+    const char* table;
+    const char* expectedIndex;
+    const char* sql; // the DAO statement with sample values in place of its parameters
+};
+
+// Hot statements, kept in step with the DAOs they name
+const std::vector<IndexCheckQuery> indexCheckQueries = {
+    {"ReservationData::isTableAvailable", "reservations", "idx_reservations_table_slot",
+     "SELECT COUNT(*) as conflict_count FROM reservations WHERE table_id = 1 AND date = CURDATE() AND status != 'cancelled' AND "
+     "((start_time < '19:00:00' AND end_time > '19:00:00') OR "
+     " (start_time < '21:00:00' AND end_time > '21:00:00') OR "
+     " (start_time >= '19:00:00' AND end_time <= '21:00:00'))"},
+    {"ReservationData::addReservationIfAvailable", "r", "idx_reservations_table_slot",
+     "SELECT 1 FROM tables t WHERE t.id = 1 AND t.restaurant_id = 1 AND NOT EXISTS ("
+     "SELECT 1 FROM reservations r WHERE r.table_id = t.id AND r.date = CURDATE() AND r.status != 'cancelled' AND "
+     "((r.start_time < '19:00:00' AND r.end_time > '19:00:00') OR "
+     " (r.start_time < '21:00:00' AND r.end_time > '21:00:00') OR "
+     " (r.start_time >= '19:00:00' AND r.end_time <= '21:00:00')))"},
+    {"ReservationData::getAvailableTableIds", "r", "idx_reservations_table_slot",
+     "SELECT t.id FROM tables t WHERE t.restaurant_id = 1 AND t.id NOT IN ("
+     "SELECT DISTINCT r.table_id FROM reservations r "
+     "WHERE r.date = CURDATE() AND r.status != 'cancelled' AND "
+     "((r.start_time < '19:00:00' AND r.end_time > '19:00:00') OR "
+     " (r.start_time < '21:00:00' AND r.end_time > '21:00:00') OR "
+     " (r.start_time >= '19:00:00' AND r.end_time <= '21:00:00')))"},
+    {"ReservationData::getReservationsByRestaurantId", "reservations", "idx_reservations_restaurant_date",
+     "SELECT id, user_id, table_id, restaurant_id, date, start_time, end_time, guest_count, status, special_requests, "
+     "phone_number, email, total_amount, payment_status, payment_method FROM reservations "
+     "WHERE restaurant_id = 1"},
+    {"TableData::getTablesWithReservationsByRestaurantId", "reservations", "idx_reservations_table_slot",
+     "SELECT id, table_id, date, start_time, end_time, status, guest_count FROM reservations "
+     "WHERE table_id IN (1, 2, 3) AND status != 'cancelled' AND date >= CURDATE() ORDER BY date, start_time"},
+    {"TokenData::getUserIdForToken", "user_tokens", "token",
+     "SELECT user_id FROM user_tokens WHERE token = 'sample' AND is_active = TRUE AND (expires_at IS NULL OR expires_at > NOW())"},
+    {"TokenData::deleteExpiredTokens", "user_tokens", "idx_user_tokens_expires",
+     "DELETE FROM user_tokens WHERE expires_at IS NOT NULL AND expires_at < NOW() ORDER BY expires_at LIMIT 500"},
+    {"ReservationData::expirePendingReservations", "reservations", "idx_reservations_status_created",
+     "UPDATE reservations SET status = 'cancelled', confirmation_token = NULL "
+     "WHERE status = 'pending' AND payment_status != 'paid' AND created_at < NOW() - INTERVAL 1440 MINUTE "
+     "ORDER BY created_at LIMIT 500"},
+    {"UserData::clearExpiredVerificationTokens", "users", "idx_users_verification_expires",
+     "UPDATE users SET email_verification_token = NULL, email_verification_expires = NULL "
+     "WHERE email_verification_expires < NOW() AND email_verification_token IS NOT NULL "
+     "ORDER BY email_verification_expires LIMIT 500"},
+};
+
+// Splits an EXPLAIN possible_keys value ("a,b,c")
+std::set<std::string> indexNames(const std::string& list) {
+    std::set<std::string> names;
+    std::stringstream stream(list);
+    std::string name;
+    while (std::getline(stream, name, ',')) {
+        if (!name.empty()) {
+            names.insert(name);
+        }
+    }
+    return names;
+}
+
+} // namespace
+
+bool IndexCheck::indexAvailable() const {
+    return usesIndex() || indexNames(possibleIndexes).count(expectedIndex) > 0;
+}
+
+const std::vector<Migration>& MigrationRunner::migrations() {
+    static const std::vector<Migration> all = {
+        {1, "Composite indexes for slot checks, restaurant listings and token cleanup", {
+            // Booking conflict checks filter on (table_id, date, status, start_time, end_time); the index
+            // covers them, so the check never reads a row. It also serves the table_id foreign key and
+            // restaurant reservation lists by (restaurant_id, date), so the single-column keys go.
+            "ALTER TABLE reservations "
+            "ADD INDEX IF NOT EXISTS idx_reservations_table_slot (table_id, date, status, start_time, end_time), "
+            "ADD INDEX IF NOT EXISTS idx_reservations_restaurant_date (restaurant_id, date), "
+            "DROP INDEX IF EXISTS table_id, "
+            "DROP INDEX IF EXISTS restaurant_id, "
+            "ALGORITHM=INPLACE, LOCK=NONE",
+            // Token lookups already resolve to one row through UNIQUE KEY token; idx_token duplicated it and
+            // idx_active was too unselective to use. Expired-token cleanup ranges over expires_at.
+            "ALTER TABLE user_tokens "
+            "ADD INDEX IF NOT EXISTS idx_user_tokens_expires (expires_at), "
+            "DROP INDEX IF EXISTS idx_token, "
+            "DROP INDEX IF EXISTS idx_active, "
+            "ALGORITHM=INPLACE, LOCK=NONE",
+        }},
+        {2, "Widen users.password_hash for salted scrypt hashes", {
+            // scrypt$n$r$p$salt$hash is about 115 characters; the column held only SHA-256 hex.
+            // Both lengths need a two-byte length prefix under utf8mb4, so this is in place.
+            "ALTER TABLE users "
+            "MODIFY password_hash VARCHAR(255) NOT NULL, "
+            "ALGORITHM=INPLACE, LOCK=NONE",
+        }, true},
+        {3, "Indexes for the maintenance jobs' expiry scans", {
+            // Each cleanup batch reads its oldest rows in index order and stops at LIMIT, instead of
+            // scanning the table (and, for the UPDATEs, locking every row it reads)
+            "ALTER TABLE reservations "
+            "ADD INDEX IF NOT EXISTS idx_reservations_status_created (status, created_at), "
+            "ALGORITHM=INPLACE, LOCK=NONE",
+            "ALTER TABLE users "
+            "ADD INDEX IF NOT EXISTS idx_users_verification_expires (email_verification_expires), "
+            "ALGORITHM=INPLACE, LOCK=NONE",
+        }},
+    };
+    return all;
+}
+
+MigrationRunner::MigrationRunner() {}
+
+void MigrationRunner::ensureVersionTable(PooledConnection& conn) {
+    nanodbc::execute(conn.get(),
+        "CREATE TABLE IF NOT EXISTS schema_migrations ("
+        "version INT NOT NULL PRIMARY KEY, "
+        "description VARCHAR(255) NOT NULL, "
+        "applied_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP, "
+        "execution_ms INT NOT NULL DEFAULT 0"
+        ") ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci");
+}
+
+std::vector<AppliedMigration> MigrationRunner::appliedMigrations() {
+    std::vector<AppliedMigration> applied;
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        ensureVersionTable(conn);
+        nanodbc::result result = nanodbc::execute(conn.get(),
+            "SELECT version, description, applied_at, execution_ms FROM schema_migrations ORDER BY version");
+        while (result.next()) {
+            AppliedMigration migration;
+            migration.version = result.get<int>("version");
+            migration.description = result.get<nanodbc::string>("description", "");
+            migration.appliedAt = result.get<nanodbc::string>("applied_at", "");
+            migration.executionMs = result.get<int>("execution_ms", 0);
+            applied.push_back(migration);
+        }
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in appliedMigrations: " << e.what() << std::endl;
+    }
+    return applied;
+}
+
+std::vector<Migration> MigrationRunner::pendingMigrations() {
+    std::set<int> applied;
+    for (const auto& migration : appliedMigrations()) {
+        applied.insert(migration.version);
+    }
+    std::vector<Migration> pending;
+    for (const auto& migration : migrations()) {
+        if (!applied.count(migration.version)) {
+            pending.push_back(migration);
+        }
+    }
+    return pending;
+}
+
+bool MigrationRunner::migrate() {
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        ensureVersionTable(conn);
+
+        nanodbc::result lock = nanodbc::execute(conn.get(),
+            "SELECT GET_LOCK('" + std::string(migrationLock) + "', " + std::to_string(migrationLockTimeoutSeconds) + ")");
+        if (!lock.next() || lock.get<int>(0, 0) != 1) {
+            std::cerr << "Could not take the schema migration lock within " << migrationLockTimeoutSeconds << "s" << std::endl;
+            return false;
+        }
+
+        // Re-read under the lock: another server may have just applied some of them
+        std::set<int> applied;
+        nanodbc::result versions = nanodbc::execute(conn.get(), "SELECT version FROM schema_migrations");
+        while (versions.next()) {
+            applied.insert(versions.get<int>(0));
+        }
+
+        bool ok = true;
+        for (const auto& migration : migrations()) {
+            if (applied.count(migration.version)) {
+                continue;
+            }
+            std::cout << "Applying migration " << migration.version << ": " << migration.description << std::endl;
+            auto start = std::chrono::steady_clock::now();
+            try {
+                for (const auto& statement : migration.statements) {
+                    nanodbc::just_execute(conn.get(), statement);
+                }
+                int version = migration.version;
+                int executionMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+                nanodbc::statement& record = conn.prepare(
+                    "INSERT INTO schema_migrations (version, description, execution_ms) VALUES (?, ?, ?)");
+                record.bind(0, &version);
+                record.bind(1, migration.description.c_str());
+                record.bind(2, &executionMs);
+                conn.execute(record);
+                std::cout << "Applied migration " << migration.version << " in " << executionMs << " ms" << std::endl;
+            } catch (const std::runtime_error& e) {
+                std::cerr << "Database error in migration " << migration.version << ": " << e.what() << std::endl;
+                ok = false;
+                break;
+            }
+        }
+
+        nanodbc::just_execute(conn.get(), "SELECT RELEASE_LOCK('" + std::string(migrationLock) + "')");
+        return ok;
+    } catch (const std::runtime_error& e) {
+        // The advisory lock is released with the session if the connection itself failed
+        std::cerr << "Database error in migrate: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+std::vector<IndexCheck> MigrationRunner::checkIndexes() {
+    std::vector<IndexCheck> checks;
+    try {
+        PooledConnection conn = dbConnection.getConnection();
+        for (const auto& query : indexCheckQueries) {
+            IndexCheck check;
+            check.query = query.query;
+            check.table = query.table;
+            check.expectedIndex = query.expectedIndex;
+
+            nanodbc::result result = nanodbc::execute(conn.get(), std::string("EXPLAIN ") + query.sql);
+            while (result.next()) {
+                if (result.get<nanodbc::string>("table", "") != check.table) {
+                    continue;
+                }
+                check.chosenIndex = result.get<nanodbc::string>("key", "");
+                check.possibleIndexes = result.get<nanodbc::string>("possible_keys", "");
+                check.accessType = result.get<nanodbc::string>("type", "");
+                check.extra = result.get<nanodbc::string>("Extra", "");
+                break;
+            }
+            checks.push_back(check);
+        }
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Database error in checkIndexes: " << e.what() << std::endl;
+    }
+    return checks;
+}
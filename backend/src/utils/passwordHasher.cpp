@@ -0,0 +1,125 @@
+#include "utils/passwordHasher.h"
+#include "utils/envLoader.h"
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+const std::string schemePrefix = "scrypt$";
+const std::size_t saltBytes = 16;
+const std::size_t keyBytes = 32;
+
+std::string toHex(const unsigned char* data, std::size_t length) {
+    std::stringstream ss;
+    for (std::size_t i = 0; i < length; i++) {
+        ss << std::hex << std::setw(2) << std::setfill('0') << (int)data[i];
+    }
+    return ss.str();
+}
+
+bool fromHex(const std::string& hex, std::vector<unsigned char>& out) {
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    out.clear();
+    for (std::size_t i = 0; i < hex.size(); i += 2) {
+        try {
+            out.push_back(static_cast<unsigned char>(std::stoul(hex.substr(i, 2), nullptr, 16)));
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool derive(const std::string& password, const unsigned char* salt, std::size_t saltLength,
+            const PasswordHashConfig& config, unsigned char* key, std::size_t keyLength) {
+    // scrypt's working set is 128 * r * (n + p) bytes; leave headroom over OpenSSL's 32 MiB default
+    std::uint64_t maxMemory = 128 * config.r * (config.n + config.p) + (1 << 20);
+    return EVP_PBE_scrypt(password.data(), password.size(), salt, saltLength, config.n, config.r, config.p,
+                          maxMemory, key, keyLength) == 1;
+}
+
+// Legacy format: unsalted SHA-256 of the password, 64 hex digits
+std::string legacySha256(const std::string& password) {
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const unsigned char*>(password.data()), password.size(), digest);
+    return toHex(digest, sizeof(digest));
+}
+
+bool constantTimeEquals(const std::string& a, const std::string& b) {
+    return a.size() == b.size() && CRYPTO_memcmp(a.data(), b.data(), a.size()) == 0;
+}
+
+} // namespace
+
+PasswordHashConfig PasswordHashConfig::fromEnvironment() {
+    PasswordHashConfig config;
+    config.n = EnvLoader::getEnvSize("PASSWORD_SCRYPT_N", config.n);
+    config.r = EnvLoader::getEnvSize("PASSWORD_SCRYPT_R", config.r);
+    config.p = EnvLoader::getEnvSize("PASSWORD_SCRYPT_P", config.p);
+    return config;
+}
+
+PasswordHasher::PasswordHasher(const PasswordHashConfig& config) : config(config) {}
+
+const PasswordHashConfig& PasswordHasher::getConfig() const {
+    return config;
+}
+
+std::string PasswordHasher::hash(const std::string& password) const {
+    unsigned char salt[saltBytes];
+    unsigned char key[keyBytes];
+    if (RAND_bytes(salt, sizeof(salt)) != 1 || !derive(password, salt, sizeof(salt), config, key, sizeof(key))) {
+        return "";
+    }
+    return schemePrefix + std::to_string(config.n) + "$" + std::to_string(config.r) + "$" + std::to_string(config.p) +
+           "$" + toHex(salt, sizeof(salt)) + "$" + toHex(key, sizeof(key));
+}
+
+PasswordCheck PasswordHasher::verify(const std::string& password, const std::string& stored) const {
+    PasswordCheck check;
+    if (stored.compare(0, schemePrefix.size(), schemePrefix) != 0) {
+        check.valid = constantTimeEquals(legacySha256(password), stored);
+        check.needsRehash = check.valid;
+        return check;
+    }
+
+    std::vector<std::string> fields;
+    std::stringstream stream(stored.substr(schemePrefix.size()));
+    std::string field;
+    while (std::getline(stream, field, '$')) {
+        fields.push_back(field);
+    }
+    if (fields.size() != 5) {
+        return check;
+    }
+
+    PasswordHashConfig storedConfig;
+    std::vector<unsigned char> salt;
+    std::vector<unsigned char> expected;
+    try {
+        storedConfig.n = std::stoull(fields[0]);
+        storedConfig.r = std::stoull(fields[1]);
+        storedConfig.p = std::stoull(fields[2]);
+    } catch (const std::exception&) {
+        return check;
+    }
+    if (!fromHex(fields[3], salt) || !fromHex(fields[4], expected) || expected.empty()) {
+        return check;
+    }
+
+    std::vector<unsigned char> key(expected.size());
+    if (!derive(password, salt.data(), salt.size(), storedConfig, key.data(), key.size())) {
+        return check;
+    }
+    check.valid = CRYPTO_memcmp(key.data(), expected.data(), key.size()) == 0;
+    check.needsRehash = check.valid &&
+        (storedConfig.n != config.n || storedConfig.r != config.r || storedConfig.p != config.p);
+    return check;
+}
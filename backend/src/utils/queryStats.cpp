@@ -0,0 +1,188 @@
+#include "utils/queryStats.h"
+#include "utils/envLoader.h"
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <functional>
+#include <iostream>
+
+namespace {
+
+std::string utcNow() {
+    std::time_t now = std::time(nullptr);
+    std::tm utc{};
+    gmtime_r(&now, &utc);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return buffer;
+}
+
+std::size_t bucketFor(double durationMs) {
+    auto it = std::lower_bound(queryLatencyBucketsMs.begin(), queryLatencyBucketsMs.end(), durationMs);
+    return static_cast<std::size_t>(it - queryLatencyBucketsMs.begin());
+}
+
+} // namespace
+
+double StatementStats::approximatePercentileMs(double q) const {
+    if (calls == 0) {
+        return 0.0;
+    }
+    auto target = static_cast<std::uint64_t>(q * static_cast<double>(calls) + 0.999999);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < queryLatencyBucketsMs.size(); ++i) {
+        seen += histogram[i];
+        if (seen >= target) {
+            return std::min(queryLatencyBucketsMs[i], maxMs);
+        }
+    }
+    return maxMs;
+}
+
+QueryStats::QueryStats(std::chrono::milliseconds slowThreshold, std::size_t slowLogCapacity)
+    : slowThreshold(slowThreshold), slowLogCapacity(slowLogCapacity) {}
+
+QueryStats& QueryStats::instance() {
+    static QueryStats stats(std::chrono::milliseconds(EnvLoader::getEnvSize("DB_SLOW_QUERY_MS", 250)),
+                            EnvLoader::getEnvSize("DB_SLOW_QUERY_LOG_SIZE", 100));
+    return stats;
+}
+
+std::string QueryStats::fingerprint(const std::string& sql) {
+    std::string collapsed;
+    collapsed.reserve(sql.size());
+    bool pendingSpace = false;
+    for (char c : sql) {
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            pendingSpace = !collapsed.empty();
+            continue;
+        }
+        if (pendingSpace) {
+            collapsed += ' ';
+            pendingSpace = false;
+        }
+        collapsed += c;
+    }
+
+    // "(?, ?, ?)" -> "(?...)"
+    std::string result;
+    result.reserve(collapsed.size());
+    for (std::size_t i = 0; i < collapsed.size(); ++i) {
+        if (collapsed.compare(i, 4, "(?, ") == 0) {
+            std::size_t j = i + 2;
+            while (collapsed.compare(j, 3, ", ?") == 0) {
+                j += 3;
+            }
+            if (j < collapsed.size() && collapsed[j] == ')') {
+                result += "(?...)";
+                i = j;
+                continue;
+            }
+        }
+        result += collapsed[i];
+    }
+    return result;
+}
+
+QueryStats::Shard& QueryStats::shardFor(const std::string& key) {
+    return shards[std::hash<std::string>{}(key) % shardCount];
+}
+
+void QueryStats::recordStatement(const std::string& caller, const std::string& fingerprint,
+                                 const std::string& parameterShape, double durationMs, long rows, bool failed) {
+    std::string key = caller + '\n' + fingerprint;
+    Shard& shard = shardFor(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.statements.find(key);
+        if (it == shard.statements.end()) {
+            StatementStats fresh;
+            fresh.caller = caller;
+            fresh.fingerprint = fingerprint;
+            it = shard.statements.emplace(key, std::move(fresh)).first;
+        }
+        StatementStats& stats = it->second;
+        ++stats.calls;
+        if (failed) {
+            ++stats.errors;
+        }
+        stats.rows += static_cast<std::uint64_t>(std::max(0L, rows));
+        stats.totalMs += durationMs;
+        stats.maxMs = std::max(stats.maxMs, durationMs);
+        ++stats.histogram[bucketFor(durationMs)];
+    }
+
+    if (durationMs < static_cast<double>(slowThreshold.count()) || slowLogCapacity == 0) {
+        return;
+    }
+    std::cerr << "Slow query (" << durationMs << "ms, " << parameterShape << ") in " << caller << ": "
+              << fingerprint << std::endl;
+
+    SlowQueryEntry entry;
+    entry.caller = caller;
+    entry.fingerprint = fingerprint;
+    entry.parameterShape = parameterShape;
+    entry.durationMs = durationMs;
+    entry.rows = rows;
+    entry.failed = failed;
+    entry.recordedAt = utcNow();
+
+    std::lock_guard<std::mutex> lock(slowLogMutex);
+    slowLog.push_front(std::move(entry));
+    if (slowLog.size() > slowLogCapacity) {
+        slowLog.pop_back();
+    }
+}
+
+void QueryStats::recordAcquire(const std::string& caller, double waitMs) {
+    Shard& shard = shardFor(caller);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ConnectionAcquireStats& stats = shard.acquisitions[caller];
+    if (stats.caller.empty()) {
+        stats.caller = caller;
+    }
+    ++stats.borrows;
+    stats.totalMs += waitMs;
+    stats.maxMs = std::max(stats.maxMs, waitMs);
+}
+
+std::vector<StatementStats> QueryStats::getStatementStats() const {
+    std::vector<StatementStats> all;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& entry : shard.statements) {
+            all.push_back(entry.second);
+        }
+    }
+    return all;
+}
+
+std::vector<ConnectionAcquireStats> QueryStats::getAcquireStats() const {
+    std::vector<ConnectionAcquireStats> all;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& entry : shard.acquisitions) {
+            all.push_back(entry.second);
+        }
+    }
+    return all;
+}
+
+std::vector<SlowQueryEntry> QueryStats::getSlowQueries() const {
+    std::lock_guard<std::mutex> lock(slowLogMutex);
+    return std::vector<SlowQueryEntry>(slowLog.begin(), slowLog.end());
+}
+
+std::chrono::milliseconds QueryStats::getSlowThreshold() const {
+    return slowThreshold;
+}
+
+void QueryStats::reset() {
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.statements.clear();
+        shard.acquisitions.clear();
+    }
+    std::lock_guard<std::mutex> lock(slowLogMutex);
+    slowLog.clear();
+}
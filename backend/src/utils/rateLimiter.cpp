@@ -0,0 +1,178 @@
+#include "utils/rateLimiter.h"
+#include "utils/envLoader.h"
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+const std::uint64_t millitokensPerToken = 1000;
+const int tokenBits = 24;
+const std::uint64_t tokenMask = (std::uint64_t(1) << tokenBits) - 1;
+// Keeps a full bucket's millitokens within tokenBits
+const std::uint32_t maxBurst = static_cast<std::uint32_t>(tokenMask / millitokensPerToken);
+// Sweeps of a full shard are O(buckets); at most one per shard per interval
+const std::uint64_t sweepIntervalMs = 1000;
+
+std::uint64_t pack(std::uint64_t timeMs, std::uint64_t millitokens) {
+    return (timeMs << tokenBits) | millitokens;
+}
+
+} // namespace
+
+RateLimitPolicy RateLimitPolicy::perWindow(std::uint32_t requests, std::chrono::seconds window) {
+    RateLimitPolicy policy;
+    policy.burst = std::max<std::uint32_t>(1, requests);
+    policy.refillInterval = std::max(std::chrono::milliseconds(1),
+        std::chrono::duration_cast<std::chrono::milliseconds>(window) / policy.burst);
+    return policy;
+}
+
+RateLimitPolicy RateLimitPolicy::fromEnvironment(const std::string& key, const RateLimitPolicy& fallback) {
+    std::string value = EnvLoader::getEnv(key, "");
+    std::size_t slash = value.find('/');
+    if (value.empty()) {
+        return fallback;
+    }
+    try {
+        if (slash == std::string::npos) {
+            throw std::invalid_argument(value);
+        }
+        unsigned long requests = std::stoul(value.substr(0, slash));
+        unsigned long seconds = std::stoul(value.substr(slash + 1));
+        if (requests == 0 || seconds == 0) {
+            throw std::invalid_argument(value);
+        }
+        return perWindow(static_cast<std::uint32_t>(std::min<unsigned long>(requests, maxBurst)),
+                         std::chrono::seconds(seconds));
+    } catch (const std::exception&) {
+        std::cerr << "Ignoring " << key << "=" << value << "; expected <requests>/<seconds>" << std::endl;
+        return fallback;
+    }
+}
+
+RateLimitConfig RateLimitConfig::fromEnvironment() {
+    RateLimitConfig config;
+    config.enabled = EnvLoader::getEnv("RATE_LIMIT_ENABLED", "true") != "false";
+    config.trustForwardedFor = EnvLoader::getEnv("RATE_LIMIT_TRUST_FORWARDED_FOR", "false") == "true";
+    config.maxBuckets = EnvLoader::getEnvSize("RATE_LIMIT_MAX_BUCKETS", config.maxBuckets);
+    auto route = [](const std::string& name, RouteRateLimits& limits) {
+        limits.perIp = RateLimitPolicy::fromEnvironment("RATE_LIMIT_" + name + "_IP", limits.perIp);
+        limits.perAccount = RateLimitPolicy::fromEnvironment("RATE_LIMIT_" + name + "_ACCOUNT", limits.perAccount);
+    };
+    route("LOGIN", config.login);
+    route("REGISTER", config.registration);
+    route("RESEND", config.resendConfirmation);
+    return config;
+}
+
+RateLimiter::RateLimiter(std::size_t maxBuckets, std::size_t shards)
+    : start(Clock::now()),
+      maxBucketsPerShard(std::max<std::size_t>(1, maxBuckets / std::max<std::size_t>(1, shards))),
+      shards(std::max<std::size_t>(1, shards)) {}
+
+std::uint64_t RateLimiter::nowMs() const {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+}
+
+RateLimiter::Shard& RateLimiter::shardFor(const std::string& key) {
+    return shards[std::hash<std::string>{}(key) % shards.size()];
+}
+
+RateLimitDecision RateLimiter::acquire(const std::string& key, const RateLimitPolicy& policy) {
+    Shard& shard = shardFor(key);
+    std::uint64_t now = nowMs();
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.buckets.find(key);
+        if (it != shard.buckets.end()) {
+            return take(*it->second, now);
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.buckets.find(key);
+    if (it == shard.buckets.end()) {
+        if (shard.buckets.size() >= maxBucketsPerShard) {
+            sweep(shard, now);
+        }
+        if (shard.buckets.size() >= maxBucketsPerShard) {
+            // Every bucket is mid-use; failing open here still leaves the route's other key limited
+            ++untracked;
+            ++allowed;
+            return RateLimitDecision();
+        }
+        std::uint64_t capacity = std::uint64_t(std::min(std::max<std::uint32_t>(1, policy.burst), maxBurst)) * millitokensPerToken;
+        std::uint64_t refillMs = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(policy.refillInterval.count()));
+        it = shard.buckets.emplace(key, std::make_unique<Bucket>(capacity, refillMs, pack(now, capacity))).first;
+    }
+    return take(*it->second, now);
+}
+
+RateLimitDecision RateLimiter::take(Bucket& bucket, std::uint64_t now) {
+    std::uint64_t state = bucket.state.load(std::memory_order_relaxed);
+    while (true) {
+        std::uint64_t last = state >> tokenBits;
+        std::uint64_t tokens = state & tokenMask;
+        std::uint64_t elapsed = now > last ? now - last : 0;
+        std::uint64_t added = elapsed * millitokensPerToken / bucket.refillMs;
+        std::uint64_t refilled = bucket.capacity;
+        std::uint64_t stamp = now;
+        if (tokens + added < bucket.capacity) {
+            // Only the time that earned whole millitokens is used up, so slow refill rates still
+            // accumulate between close-together requests
+            refilled = tokens + added;
+            stamp = last + added * bucket.refillMs / millitokensPerToken;
+        }
+
+        if (refilled < millitokensPerToken) {
+            ++limited;
+            RateLimitDecision decision;
+            decision.allowed = false;
+            std::uint64_t waitMs = (millitokensPerToken - refilled) * bucket.refillMs / millitokensPerToken;
+            decision.retryAfter = std::chrono::seconds(std::max<std::uint64_t>(1, (waitMs + 999) / 1000));
+            return decision;
+        }
+        if (bucket.state.compare_exchange_weak(state, pack(stamp, refilled - millitokensPerToken),
+                                               std::memory_order_relaxed)) {
+            ++allowed;
+            return RateLimitDecision();
+        }
+    }
+}
+
+void RateLimiter::sweep(Shard& shard, std::uint64_t now) {
+    if (shard.lastSweepMs != 0 && now - shard.lastSweepMs < sweepIntervalMs) {
+        return;
+    }
+    shard.lastSweepMs = now;
+    for (auto it = shard.buckets.begin(); it != shard.buckets.end();) {
+        const Bucket& bucket = *it->second;
+        std::uint64_t state = bucket.state.load(std::memory_order_relaxed);
+        std::uint64_t last = state >> tokenBits;
+        std::uint64_t tokens = state & tokenMask;
+        std::uint64_t elapsed = now > last ? now - last : 0;
+        if (tokens + elapsed * millitokensPerToken / bucket.refillMs >= bucket.capacity) {
+            it = shard.buckets.erase(it);
+            ++evictions;
+        } else {
+            ++it;
+        }
+    }
+}
+
+RateLimiterStats RateLimiter::getStats() const {
+    RateLimiterStats stats;
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        stats.buckets += shard.buckets.size();
+    }
+    stats.allowed = allowed;
+    stats.limited = limited;
+    stats.evictions = evictions;
+    stats.untracked = untracked;
+    return stats;
+}
@@ -0,0 +1,120 @@
+#include "utils/replicaRouter.h"
+#include "utils/envLoader.h"
+#include <iostream>
+
+ReplicaPolicy ReplicaPolicy::fromEnvironment() {
+    ReplicaPolicy policy;
+    policy.maxLag = std::chrono::seconds(
+        EnvLoader::getEnvSize("DB_REPLICA_MAX_LAG_SECONDS", static_cast<std::size_t>(policy.maxLag.count())));
+    policy.checkInterval = std::chrono::milliseconds(
+        EnvLoader::getEnvSize("DB_REPLICA_CHECK_INTERVAL_MS", static_cast<std::size_t>(policy.checkInterval.count())));
+    return policy;
+}
+
+ReplicaRouter::ReplicaRouter(ConnectionPool& primary, const std::optional<ConnectionPoolConfig>& replicaConfig,
+                             const ReplicaPolicy& policy)
+    : primary(primary), policy(policy), healthy(false), checking(false),
+      nextCheck(std::chrono::steady_clock::now()) {
+    if (replicaConfig) {
+        replica = std::make_unique<ConnectionPool>(*replicaConfig);
+        counters.configured = true;
+    }
+}
+
+PooledConnection ReplicaRouter::acquireRead() {
+    if (!replica) {
+        return primary.acquire();
+    }
+
+    bool runCheck = false;
+    if (!shouldTryReplica(runCheck)) {
+        return fallBackToPrimary();
+    }
+
+    std::optional<PooledConnection> conn;
+    try {
+        conn.emplace(replica->acquire());
+        if (runCheck) {
+            std::optional<long> lag = measureLag(*conn);
+            bool passed = lag && *lag <= policy.maxLag.count();
+            recordCheck(passed, lag);
+            if (!passed) {
+                conn.reset();
+                return fallBackToPrimary();
+            }
+        }
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Read replica unavailable, using primary: " << e.what() << std::endl;
+        conn.reset();
+        recordCheck(false, std::nullopt);
+        return fallBackToPrimary();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ++counters.replicaReads;
+    return std::move(*conn);
+}
+
+bool ReplicaRouter::shouldTryReplica(bool& runCheck) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!checking && std::chrono::steady_clock::now() >= nextCheck) {
+        checking = true;
+        runCheck = true;
+        return true;
+    }
+    // While a check is running, readers keep the last verdict
+    return healthy;
+}
+
+void ReplicaRouter::recordCheck(bool passed, std::optional<long> lagSeconds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (passed != healthy) {
+        std::cout << "Read replica " << (passed ? "healthy" : "unhealthy")
+                  << (lagSeconds ? " (lag " + std::to_string(*lagSeconds) + "s)" : "") << std::endl;
+    }
+    healthy = passed;
+    checking = false;
+    nextCheck = std::chrono::steady_clock::now() + policy.checkInterval;
+    counters.lagSeconds = lagSeconds;
+    ++counters.checks;
+    if (!passed) {
+        ++counters.checkFailures;
+    }
+}
+
+PooledConnection ReplicaRouter::fallBackToPrimary() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++counters.primaryFallbacks;
+    }
+    return primary.acquire();
+}
+
+std::optional<long> ReplicaRouter::measureLag(PooledConnection& conn) {
+    nanodbc::result result = nanodbc::execute(conn.get(), "SHOW SLAVE STATUS");
+    if (!result.next()) {
+        return 0L;
+    }
+    // NULL while the replication threads are stopped or reconnecting
+    if (result.is_null("Seconds_Behind_Master")) {
+        return std::nullopt;
+    }
+    return static_cast<long>(result.get<int>("Seconds_Behind_Master"));
+}
+
+std::size_t ReplicaRouter::evictIdle() {
+    return replica ? replica->evictIdle() : 0;
+}
+
+ReplicaStats ReplicaRouter::getStats() const {
+    ReplicaStats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats = counters;
+        stats.healthy = replica && healthy;
+    }
+    if (replica) {
+        stats.pool = replica->getStats();
+    }
+    return stats;
+}
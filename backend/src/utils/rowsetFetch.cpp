@@ -0,0 +1,326 @@
+#include "utils/rowsetFetch.h"
+#include <sql.h>
+#include <sqlext.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+
+struct RowsetColumn {
+    SQLSMALLINT cType = SQL_C_CHAR;
+    SQLLEN width = 0;                        // bytes per row
+    std::unique_ptr<char[]> data;            // block rows * width, left uninitialised
+    std::unique_ptr<SQLLEN[]> indicators;    // length or SQL_NULL_DATA, per row
+    std::unordered_map<std::size_t, std::string> longValues; // rows of the current block that overflowed width
+};
+
+namespace {
+
+const std::size_t longValueChunkBytes = 4096;
+// Rows in the first block, so lookups and short lists do not allocate full-size buffers
+const std::size_t firstBlockRows = 8;
+
+void check(SQLRETURN rc, SQLHSTMT handle, const char* call) {
+    if (!SQL_SUCCEEDED(rc)) {
+        throw nanodbc::database_error(handle, SQL_HANDLE_STMT, std::string(call) + ": ");
+    }
+}
+
+// Puts the statement back the way nanodbc expects it: no open cursor, no bound columns, one row
+// per fetch. Runs on every exit, including a throwing visit callback.
+class BlockCursor {
+public:
+    explicit BlockCursor(SQLHSTMT handle) : handle(handle) {}
+    ~BlockCursor() {
+        SQLFreeStmt(handle, SQL_CLOSE);
+        SQLFreeStmt(handle, SQL_UNBIND);
+        SQLSetStmtAttr(handle, SQL_ATTR_ROW_STATUS_PTR, nullptr, 0);
+        SQLSetStmtAttr(handle, SQL_ATTR_ROWS_FETCHED_PTR, nullptr, 0);
+        SQLSetStmtAttr(handle, SQL_ATTR_ROW_ARRAY_SIZE, reinterpret_cast<SQLPOINTER>(static_cast<SQLULEN>(1)), 0);
+    }
+    BlockCursor(const BlockCursor&) = delete;
+    BlockCursor& operator=(const BlockCursor&) = delete;
+
+private:
+    SQLHSTMT handle;
+};
+
+void describeColumn(SQLHSTMT handle, SQLUSMALLINT column, std::size_t longColumnBytes, RowsetColumn& out) {
+    SQLSMALLINT dataType = 0;
+    SQLULEN columnSize = 0;
+    SQLSMALLINT decimalDigits = 0;
+    SQLSMALLINT nullable = 0;
+    check(SQLDescribeCol(handle, column, nullptr, 0, nullptr, &dataType, &columnSize, &decimalDigits, &nullable),
+          handle, "SQLDescribeCol");
+
+    switch (dataType) {
+    case SQL_BIT:
+    case SQL_TINYINT:
+    case SQL_SMALLINT:
+    case SQL_INTEGER:
+    case SQL_BIGINT:
+        out.cType = SQL_C_SBIGINT;
+        out.width = sizeof(std::int64_t);
+        break;
+    case SQL_REAL:
+    case SQL_FLOAT:
+    case SQL_DOUBLE:
+        out.cType = SQL_C_DOUBLE;
+        out.width = sizeof(double);
+        break;
+    default: {
+        // Dates, times and DECIMAL come back as the driver's text form. columnSize counts
+        // characters; allow four bytes each for utf8mb4.
+        std::size_t bytes = longColumnBytes;
+        if (columnSize > 0 && columnSize <= longColumnBytes / 4) {
+            bytes = columnSize * 4;
+        }
+        out.cType = SQL_C_CHAR;
+        out.width = static_cast<SQLLEN>(bytes + 1);
+        break;
+    }
+    }
+}
+
+// Full value of a text cell that did not fit its bound buffer
+std::string readLongValue(SQLHSTMT handle, SQLUSMALLINT column, std::size_t row) {
+    check(SQLSetPos(handle, static_cast<SQLULEN>(row + 1), SQL_POSITION, SQL_LOCK_NO_CHANGE), handle, "SQLSetPos");
+
+    std::string value;
+    char buffer[longValueChunkBytes];
+    for (;;) {
+        SQLLEN indicator = 0;
+        SQLRETURN rc = SQLGetData(handle, column, SQL_C_CHAR, buffer, sizeof(buffer), &indicator);
+        if (rc == SQL_NO_DATA || indicator == SQL_NULL_DATA) {
+            break;
+        }
+        check(rc, handle, "SQLGetData");
+        std::size_t chunk = (indicator == SQL_NO_TOTAL || indicator >= static_cast<SQLLEN>(sizeof(buffer)))
+                                ? sizeof(buffer) - 1
+                                : static_cast<std::size_t>(indicator);
+        value.append(buffer, chunk);
+        if (rc == SQL_SUCCESS) {
+            break;
+        }
+    }
+    return value;
+}
+
+// (Re)allocates every column for blockRows rows and binds the buffers
+void bindBlock(SQLHSTMT handle, std::vector<RowsetColumn>& columns, std::size_t blockRows,
+               std::vector<SQLUSMALLINT>& rowStatus) {
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        RowsetColumn& column = columns[i];
+        column.data.reset(new char[blockRows * static_cast<std::size_t>(column.width)]);
+        column.indicators.reset(new SQLLEN[blockRows]);
+        check(SQLBindCol(handle, static_cast<SQLUSMALLINT>(i + 1), column.cType, column.data.get(), column.width,
+                         column.indicators.get()),
+              handle, "SQLBindCol");
+    }
+    rowStatus.resize(blockRows);
+    check(SQLSetStmtAttr(handle, SQL_ATTR_ROW_ARRAY_SIZE, reinterpret_cast<SQLPOINTER>(static_cast<SQLULEN>(blockRows)), 0),
+          handle, "SQLSetStmtAttr");
+    check(SQLSetStmtAttr(handle, SQL_ATTR_ROW_STATUS_PTR, rowStatus.data(), 0), handle, "SQLSetStmtAttr");
+}
+
+bool overflowed(const RowsetColumn& column, std::size_t row) {
+    SQLLEN indicator = column.indicators[row];
+    return column.cType == SQL_C_CHAR && (indicator == SQL_NO_TOTAL || indicator >= column.width);
+}
+
+} // namespace
+
+RowsetRow::RowsetRow(const std::vector<RowsetColumn>& columns, std::size_t row) : columnData(&columns), row(row) {}
+
+short RowsetRow::columns() const {
+    return static_cast<short>(columnData->size());
+}
+
+const RowsetColumn& RowsetRow::at(short column) const {
+    if (column < 0 || static_cast<std::size_t>(column) >= columnData->size()) {
+        throw nanodbc::index_range_error();
+    }
+    return (*columnData)[column];
+}
+
+bool RowsetRow::isNull(short column) const {
+    return at(column).indicators[row] == SQL_NULL_DATA;
+}
+
+template <>
+long long RowsetRow::get<long long>(short column) const {
+    const RowsetColumn& data = at(column);
+    if (data.indicators[row] == SQL_NULL_DATA) {
+        throw nanodbc::null_access_error();
+    }
+    if (data.cType == SQL_C_SBIGINT) {
+        std::int64_t value;
+        std::memcpy(&value, data.data.get() + row * data.width, sizeof(value));
+        return value;
+    }
+    if (data.cType == SQL_C_DOUBLE) {
+        return static_cast<long long>(get<double>(column));
+    }
+    return std::stoll(get<std::string>(column));
+}
+
+template <>
+int RowsetRow::get<int>(short column) const {
+    return static_cast<int>(get<long long>(column));
+}
+
+template <>
+bool RowsetRow::get<bool>(short column) const {
+    return get<long long>(column) != 0;
+}
+
+template <>
+double RowsetRow::get<double>(short column) const {
+    const RowsetColumn& data = at(column);
+    if (data.indicators[row] == SQL_NULL_DATA) {
+        throw nanodbc::null_access_error();
+    }
+    if (data.cType == SQL_C_DOUBLE) {
+        double value;
+        std::memcpy(&value, data.data.get() + row * data.width, sizeof(value));
+        return value;
+    }
+    if (data.cType == SQL_C_SBIGINT) {
+        return static_cast<double>(get<long long>(column));
+    }
+    return std::stod(get<std::string>(column));
+}
+
+template <>
+float RowsetRow::get<float>(short column) const {
+    return static_cast<float>(get<double>(column));
+}
+
+template <>
+std::string RowsetRow::get<std::string>(short column) const {
+    const RowsetColumn& data = at(column);
+    SQLLEN indicator = data.indicators[row];
+    if (indicator == SQL_NULL_DATA) {
+        throw nanodbc::null_access_error();
+    }
+    if (data.cType == SQL_C_SBIGINT) {
+        return std::to_string(get<long long>(column));
+    }
+    if (data.cType == SQL_C_DOUBLE) {
+        std::ostringstream out;
+        out.precision(std::numeric_limits<double>::max_digits10);
+        out << get<double>(column);
+        return out.str();
+    }
+    auto longValue = data.longValues.find(row);
+    if (longValue != data.longValues.end()) {
+        return longValue->second;
+    }
+    return std::string(data.data.get() + row * data.width, static_cast<std::size_t>(indicator));
+}
+
+namespace {
+
+// Reads the current result set of an executed statement through the block cursor. Leaves the
+// columns unbound afterwards so the next result set can be described and bound from scratch.
+long readResultSet(SQLHSTMT handle, std::size_t rowsetSize, std::size_t longColumnBytes,
+                   const std::function<void(const RowsetRow&)>& visit) {
+    SQLSMALLINT columnCount = 0;
+    check(SQLNumResultCols(handle, &columnCount), handle, "SQLNumResultCols");
+    if (columnCount == 0) {
+        return 0; // an INSERT/UPDATE/DELETE in a batch produces a row count, not rows
+    }
+
+    std::vector<RowsetColumn> columns(static_cast<std::size_t>(columnCount));
+    for (SQLSMALLINT i = 0; i < columnCount; ++i) {
+        describeColumn(handle, static_cast<SQLUSMALLINT>(i + 1), longColumnBytes, columns[i]);
+    }
+
+    SQLULEN fetched = 0;
+    std::vector<SQLUSMALLINT> rowStatus;
+    check(SQLSetStmtAttr(handle, SQL_ATTR_ROW_BIND_TYPE, reinterpret_cast<SQLPOINTER>(SQL_BIND_BY_COLUMN), 0),
+          handle, "SQLSetStmtAttr");
+    check(SQLSetStmtAttr(handle, SQL_ATTR_ROWS_FETCHED_PTR, &fetched, 0), handle, "SQLSetStmtAttr");
+    std::size_t blockRows = std::min(firstBlockRows, rowsetSize);
+    bindBlock(handle, columns, blockRows, rowStatus);
+
+    long rows = 0;
+    for (;;) {
+        SQLRETURN rc = SQLFetch(handle);
+        if (rc == SQL_NO_DATA) {
+            break;
+        }
+        check(rc, handle, "SQLFetch"); // SQL_SUCCESS_WITH_INFO here is a truncated TEXT value
+
+        for (auto& column : columns) {
+            column.longValues.clear();
+        }
+        for (std::size_t row = 0; row < fetched; ++row) {
+            if (rowStatus[row] == SQL_ROW_NOROW) {
+                continue;
+            }
+            if (rowStatus[row] == SQL_ROW_ERROR) {
+                throw nanodbc::database_error(handle, SQL_HANDLE_STMT, "SQLFetch: ");
+            }
+            for (SQLSMALLINT i = 0; i < columnCount; ++i) {
+                if (overflowed(columns[i], row)) {
+                    columns[i].longValues[row] = readLongValue(handle, static_cast<SQLUSMALLINT>(i + 1), row);
+                }
+            }
+            visit(RowsetRow(columns, row));
+            ++rows;
+        }
+
+        if (fetched == blockRows && blockRows < rowsetSize) {
+            blockRows = rowsetSize;
+            bindBlock(handle, columns, blockRows, rowStatus);
+        }
+    }
+
+    // The bound buffers die with columns; nothing may point at them when the next set is fetched
+    SQLFreeStmt(handle, SQL_UNBIND);
+    SQLSetStmtAttr(handle, SQL_ATTR_ROW_STATUS_PTR, nullptr, 0);
+    SQLSetStmtAttr(handle, SQL_ATTR_ROWS_FETCHED_PTR, nullptr, 0);
+    return rows;
+}
+
+} // namespace
+
+long fetchRowsets(nanodbc::statement& stmt, std::size_t rowsetSize, std::size_t longColumnBytes,
+                  const std::function<void(const RowsetRow&)>& visit) {
+    return fetchResultSets(stmt, rowsetSize, longColumnBytes, {visit});
+}
+
+long fetchResultSets(nanodbc::statement& stmt, std::size_t rowsetSize, std::size_t longColumnBytes,
+                     const std::vector<std::function<void(const RowsetRow&)>>& visitors) {
+    SQLHSTMT handle = stmt.native_statement_handle();
+    rowsetSize = std::max<std::size_t>(1, rowsetSize);
+    longColumnBytes = std::max<std::size_t>(64, longColumnBytes);
+    BlockCursor cursor(handle);
+
+    // Array-bound writes leave a larger parameter-set size on the handle; this runs one set
+    check(SQLSetStmtAttr(handle, SQL_ATTR_PARAMSET_SIZE, reinterpret_cast<SQLPOINTER>(static_cast<SQLULEN>(1)), 0),
+          handle, "SQLSetStmtAttr");
+    SQLRETURN rc = SQLExecute(handle);
+    if (rc == SQL_NO_DATA) {
+        return 0;
+    }
+    check(rc, handle, "SQLExecute");
+
+    long rows = 0;
+    for (std::size_t i = 0; i < visitors.size(); ++i) {
+        if (i > 0) {
+            rc = SQLMoreResults(handle);
+            if (rc == SQL_NO_DATA) {
+                throw nanodbc::database_error(nullptr, 0, "SQLMoreResults: batch returned " + std::to_string(i) +
+                                                          " result sets, expected " + std::to_string(visitors.size()));
+            }
+            check(rc, handle, "SQLMoreResults");
+        }
+        rows += readResultSet(handle, rowsetSize, longColumnBytes, visitors[i]);
+    }
+    return rows;
+}
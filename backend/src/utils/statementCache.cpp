@@ -0,0 +1,73 @@
+#include "utils/statementCache.h"
+#include "utils/queryStats.h"
+#include <algorithm>
+
+StatementCache::StatementCache(std::size_t capacity, StatementCacheCounters* counters)
+    : capacity(std::max<std::size_t>(1, capacity)), counters(counters) {}
+
+nanodbc::statement& StatementCache::prepare(nanodbc::connection& conn, const std::string& sql) {
+    auto it = index.find(sql);
+    if (it != index.end()) {
+        entries.splice(entries.begin(), entries, it->second);
+        it->second->pinned = true;
+        if (counters) {
+            counters->hits.fetch_add(1, std::memory_order_relaxed);
+        }
+        return it->second->statement;
+    }
+
+    if (counters) {
+        counters->misses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    nanodbc::statement stmt(conn);
+    nanodbc::prepare(stmt, sql);
+
+    if (entries.size() >= capacity) {
+        evictOne();
+    }
+
+    entries.push_front(Entry{sql, QueryStats::fingerprint(sql), std::move(stmt)});
+    index[sql] = entries.begin();
+    byStatement[&entries.front().statement] = entries.begin();
+    return entries.front().statement;
+}
+
+void StatementCache::unpinAll() {
+    for (auto& entry : entries) {
+        entry.pinned = false;
+    }
+    while (entries.size() > capacity && evictOne()) {
+    }
+}
+
+bool StatementCache::evictOne() {
+    for (auto it = entries.end(); it != entries.begin();) {
+        --it;
+        if (!it->pinned) {
+            index.erase(it->sql);
+            byStatement.erase(&it->statement);
+            entries.erase(it);
+            if (counters) {
+                counters->evictions.fetch_add(1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::string* StatementCache::fingerprintOf(const nanodbc::statement& stmt) const {
+    auto it = byStatement.find(&stmt);
+    return it != byStatement.end() ? &it->second->fingerprint : nullptr;
+}
+
+void StatementCache::clear() {
+    index.clear();
+    byStatement.clear();
+    entries.clear();
+}
+
+std::size_t StatementCache::size() const {
+    return entries.size();
+}
@@ -0,0 +1,111 @@
+#include "utils/tokenCache.h"
+#include "utils/envLoader.h"
+#include <algorithm>
+#include <functional>
+
+TokenCacheConfig TokenCacheConfig::fromEnvironment() {
+    TokenCacheConfig config;
+    config.ttl = std::chrono::seconds(
+        EnvLoader::getEnvSize("AUTH_CACHE_TTL_SECONDS", static_cast<std::size_t>(config.ttl.count())));
+    config.maxEntries = EnvLoader::getEnvSize("AUTH_CACHE_MAX_ENTRIES", config.maxEntries);
+    return config;
+}
+
+TokenCache::TokenCache(const TokenCacheConfig& config)
+    : config(config),
+      maxEntriesPerShard(std::max<std::size_t>(1, config.maxEntries / std::max<std::size_t>(1, config.shards))),
+      shards(std::max<std::size_t>(1, config.shards)) {}
+
+bool TokenCache::isEnabled() const {
+    return config.ttl.count() > 0 && config.maxEntries > 0;
+}
+
+TokenCache::Shard& TokenCache::shardFor(const std::string& token) {
+    return shards[std::hash<std::string>{}(token) % shards.size()];
+}
+
+std::optional<AuthSession> TokenCache::find(const std::string& token) {
+    if (!isEnabled()) {
+        ++misses;
+        return std::nullopt;
+    }
+    Shard& shard = shardFor(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(token);
+    if (it == shard.entries.end()) {
+        ++misses;
+        return std::nullopt;
+    }
+    if (it->second.expiresAt <= Clock::now()) {
+        shard.entries.erase(it);
+        ++expirations;
+        ++misses;
+        return std::nullopt;
+    }
+    ++hits;
+    return it->second.session;
+}
+
+void TokenCache::put(const std::string& token, const AuthSession& session,
+                     std::optional<std::chrono::seconds> tokenExpiresIn) {
+    if (!isEnabled()) {
+        return;
+    }
+    std::chrono::seconds lifetime = tokenExpiresIn ? std::min(config.ttl, *tokenExpiresIn) : config.ttl;
+    if (lifetime.count() <= 0) {
+        return;
+    }
+    Clock::time_point now = Clock::now();
+    Shard& shard = shardFor(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.entries.count(token) && shard.entries.size() >= maxEntriesPerShard) {
+        evictLocked(shard, now);
+    }
+    shard.entries[token] = Entry{session, now + lifetime};
+}
+
+void TokenCache::evictLocked(Shard& shard, Clock::time_point now) {
+    std::size_t before = shard.entries.size();
+    for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+        it = it->second.expiresAt <= now ? shard.entries.erase(it) : std::next(it);
+    }
+    expirations += before - shard.entries.size();
+    if (shard.entries.size() >= maxEntriesPerShard) {
+        shard.entries.erase(shard.entries.begin());
+        ++evictions;
+    }
+}
+
+void TokenCache::erase(const std::string& token) {
+    Shard& shard = shardFor(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    invalidations += shard.entries.erase(token);
+}
+
+void TokenCache::eraseUser(int userId) {
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            if (it->second.session.userId == userId) {
+                it = shard.entries.erase(it);
+                ++invalidations;
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+TokenCacheStats TokenCache::getStats() const {
+    TokenCacheStats stats;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.entries += shard.entries.size();
+    }
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.expirations = expirations;
+    stats.invalidations = invalidations;
+    stats.evictions = evictions;
+    return stats;
+}
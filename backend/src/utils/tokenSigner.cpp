@@ -0,0 +1,258 @@
+#include "utils/tokenSigner.h"
+#include "utils/envLoader.h"
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+namespace {
+
+const std::string tokenPrefix = "v1.";
+const char base64UrlAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+std::int64_t unixNow() {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::int64_t unixNowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string base64UrlEncode(const std::string& data) {
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+    std::uint32_t buffer = 0;
+    int bits = 0;
+    for (unsigned char c : data) {
+        buffer = (buffer << 8) | c;
+        bits += 8;
+        while (bits >= 6) {
+            bits -= 6;
+            out.push_back(base64UrlAlphabet[(buffer >> bits) & 0x3F]);
+        }
+    }
+    if (bits > 0) {
+        out.push_back(base64UrlAlphabet[(buffer << (6 - bits)) & 0x3F]);
+    }
+    return out;
+}
+
+std::optional<std::string> base64UrlDecode(const std::string& text) {
+    std::string out;
+    out.reserve(text.size() * 3 / 4);
+    std::uint32_t buffer = 0;
+    int bits = 0;
+    for (char c : text) {
+        int value;
+        if (c >= 'A' && c <= 'Z') value = c - 'A';
+        else if (c >= 'a' && c <= 'z') value = c - 'a' + 26;
+        else if (c >= '0' && c <= '9') value = c - '0' + 52;
+        else if (c == '-') value = 62;
+        else if (c == '_') value = 63;
+        else return std::nullopt;
+        buffer = (buffer << 6) | static_cast<std::uint32_t>(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<char>((buffer >> bits) & 0xFF));
+        }
+    }
+    return out;
+}
+
+std::string hmacSha256(const std::string& secret, const std::string& data) {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    HMAC(EVP_sha256(), secret.data(), static_cast<int>(secret.size()),
+         reinterpret_cast<const unsigned char*>(data.data()), data.size(), digest, &length);
+    return std::string(reinterpret_cast<const char*>(digest), length);
+}
+
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::string part;
+    std::istringstream stream(text);
+    while (std::getline(stream, part, separator)) {
+        parts.push_back(part);
+    }
+    if (!text.empty() && text.back() == separator) {
+        parts.emplace_back();
+    }
+    return parts;
+}
+
+// userId:roleId:permissions:isAdmin:issuedAt:expiresAt:id
+std::string encodeClaims(const TokenClaims& claims) {
+    return std::to_string(claims.userId) + ":" + std::to_string(claims.roleId) + ":" +
+           std::to_string(claims.permissions.to_ulong()) + ":" + (claims.isAdmin ? "1" : "0") + ":" +
+           std::to_string(claims.issuedAt) + ":" + std::to_string(claims.expiresAt) + ":" + claims.id;
+}
+
+std::optional<TokenClaims> decodeClaims(const std::string& text) {
+    std::vector<std::string> fields = split(text, ':');
+    if (fields.size() != 7) {
+        return std::nullopt;
+    }
+    try {
+        TokenClaims claims;
+        claims.userId = std::stoi(fields[0]);
+        claims.roleId = std::stoi(fields[1]);
+        claims.permissions = PermissionSet(std::stoul(fields[2]));
+        claims.isAdmin = fields[3] == "1";
+        claims.issuedAt = std::stoll(fields[4]);
+        claims.expiresAt = std::stoll(fields[5]);
+        claims.id = fields[6];
+        return claims;
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+} // namespace
+
+TokenSignerConfig TokenSignerConfig::fromEnvironment() {
+    TokenSignerConfig config;
+    config.lifetime = std::chrono::seconds(
+        EnvLoader::getEnvSize("AUTH_SIGNED_TOKEN_TTL_SECONDS", static_cast<std::size_t>(config.lifetime.count())));
+    if (EnvLoader::getEnv("AUTH_TOKEN_FORMAT", "opaque") != "signed") {
+        return config;
+    }
+
+    for (const auto& entry : split(EnvLoader::getEnv("AUTH_SIGNING_KEYS"), ',')) {
+        std::size_t colon = entry.find(':');
+        if (colon == std::string::npos || colon == 0) {
+            std::cerr << "Ignoring AUTH_SIGNING_KEYS entry without an id" << std::endl;
+            continue;
+        }
+        SigningKey key{entry.substr(0, colon), entry.substr(colon + 1)};
+        if (key.id.find('.') != std::string::npos || key.secret.size() < minSecretLength) {
+            std::cerr << "Ignoring signing key '" << key.id << "': ids cannot contain '.' and secrets need at least "
+                      << minSecretLength << " characters" << std::endl;
+            continue;
+        }
+        config.keys.push_back(key);
+    }
+    config.enabled = !config.keys.empty();
+    if (!config.enabled) {
+        std::cerr << "AUTH_TOKEN_FORMAT=signed needs a usable key in AUTH_SIGNING_KEYS, issuing opaque tokens" << std::endl;
+    }
+    return config;
+}
+
+TokenSigner::TokenSigner(const TokenSignerConfig& config) : config(config) {}
+
+bool TokenSigner::isEnabled() const {
+    return config.enabled && !config.keys.empty();
+}
+
+std::chrono::seconds TokenSigner::getLifetime() const {
+    return config.lifetime;
+}
+
+const std::string& TokenSigner::activeKeyId() const {
+    static const std::string none;
+    return isEnabled() ? config.keys.front().id : none;
+}
+
+bool TokenSigner::isSignedToken(const std::string& token) {
+    return token.compare(0, tokenPrefix.size(), tokenPrefix) == 0;
+}
+
+std::string TokenSigner::sign(const TokenClaims& claims) const {
+    const SigningKey& key = config.keys.front();
+    std::string signedPart = tokenPrefix + key.id + "." + base64UrlEncode(encodeClaims(claims));
+    return signedPart + "." + base64UrlEncode(hmacSha256(key.secret, signedPart));
+}
+
+std::optional<TokenClaims> TokenSigner::verify(const std::string& token) const {
+    if (!isEnabled() || !isSignedToken(token)) {
+        return std::nullopt;
+    }
+    std::size_t keyEnd = token.find('.', tokenPrefix.size());
+    std::size_t claimsEnd = keyEnd == std::string::npos ? std::string::npos : token.find('.', keyEnd + 1);
+    if (claimsEnd == std::string::npos) {
+        return std::nullopt;
+    }
+
+    std::string keyId = token.substr(tokenPrefix.size(), keyEnd - tokenPrefix.size());
+    const SigningKey* key = nullptr;
+    for (const auto& candidate : config.keys) {
+        if (candidate.id == keyId) {
+            key = &candidate;
+            break;
+        }
+    }
+    if (!key) {
+        return std::nullopt;
+    }
+
+    std::string signedPart = token.substr(0, claimsEnd);
+    auto signature = base64UrlDecode(token.substr(claimsEnd + 1));
+    std::string expected = hmacSha256(key->secret, signedPart);
+    if (!signature || signature->size() != expected.size() ||
+        CRYPTO_memcmp(signature->data(), expected.data(), expected.size()) != 0) {
+        return std::nullopt;
+    }
+
+    auto encoded = base64UrlDecode(token.substr(keyEnd + 1, claimsEnd - keyEnd - 1));
+    auto claims = encoded ? decodeClaims(*encoded) : std::nullopt;
+    if (!claims || claims->expiresAt <= unixNow()) {
+        return std::nullopt;
+    }
+    return claims;
+}
+
+TokenRevocations::TokenRevocations(std::chrono::seconds tokenLifetime) : tokenLifetime(tokenLifetime.count()) {}
+
+std::uint64_t TokenRevocations::compactId(const std::string& id) {
+    // Ids are random hex; their first 64 bits identify a token well enough
+    try {
+        return std::stoull(id.substr(0, 16), nullptr, 16);
+    } catch (const std::exception&) {
+        return std::hash<std::string>{}(id);
+    }
+}
+
+void TokenRevocations::revoke(const TokenClaims& claims) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    std::int64_t now = unixNow();
+    pruneLocked(now);
+    if (claims.expiresAt > now) {
+        revokedIds[compactId(claims.id)] = claims.expiresAt;
+    }
+}
+
+void TokenRevocations::revokeUser(int userId) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    pruneLocked(unixNow());
+    userCutoffs[userId] = unixNowMillis();
+}
+
+bool TokenRevocations::isRevoked(const TokenClaims& claims) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (revokedIds.count(compactId(claims.id))) {
+        return true;
+    }
+    auto cutoff = userCutoffs.find(claims.userId);
+    return cutoff != userCutoffs.end() && claims.issuedAt <= cutoff->second;
+}
+
+std::size_t TokenRevocations::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return revokedIds.size() + userCutoffs.size();
+}
+
+void TokenRevocations::pruneLocked(std::int64_t now) {
+    if (now - lastPrune < pruneIntervalSeconds) {
+        return;
+    }
+    lastPrune = now;
+    for (auto it = revokedIds.begin(); it != revokedIds.end();) {
+        it = it->second <= now ? revokedIds.erase(it) : std::next(it);
+    }
+    for (auto it = userCutoffs.begin(); it != userCutoffs.end();) {
+        it = it->second / 1000 + tokenLifetime <= now ? userCutoffs.erase(it) : std::next(it);
+    }
+}
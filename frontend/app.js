@@ -102,6 +102,8 @@ app.use('/api', (req, res, next) => {
   const token = req.session?.token;
   const headers = {
     'Content-Type': 'application/json',
+    // The backend rate-limits per client IP; without this every browser would share ours
+    'X-Forwarded-For': req.ip,
     ...(token && { 'Authorization': `Bearer ${token}` })
   };
   
@@ -182,7 +184,7 @@ const isAdmin = (req, res, next) => {
 app.get('/restaurants/:id/reviews', async (req, res) => {
   try {
     const restaurantId = req.params.id;
-    const response = await axios.get(`${API_URL}/restaurants/${restaurantId}/reviews`);
+    const response = await axios.get(`${API_URL}/restaurants/${restaurantId}/reviews?all=true`);
     res.json(response.data);
   } catch (error) {
     console.error('Error fetching reviews:', error);
@@ -355,7 +357,7 @@ app.post('/register', async (req, res) => {
       username,
       email,
       password
-    });
+    }, { headers: { 'X-Forwarded-For': req.ip } });
     
     req.session.success = 'Registration successful! Please log in.';
     res.redirect('/login');
@@ -375,7 +377,7 @@ app.post('/login', async (req, res) => {
     const response = await apiClient.post('/auth/login', {
       username,
       password
-    });
+    }, { headers: { 'X-Forwarded-For': req.ip } });
     
     if (response.data.token) {
       req.session.token = response.data.token;
@@ -444,11 +446,10 @@ app.get('/restaurants', async (req, res) => {
 // Restaurant details page
 app.get('/restaurants/:id', async (req, res) => {
   try {
-    const restaurantResponse = await apiClient.get(`/restaurants/${req.params.id}`);
-    const tablesResponse = await apiClient.get(`/restaurants/${req.params.id}/tableswithreservations`);
+    // One round trip: restaurant, tables with reservations and the first page of reviews
+    const detailsResponse = await apiClient.get(`/restaurants/${req.params.id}/details`);
     
-    const restaurant = restaurantResponse.data;
-    const tables = tablesResponse.data;
+    const { tables, reviews, reviewStats, ...restaurant } = detailsResponse.data;
     
     res.render('pages/restaurant-detail', {
       title: `${restaurant.name} - BookBite`,
@@ -662,9 +663,12 @@ app.get('/my-reservations', isAuthenticated, async (req, res) => {
     
     console.log('Raw reservations data:', JSON.stringify(reservations, null, 2));
     
-    // Fetch restaurant details for each reservation
+    // Restaurant details are embedded by the API; only fall back to a per-reservation fetch when missing
     const reservationsWithDetails = await Promise.all(
       reservations.map(async (reservation) => {
+        if (reservation.restaurant) {
+          return reservation;
+        }
         console.log(`Fetching restaurant details for ID: ${reservation.restaurantId}`);
         try {
           const restaurantResponse = await apiClient.get(`/restaurants/${reservation.restaurantId}`);
@@ -769,8 +773,8 @@ app.get('/admin', isAdmin, async (req, res) => {
     // Get dashboard data
     const [restaurantsRes, usersRes, reservationsRes] = await Promise.all([
       authenticatedClient.get('/restaurants'),
-      authenticatedClient.get('/admin/users'),
-      authenticatedClient.get('/admin/reservations')
+      authenticatedClient.get('/admin/users?all=true'),
+      authenticatedClient.get('/admin/reservations?all=true')
     ]);
     
     console.log('✅ API calls successful');
@@ -878,7 +882,7 @@ app.get('/admin/users', isAdmin, async (req, res) => {
   try {
     const authenticatedClient = createApiClient(req.session.token);
     const [usersRes, rolesRes] = await Promise.all([
-      authenticatedClient.get('/admin/users'),
+      authenticatedClient.get('/admin/users?all=true'),
       authenticatedClient.get('/admin/roles')
     ]);
     
@@ -958,7 +958,7 @@ function removeNewTableRow(rowId) {
 // Export restaurants data
 function exportRestaurants() {
     // Fetch all restaurants data
-    fetch('/api/admin/restaurants')
+    fetch('/api/admin/restaurants?all=true')
         .then(response => response.json())
         .then(restaurants => {
             // Create CSV content
@@ -66,7 +66,7 @@ function confirmDeleteUser(userId, username) {
 // Export users to CSV
 async function exportUsers() {
     try {
-        const response = await fetch('/api/admin/users');
+        const response = await fetch('/api/admin/users?all=true');
         const result = await response.json();
         
         if (result.success && result.data) {